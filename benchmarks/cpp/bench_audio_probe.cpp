@@ -0,0 +1,79 @@
+#include <benchmark/benchmark.h>
+#include "AudioProbe.h"
+#include <sndfile.h>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+constexpr int kDirectories = 100;
+constexpr int kFilesPerDirectory = 1000;
+
+std::filesystem::path treeRoot() {
+    return std::filesystem::temp_directory_path() / "m8_bench_probe_tree";
+}
+
+// 100k minimal 16-bit WAVs, each a 44-byte header plus 256 bytes of silence
+const std::vector<std::string>& ensureFiles() {
+    static const std::vector<std::string> files = [] {
+        std::vector<unsigned char> bytes;
+        auto put = [&](const char* tag) { bytes.insert(bytes.end(), tag, tag + 4); };
+        auto putLe = [&](uint32_t value, int count) {
+            for (int i = 0; i < count; i++) bytes.push_back(static_cast<unsigned char>(value >> (8 * i)));
+        };
+        put("RIFF"); putLe(36 + 256, 4); put("WAVE");
+        put("fmt "); putLe(16, 4); putLe(1, 2); putLe(1, 2); putLe(44100, 4); putLe(88200, 4); putLe(2, 2); putLe(16, 2);
+        put("data"); putLe(256, 4);
+        bytes.resize(bytes.size() + 256, 0);
+
+        std::vector<std::string> paths;
+        std::filesystem::remove_all(treeRoot());
+        for (int d = 0; d < kDirectories; ++d) {
+            auto dir = treeRoot() / ("Pack " + std::to_string(d));
+            std::filesystem::create_directories(dir);
+            for (int f = 0; f < kFilesPerDirectory; ++f) {
+                paths.push_back((dir / ("Sample " + std::to_string(f) + ".wav")).string());
+                std::ofstream(paths.back(), std::ios::binary).write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+            }
+        }
+        return paths;
+    }();
+    return files;
+}
+}
+
+// Probes per second over the 100k-file library (items_per_second)
+static void BM_ProbeHeaders(benchmark::State& state) {
+    const auto& files = ensureFiles();
+    for (auto _ : state) {
+        size_t valid = 0;
+        for (const auto& path : files) {
+            valid += AudioProbe::probe(path).status == AudioProbe::VALID;
+        }
+        benchmark::DoNotOptimize(valid);
+    }
+    state.SetItemsProcessed(state.iterations() * files.size());
+}
+
+// What each validation check cost before: a full libsndfile open and close
+static void BM_SfOpenHeaders(benchmark::State& state) {
+    const auto& files = ensureFiles();
+    for (auto _ : state) {
+        size_t valid = 0;
+        for (const auto& path : files) {
+            SF_INFO info;
+            SNDFILE* file = sf_open(path.c_str(), SFM_READ, &info);
+            if (file) {
+                valid++;
+                sf_close(file);
+            }
+        }
+        benchmark::DoNotOptimize(valid);
+    }
+    state.SetItemsProcessed(state.iterations() * files.size());
+}
+
+BENCHMARK(BM_ProbeHeaders)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SfOpenHeaders)->Unit(benchmark::kMillisecond);
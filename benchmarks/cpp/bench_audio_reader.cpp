@@ -0,0 +1,110 @@
+#include <benchmark/benchmark.h>
+#include "AudioFileReader.h"
+#include <sndfile.h>
+#include <cmath>
+#include <fcntl.h>
+#include <filesystem>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+constexpr int kFiles = 32;
+constexpr sf_count_t kFrames = 48000 * 5;  // 5 s stereo per file
+constexpr int kChannels = 2;
+constexpr sf_count_t kBlockFrames = 16384;  // Pipeline chunk size
+
+std::filesystem::path corpusRoot() {
+    return std::filesystem::temp_directory_path() / "m8_bench_reader";
+}
+
+const std::vector<std::string>& ensureFiles(int bits) {
+    static std::vector<std::string> files[2];
+    std::vector<std::string>& paths = files[bits == 16 ? 0 : 1];
+    if (!paths.empty()) {
+        return paths;
+    }
+
+    std::filesystem::create_directories(corpusRoot());
+    std::vector<float> samples(kFrames * kChannels);
+    for (size_t i = 0; i < samples.size(); i++) {
+        samples[i] = 0.5f * static_cast<float>(std::sin(0.001 * static_cast<double>(i)));
+    }
+    for (int f = 0; f < kFiles; f++) {
+        paths.push_back((corpusRoot() / (std::to_string(bits) + "bit_" + std::to_string(f) + ".wav")).string());
+        SF_INFO info;
+        info.samplerate = 48000;
+        info.channels = kChannels;
+        info.format = SF_FORMAT_WAV | (bits == 16 ? SF_FORMAT_PCM_16 : SF_FORMAT_PCM_24);
+        SNDFILE* file = sf_open(paths.back().c_str(), SFM_WRITE, &info);
+        sf_writef_float(file, samples.data(), kFrames);
+        sf_close(file);
+    }
+    return paths;
+}
+
+// Drops the files' clean pages so the next pass reads from disk
+bool evictFromPageCache(const std::vector<std::string>& paths) {
+#ifdef POSIX_FADV_DONTNEED
+    for (const auto& path : paths) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd >= 0) {
+            ::fdatasync(fd);
+            ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+            ::close(fd);
+        }
+    }
+    return true;
+#else
+    (void)paths;
+    return false;
+#endif
+}
+}
+
+// Decode throughput of a 32-file WAV corpus in pipeline-sized blocks (bytes_per_second)
+// range(0): 0 = libsndfile buffered read(), 1 = memory-mapped AudioFileReader
+// range(1): 0 = cold page cache, 1 = warm
+// range(2): source bit depth
+static void BM_ReadCorpus(benchmark::State& state) {
+    const bool memoryMap = state.range(0) == 1;
+    const bool warm = state.range(1) == 1;
+    const int bits = static_cast<int>(state.range(2));
+    const auto& files = ensureFiles(bits);
+
+    std::string label = std::string(memoryMap ? "mmap" : "buffered") + ", " + (warm ? "warm" : "cold") + ", " +
+                        std::to_string(bits) + "-bit";
+    if (!warm && !evictFromPageCache(files)) {
+        label += " (page cache eviction unsupported)";
+    }
+    state.SetLabel(label);
+
+    std::vector<float> block(kBlockFrames * kChannels);
+    for (auto _ : state) {
+        if (!warm) {
+            state.PauseTiming();
+            evictFromPageCache(files);
+            state.ResumeTiming();
+        }
+        sf_count_t total = 0;
+        for (const auto& path : files) {
+            AudioFileReader reader;
+            if (!reader.open(path, memoryMap)) {
+                state.SkipWithError("open failed");
+                return;
+            }
+            sf_count_t count;
+            while ((count = reader.readFloat(block.data(), kBlockFrames)) > 0) {
+                total += count;
+            }
+            benchmark::DoNotOptimize(block.data());
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetBytesProcessed(state.iterations() * kFiles * kFrames * kChannels * (bits / 8));
+}
+
+BENCHMARK(BM_ReadCorpus)
+    ->ArgsProduct({{0, 1}, {0, 1}, {16, 24}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
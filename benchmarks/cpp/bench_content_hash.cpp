@@ -0,0 +1,42 @@
+#include <benchmark/benchmark.h>
+#include "ContentHash.h"
+#include <cstdint>
+#include <vector>
+
+namespace {
+std::vector<unsigned char> pcmBytes(size_t size) {
+    std::vector<unsigned char> bytes(size);
+    uint32_t state = 0x12345678u;
+    for (auto& byte : bytes) {
+        state = state * 1664525u + 1013904223u;
+        byte = static_cast<unsigned char>(state >> 24);
+    }
+    return bytes;
+}
+}
+
+// Hashing a decoded sample's data region, range(0) KiB (one-shots to long loops)
+static void BM_ContentHash(benchmark::State& state) {
+    std::vector<unsigned char> bytes = pcmBytes(static_cast<size_t>(state.range(0)) * 1024);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ContentHash::hash(bytes.data(), bytes.size()));
+    }
+    state.SetBytesProcessed(state.iterations() * bytes.size());
+}
+BENCHMARK(BM_ContentHash)->Arg(4)->Arg(256)->Arg(4096);
+
+// Baseline: byte-at-a-time FNV-1a, as ConversionIndex::hashFile uses for incremental checks
+static void BM_Fnv1a(benchmark::State& state) {
+    std::vector<unsigned char> bytes = pcmBytes(static_cast<size_t>(state.range(0)) * 1024);
+
+    for (auto _ : state) {
+        uint64_t hash = 0xCBF29CE484222325ULL;
+        for (unsigned char byte : bytes) {
+            hash = (hash ^ byte) * 0x100000001B3ULL;
+        }
+        benchmark::DoNotOptimize(hash);
+    }
+    state.SetBytesProcessed(state.iterations() * bytes.size());
+}
+BENCHMARK(BM_Fnv1a)->Arg(4)->Arg(256)->Arg(4096);
@@ -0,0 +1,42 @@
+#include <benchmark/benchmark.h>
+#include "AudioProcessor.h"
+#include <cmath>
+#include <vector>
+
+namespace {
+// One pipeline chunk of 48 kHz stereo
+constexpr size_t kFrames = 16384;
+constexpr int kChannels = 2;
+
+const std::vector<float>& testSignal() {
+    static const std::vector<float> signal = [] {
+        std::vector<float> samples(kFrames * kChannels);
+        for (size_t i = 0; i < samples.size(); i++) {
+            samples[i] = 0.5f * static_cast<float>(std::sin(0.01 * static_cast<double>(i)));
+        }
+        return samples;
+    }();
+    return signal;
+}
+}
+
+// Requantization cost per mode in samples/second (items_per_second column)
+static void BM_Requantize(benchmark::State& state) {
+    auto mode = static_cast<AudioProcessor::DitherMode>(state.range(0));
+    state.SetLabel(AudioProcessor::ditherModeName(mode));
+
+    AudioProcessor processor;
+    AudioProcessor::DitherState dither(1);
+    const auto& input = testSignal();
+    std::vector<short> output(input.size());
+    for (auto _ : state) {
+        processor.requantizeTo16Bit(input.data(), output.data(), kFrames, kChannels, mode, dither);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * input.size());
+}
+
+BENCHMARK(BM_Requantize)
+    ->Arg(static_cast<int>(AudioProcessor::DitherMode::NONE))
+    ->Arg(static_cast<int>(AudioProcessor::DitherMode::TPDF))
+    ->Arg(static_cast<int>(AudioProcessor::DitherMode::SHAPED));
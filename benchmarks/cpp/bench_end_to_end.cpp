@@ -0,0 +1,116 @@
+#include <benchmark/benchmark.h>
+#include "CorpusGenerator.h"
+#include "M8SampleFormatter.h"
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+namespace {
+constexpr int kCorpusFiles = 160;
+
+std::filesystem::path corpusRoot() {
+    return std::filesystem::temp_directory_path() / "m8_bench_end_to_end";
+}
+
+struct CorpusStats {
+    int64_t files = 0;
+    int64_t bytes = 0;
+};
+
+// A library shaped like real sample packs: mostly short one-shots with a tail of long loops,
+// WAV and AIFF at 16/24-bit and float, mono and stereo, 44.1 to 96 kHz, some padded with
+// silence, some duplicated, a few with long or non-ASCII names. Only formats every libsndfile
+// writes, so results compare across machines. Created once per process
+const CorpusStats& ensureCorpus() {
+    static CorpusStats stats;
+    if (stats.files > 0) {
+        return stats;
+    }
+
+    CorpusGenerator::Config config;
+    config.files = kCorpusFiles;
+    config.formats = {{CorpusGenerator::Format::WAV_16, 3.0}, {CorpusGenerator::Format::WAV_24, 3.0},
+                      {CorpusGenerator::Format::WAV_FLOAT, 1.0}, {CorpusGenerator::Format::AIFF_16, 1.0},
+                      {CorpusGenerator::Format::AIFF_24, 1.0}};
+    config.oneShotMaxSeconds = 0.5;
+    config.loopMaxSeconds = 4.0;
+    config.duplicateFraction = 0.08;
+
+    std::filesystem::remove_all(corpusRoot());
+    CorpusGenerator::Result result;
+    CorpusGenerator(config).generate((corpusRoot() / "source").string(), result);
+    stats.files = static_cast<int64_t>(result.files);
+    stats.bytes = static_cast<int64_t>(result.bytes);
+    return stats;
+}
+
+enum class Variant { STREAMING, PLANNED, RESAMPLE, TRIM, DEDUP };
+
+M8SampleFormatter::ProcessingOptions optionsFor(Variant variant) {
+    M8SampleFormatter::ProcessingOptions options;
+    options.incremental = false;  // Every iteration converts the whole corpus
+    switch (variant) {
+        case Variant::STREAMING:
+            break;
+        case Variant::PLANNED:
+            options.streamScan = false;
+            break;
+        case Variant::RESAMPLE:
+            options.targetSampleRate = 44100;
+            break;
+        case Variant::TRIM:
+            options.trimSilence = true;
+            break;
+        case Variant::DEDUP:
+            options.dedup = ConversionPipeline::DedupMode::SKIP;
+            break;
+    }
+    return options;
+}
+}
+
+// A full processDirectory run over the generated corpus: scan, plan, decode, convert, encode
+static void BM_ProcessDirectory(benchmark::State& state, Variant variant) {
+    const CorpusStats& corpus = ensureCorpus();
+    const M8SampleFormatter::ProcessingOptions options = optionsFor(variant);
+    const std::string source = (corpusRoot() / "source").string();
+    const std::string output = (corpusRoot() / "output").string();
+
+    Logger& logger = Logger::getInstance();
+    logger.setConsoleOutput(false);
+
+    double firstOutputSeconds = 0.0;
+    double scheduleEfficiency = 0.0;
+    double errors = 0.0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::filesystem::remove_all(output);
+        state.ResumeTiming();
+
+        M8SampleFormatter formatter;
+        if (!formatter.processDirectory(source, output, options)) {
+            state.SkipWithError("processDirectory failed");
+            break;
+        }
+
+        const M8SampleFormatter::ProcessingStats& stats = formatter.getStats();
+        firstOutputSeconds += stats.timeToFirstOutput;
+        if (stats.schedule.makespanSeconds > 0.0) {
+            scheduleEfficiency += stats.schedule.idealSeconds / stats.schedule.makespanSeconds;
+        }
+        errors += static_cast<double>(stats.errorFiles);
+    }
+
+    logger.setConsoleOutput(true);
+    state.SetItemsProcessed(state.iterations() * corpus.files);
+    state.SetBytesProcessed(state.iterations() * corpus.bytes);
+    state.counters["first_output_ms"] = benchmark::Counter(firstOutputSeconds * 1000.0, benchmark::Counter::kAvgIterations);
+    state.counters["schedule_efficiency"] = benchmark::Counter(scheduleEfficiency, benchmark::Counter::kAvgIterations);
+    state.counters["errors"] = benchmark::Counter(errors, benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK_CAPTURE(BM_ProcessDirectory, streaming, Variant::STREAMING)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(BM_ProcessDirectory, planned, Variant::PLANNED)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(BM_ProcessDirectory, resample_44k, Variant::RESAMPLE)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(BM_ProcessDirectory, trim_silence, Variant::TRIM)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(BM_ProcessDirectory, dedup_skip, Variant::DEDUP)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,89 @@
+#include <benchmark/benchmark.h>
+#include "FileScanner.h"
+#include "Logger.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+constexpr int kDirectories = 5000;
+constexpr int kFilesPerDirectory = 20;
+
+std::filesystem::path treeRoot() {
+    return std::filesystem::temp_directory_path() / "m8_bench_scan_tree";
+}
+
+// 100k small files in 5k directories: 50 packs x 10 categories x 10 folders
+void ensureTree() {
+    static bool created = false;
+    if (created) return;
+
+    std::filesystem::remove_all(treeRoot());
+    for (int d = 0; d < kDirectories; ++d) {
+        auto dir = treeRoot() / ("Pack " + std::to_string(d / 100)) / ("Category " + std::to_string(d / 10 % 10)) /
+                   ("Folder " + std::to_string(d % 10));
+        std::filesystem::create_directories(dir);
+        for (int f = 0; f < kFilesPerDirectory; ++f) {
+            // One in ten is not audio so the extension filter has something to reject
+            std::string name = "Sample " + std::to_string(f) + (f % 10 == 9 ? ".txt" : ".wav");
+            std::ofstream(dir / name) << "RIFF";
+        }
+    }
+    created = true;
+}
+
+void scanThreadCounts(benchmark::internal::Benchmark* bench) {
+    bench->Arg(1)->Arg(4);
+    int maxThreads = static_cast<int>(std::thread::hardware_concurrency());
+    if (maxThreads > 4) {
+        bench->Arg(maxThreads);
+    }
+}
+
+// The single recursive_directory_iterator walk with three stats per file that FileScanner replaced
+size_t legacyScan(const std::string& directory) {
+    size_t found = 0;
+    std::filesystem::recursive_directory_iterator iter(directory, std::filesystem::directory_options::skip_permission_denied);
+    for (const auto& entry : iter) {
+        if (!entry.is_regular_file()) continue;
+        std::string filepath = entry.path().string();
+        if (!std::filesystem::exists(filepath) || !std::filesystem::is_regular_file(filepath)) continue;
+        std::string ext = filepath.substr(filepath.find_last_of('.'));
+        std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+        if (ext != ".wav") continue;
+        benchmark::DoNotOptimize(std::filesystem::file_size(filepath));
+        found++;
+    }
+    return found;
+}
+}
+
+static void BM_ScanTreeLegacy(benchmark::State& state) {
+    ensureTree();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(legacyScan(treeRoot().string()));
+    }
+    state.SetItemsProcessed(state.iterations() * kDirectories * kFilesPerDirectory);
+}
+
+static void BM_ScanTreeParallel(benchmark::State& state) {
+    ensureTree();
+    Logger::getInstance().setConsoleOutput(false);
+    FileScanner scanner;
+    scanner.setScanThreads(static_cast<size_t>(state.range(0)));
+
+    size_t found = 0;
+    for (auto _ : state) {
+        found = scanner.scanDirectory(treeRoot().string()).size();
+    }
+
+    Logger::getInstance().setConsoleOutput(true);
+    state.counters["files_found"] = static_cast<double>(found);
+    state.SetItemsProcessed(state.iterations() * kDirectories * kFilesPerDirectory);
+}
+
+BENCHMARK(BM_ScanTreeLegacy)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_ScanTreeParallel)->Apply(scanThreadCounts)->Unit(benchmark::kMillisecond)->UseRealTime();
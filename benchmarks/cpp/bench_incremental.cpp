@@ -0,0 +1,66 @@
+#include <benchmark/benchmark.h>
+#include "M8SampleFormatter.h"
+#include <sndfile.h>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace {
+constexpr int kCorpusFiles = 1000;
+
+std::filesystem::path corpusRoot() {
+    return std::filesystem::temp_directory_path() / "m8_bench_incremental";
+}
+
+// Small 24-bit one-shots spread over a few packs, created once per process
+void ensureCorpus() {
+    static bool created = false;
+    if (created) return;
+
+    std::filesystem::remove_all(corpusRoot());
+    std::vector<float> samples(4410, 0.25f);
+    for (int i = 0; i < kCorpusFiles; ++i) {
+        auto dir = corpusRoot() / "source" / ("Pack " + std::to_string(i % 10)) / "Drums";
+        std::filesystem::create_directories(dir);
+        std::string path = (dir / ("Kick " + std::to_string(i) + ".wav")).string();
+
+        SF_INFO info;
+        info.samplerate = 44100;
+        info.channels = 1;
+        info.format = SF_FORMAT_WAV | SF_FORMAT_PCM_24;
+        SNDFILE* file = sf_open(path.c_str(), SFM_WRITE, &info);
+        sf_writef_float(file, samples.data(), static_cast<sf_count_t>(samples.size()));
+        sf_close(file);
+    }
+    created = true;
+}
+
+bool runFormatter(bool incremental) {
+    M8SampleFormatter::ProcessingOptions options;
+    options.incremental = incremental;
+    M8SampleFormatter formatter;
+    return formatter.processDirectory((corpusRoot() / "source").string(), (corpusRoot() / "output").string(), options);
+}
+}
+
+// Re-running over a library where nothing changed: arg 1 consults the index, arg 0 converts everything
+static void BM_NoChangeRerun(benchmark::State& state) {
+    bool incremental = state.range(0) != 0;
+    ensureCorpus();
+
+    Logger& logger = Logger::getInstance();
+    logger.setConsoleOutput(false);
+    runFormatter(true);  // Populate outputs and the index
+
+    for (auto _ : state) {
+        if (!runFormatter(incremental)) {
+            state.SkipWithError("processDirectory failed");
+            break;
+        }
+    }
+
+    logger.setConsoleOutput(true);
+    state.SetItemsProcessed(state.iterations() * kCorpusFiles);
+}
+
+BENCHMARK(BM_NoChangeRerun)->Arg(1)->Arg(0)->Unit(benchmark::kMillisecond)->UseRealTime();
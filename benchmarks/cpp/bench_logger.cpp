@@ -0,0 +1,70 @@
+#include <benchmark/benchmark.h>
+#include "Logger.h"
+#include <algorithm>
+#include <filesystem>
+#include <string>
+#include <thread>
+
+namespace {
+// Same shape as the per-file "Progress:" line processDirectory emits
+const std::string kMessage = "Progress: 42% (21000/50000 files)";
+
+void configureLogger(benchmark::State& state, bool async) {
+    if (state.thread_index() != 0) return;
+
+    Logger& logger = Logger::getInstance();
+    logger.setConsoleOutput(false);
+    logger.setLogFile((std::filesystem::temp_directory_path() / "m8_bench_logger.log").string());
+    if (async) {
+        logger.enableAsync(Logger::DEFAULT_ASYNC_CAPACITY, static_cast<Logger::OverflowPolicy>(state.range(0)));
+    } else {
+        logger.disableAsync();
+    }
+}
+
+void resetLogger(benchmark::State& state) {
+    if (state.thread_index() != 0) return;
+
+    Logger& logger = Logger::getInstance();
+    logger.flush();
+    state.counters["dropped"] = static_cast<double>(logger.getDroppedCount());
+    logger.disableAsync();
+    logger.setLogFile("");
+    logger.setConsoleOutput(true);
+    std::filesystem::remove(std::filesystem::temp_directory_path() / "m8_bench_logger.log");
+}
+
+int maxThreads() {
+    return static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+}
+}
+
+// Producer-side cost of one log call with the mutex-and-flush path
+static void BM_LoggerSync(benchmark::State& state) {
+    configureLogger(state, false);
+    Logger& logger = Logger::getInstance();
+
+    for (auto _ : state) {
+        logger.info(kMessage);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    resetLogger(state);
+}
+
+// Producer-side cost of one log call when a sink thread does the formatting and I/O
+static void BM_LoggerAsync(benchmark::State& state) {
+    configureLogger(state, true);
+    Logger& logger = Logger::getInstance();
+
+    for (auto _ : state) {
+        logger.info(kMessage);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    resetLogger(state);
+}
+
+BENCHMARK(BM_LoggerSync)->ThreadRange(1, maxThreads())->UseRealTime();
+BENCHMARK(BM_LoggerAsync)->Arg(Logger::BLOCK)->ThreadRange(1, maxThreads())->UseRealTime();
+BENCHMARK(BM_LoggerAsync)->Arg(Logger::DROP)->ThreadRange(1, maxThreads())->UseRealTime();
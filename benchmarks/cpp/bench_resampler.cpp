@@ -0,0 +1,42 @@
+#include <benchmark/benchmark.h>
+#include "Resampler.h"
+#include <cmath>
+#include <vector>
+
+namespace {
+// One pipeline chunk of stereo input
+constexpr size_t kFrames = 16384;
+constexpr int kChannels = 2;
+constexpr int kTargetRate = 44100;
+
+const std::vector<float>& testSignal() {
+    static const std::vector<float> signal = [] {
+        std::vector<float> samples(kFrames * kChannels);
+        for (size_t i = 0; i < samples.size(); i++) {
+            samples[i] = 0.5f * static_cast<float>(std::sin(0.01 * static_cast<double>(i)));
+        }
+        return samples;
+    }();
+    return signal;
+}
+}
+
+// Streaming throughput per source rate, in input frames/second (items_per_second)
+static void BM_Resample(benchmark::State& state) {
+    int inputRate = static_cast<int>(state.range(0));
+    Resampler resampler(inputRate, kTargetRate, kChannels);
+    state.SetLabel(std::to_string(inputRate) + " -> " + std::to_string(kTargetRate) + ", " +
+                   std::to_string(resampler.getTapsPerPhase()) + " taps");
+
+    const auto& input = testSignal();
+    std::vector<float> output;
+    output.reserve(input.size());
+    for (auto _ : state) {
+        output.clear();
+        resampler.process(input.data(), kFrames, output);
+        benchmark::DoNotOptimize(output.data());
+    }
+    state.SetItemsProcessed(state.iterations() * kFrames);
+}
+
+BENCHMARK(BM_Resample)->Arg(48000)->Arg(88200)->Arg(96000)->Arg(176400)->Arg(192000);
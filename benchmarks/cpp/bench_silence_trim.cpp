@@ -0,0 +1,73 @@
+#include <benchmark/benchmark.h>
+#include "AudioProcessor.h"
+#include "SilenceTrimmer.h"
+#include <cmath>
+#include <vector>
+
+namespace {
+constexpr int kRate = 44100;
+constexpr int kChannels = 2;
+
+// Stereo one-shot: range(0) ms of dead air at each end around 1 s of decaying tone
+std::vector<float> oneShot(size_t padMs) {
+    size_t pad = kRate * padMs / 1000;
+    size_t body = kRate;
+    std::vector<float> samples((pad * 2 + body) * kChannels, 0.0f);
+    for (size_t i = 0; i < body; i++) {
+        float value = std::exp(-4.0f * static_cast<float>(i) / kRate) * std::sin(0.06f * static_cast<float>(i));
+        samples[(pad + i) * kChannels] = value;
+        samples[(pad + i) * kChannels + 1] = value;
+    }
+    return samples;
+}
+}
+
+// Finding both edges: block-peak scans from each end stop at the first loud block
+static void BM_FindAudibleRange(benchmark::State& state) {
+    std::vector<float> samples = oneShot(static_cast<size_t>(state.range(0)));
+    const size_t frames = samples.size() / kChannels;
+    const float threshold = SilenceTrimmer<float>::dbToLinear(-60.0f);
+
+    for (auto _ : state) {
+        size_t first = SilenceTrimmer<float>::firstAudibleFrame(samples.data(), frames, kChannels, threshold);
+        size_t end = SilenceTrimmer<float>::audibleEnd(samples.data(), frames, kChannels, threshold);
+        benchmark::DoNotOptimize(first);
+        benchmark::DoNotOptimize(end);
+    }
+    state.SetItemsProcessed(state.iterations() * frames);
+}
+
+// Baseline: the whole-buffer RMS pass behind AudioProcessor::isSilent
+static void BM_IsSilentFullPass(benchmark::State& state) {
+    std::vector<float> samples = oneShot(static_cast<size_t>(state.range(0)));
+    AudioProcessor processor;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(processor.isSilent(samples));
+    }
+    state.SetItemsProcessed(state.iterations() * (samples.size() / kChannels));
+}
+
+// Streaming trim as the pipeline runs it, in 16384-frame chunks
+static void BM_TrimStreaming(benchmark::State& state) {
+    std::vector<float> samples = oneShot(static_cast<size_t>(state.range(0)));
+    const size_t frames = samples.size() / kChannels;
+    const size_t block = 16384;
+    std::vector<float> output;
+    output.reserve(samples.size());
+
+    for (auto _ : state) {
+        SilenceTrimmer<float> trimmer(kChannels, -60.0f, 441);
+        output.clear();
+        for (size_t start = 0; start < frames; start += block) {
+            trimmer.process(samples.data() + start * kChannels, std::min(block, frames - start), output);
+        }
+        trimmer.flush(output);
+        benchmark::DoNotOptimize(output.data());
+    }
+    state.SetItemsProcessed(state.iterations() * frames);
+}
+
+BENCHMARK(BM_FindAudibleRange)->Arg(0)->Arg(300)->Arg(1000);
+BENCHMARK(BM_IsSilentFullPass)->Arg(0)->Arg(300)->Arg(1000);
+BENCHMARK(BM_TrimStreaming)->Arg(0)->Arg(300)->Arg(1000);
@@ -0,0 +1,131 @@
+#include <benchmark/benchmark.h>
+#include "SimdKernels.h"
+#include <random>
+#include <vector>
+
+namespace {
+// One second of 48 kHz stereo, about what a pipeline chunk holds
+constexpr size_t kSamples = 96000;
+
+const std::vector<float>& testSignal() {
+    static const std::vector<float> signal = [] {
+        std::vector<float> samples(kSamples);
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+        for (float& sample : samples) {
+            sample = dist(rng);
+        }
+        return samples;
+    }();
+    return signal;
+}
+
+void allIsas(benchmark::internal::Benchmark* bench) {
+    for (SimdKernels::Isa isa : SimdKernels::availableIsas()) {
+        bench->Arg(isa);
+    }
+}
+
+const SimdKernels& kernelsFor(benchmark::State& state) {
+    const SimdKernels* kernels = SimdKernels::forIsa(static_cast<SimdKernels::Isa>(state.range(0)));
+    state.SetLabel(kernels->name);
+    return *kernels;
+}
+}
+
+// Throughput is reported as input bytes per second (GB/s in the bytes_per_second column)
+
+static void BM_DownmixStereo(benchmark::State& state) {
+    const SimdKernels& kernels = kernelsFor(state);
+    const auto& input = testSignal();
+    std::vector<float> output(kSamples / 2);
+    for (auto _ : state) {
+        kernels.downmixStereo(input.data(), output.data(), kSamples / 2);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * kSamples * sizeof(float));
+}
+
+static void BM_Peak(benchmark::State& state) {
+    const SimdKernels& kernels = kernelsFor(state);
+    const auto& input = testSignal();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(kernels.peak(input.data(), kSamples));
+    }
+    state.SetBytesProcessed(state.iterations() * kSamples * sizeof(float));
+}
+
+static void BM_SumSquares(benchmark::State& state) {
+    const SimdKernels& kernels = kernelsFor(state);
+    const auto& input = testSignal();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(kernels.sumSquares(input.data(), kSamples));
+    }
+    state.SetBytesProcessed(state.iterations() * kSamples * sizeof(float));
+}
+
+static void BM_ApplyGain(benchmark::State& state) {
+    const SimdKernels& kernels = kernelsFor(state);
+    const auto& input = testSignal();
+    std::vector<float> output(kSamples);
+    for (auto _ : state) {
+        kernels.applyGain(input.data(), output.data(), kSamples, 0.5f);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * kSamples * sizeof(float));
+}
+
+static void BM_Clamp(benchmark::State& state) {
+    const SimdKernels& kernels = kernelsFor(state);
+    const auto& input = testSignal();
+    std::vector<float> output(kSamples);
+    for (auto _ : state) {
+        kernels.clamp(input.data(), output.data(), kSamples, -0.5f, 0.5f);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * kSamples * sizeof(float));
+}
+
+static void BM_FloatToInt16(benchmark::State& state) {
+    const SimdKernels& kernels = kernelsFor(state);
+    const auto& input = testSignal();
+    std::vector<int16_t> output(kSamples);
+    for (auto _ : state) {
+        kernels.floatToInt16(input.data(), output.data(), kSamples);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * kSamples * sizeof(float));
+}
+
+static void BM_FloatToInt24(benchmark::State& state) {
+    const SimdKernels& kernels = kernelsFor(state);
+    const auto& input = testSignal();
+    std::vector<int32_t> output(kSamples);
+    for (auto _ : state) {
+        kernels.floatToInt24(input.data(), output.data(), kSamples);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * kSamples * sizeof(float));
+}
+
+static void BM_FloatToInt16Tpdf(benchmark::State& state) {
+    const SimdKernels& kernels = kernelsFor(state);
+    const auto& input = testSignal();
+    std::vector<int16_t> output(kSamples);
+    uint32_t rng[SimdKernels::DITHER_LANES] = {1, 2, 3, 4, 5, 6, 7, 8};
+    for (auto _ : state) {
+        kernels.floatToInt16Tpdf(input.data(), output.data(), kSamples, rng);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * kSamples * sizeof(float));
+    state.SetItemsProcessed(state.iterations() * kSamples);
+}
+
+BENCHMARK(BM_DownmixStereo)->Apply(allIsas);
+BENCHMARK(BM_Peak)->Apply(allIsas);
+BENCHMARK(BM_SumSquares)->Apply(allIsas);
+BENCHMARK(BM_ApplyGain)->Apply(allIsas);
+BENCHMARK(BM_Clamp)->Apply(allIsas);
+BENCHMARK(BM_FloatToInt16)->Apply(allIsas);
+BENCHMARK(BM_FloatToInt24)->Apply(allIsas);
+BENCHMARK(BM_FloatToInt16Tpdf)->Apply(allIsas);
@@ -0,0 +1,34 @@
+#include <benchmark/benchmark.h>
+#include "StageProfiler.h"
+#include <cstdint>
+
+// Cost of one sample on a worker's own histograms; the pipeline records a handful per file
+static void BM_StageProfilerRecord(benchmark::State& state) {
+    StageProfiler& profiler = StageProfiler::getInstance();
+    profiler.reset();
+    profiler.setEnabled(true);
+
+    uint64_t nanos = 1000;
+    for (auto _ : state) {
+        profiler.record(StageProfiler::DECODE, nanos);
+        nanos = nanos * 13 % 1000003;  // Spread over many buckets
+    }
+    profiler.setEnabled(false);
+    profiler.reset();
+}
+BENCHMARK(BM_StageProfilerRecord)->ThreadRange(1, 4);
+
+// A scoped timer per chunk, with profiling on (two clock reads) and off (none)
+static void BM_StageProfilerTimer(benchmark::State& state) {
+    StageProfiler& profiler = StageProfiler::getInstance();
+    profiler.setEnabled(state.range(0) != 0);
+
+    uint64_t total = 0;
+    for (auto _ : state) {
+        StageProfiler::Timer timer(total);
+        benchmark::ClobberMemory();
+    }
+    benchmark::DoNotOptimize(total);
+    profiler.setEnabled(false);
+}
+BENCHMARK(BM_StageProfilerTimer)->Arg(0)->Arg(1);
@@ -0,0 +1,184 @@
+#include <benchmark/benchmark.h>
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// The single-mutex pool that ThreadPool replaced, kept as the baseline
+class LegacyThreadPool {
+public:
+    explicit LegacyThreadPool(size_t numThreads) : m_stop(false), m_activeThreads(0) {
+        for (size_t i = 0; i < numThreads; ++i) {
+            m_workers.emplace_back([this] { worker(); });
+        }
+    }
+
+    ~LegacyThreadPool() {
+        {
+            std::unique_lock<std::mutex> lock(m_queueMutex);
+            m_stop = true;
+        }
+        m_condition.notify_all();
+        for (std::thread& worker : m_workers) {
+            worker.join();
+        }
+    }
+
+    template<class F>
+    std::future<void> enqueue(F&& f) {
+        auto task = std::make_shared<std::packaged_task<void()>>(std::forward<F>(f));
+        std::future<void> result = task->get_future();
+        {
+            std::unique_lock<std::mutex> lock(m_queueMutex);
+            m_tasks.emplace([task]() { (*task)(); });
+        }
+        m_condition.notify_one();
+        return result;
+    }
+
+    void waitForAll() {
+        std::unique_lock<std::mutex> lock(m_queueMutex);
+        m_condition.wait(lock, [this] { return m_tasks.empty() && m_activeThreads == 0; });
+    }
+
+private:
+    std::vector<std::thread> m_workers;
+    std::queue<std::function<void()>> m_tasks;
+    std::mutex m_queueMutex;
+    std::condition_variable m_condition;
+    std::atomic<bool> m_stop;
+    std::atomic<size_t> m_activeThreads;
+
+    void worker() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(m_queueMutex);
+                m_condition.wait(lock, [this] { return m_stop || !m_tasks.empty(); });
+                if (m_stop && m_tasks.empty()) {
+                    return;
+                }
+                task = std::move(m_tasks.front());
+                m_tasks.pop();
+                m_activeThreads++;
+            }
+            task();
+            {
+                std::lock_guard<std::mutex> lock(m_queueMutex);
+                m_activeThreads--;
+            }
+            m_condition.notify_all();
+        }
+    }
+};
+
+namespace {
+constexpr int kTasksPerIteration = 10000;
+
+// Stand-in for a small one-shot sample: a few hundred nanoseconds of work
+void smallTask() {
+    volatile float accumulator = 0.0f;
+    for (int i = 0; i < 64; ++i) {
+        accumulator = accumulator + static_cast<float>(i) * 0.5f;
+    }
+}
+
+void threadCounts(benchmark::internal::Benchmark* bench) {
+    int maxThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        bench->Arg(threads);
+    }
+    if ((maxThreads & (maxThreads - 1)) != 0) {
+        bench->Arg(maxThreads);
+    }
+}
+}
+
+// Tasks per second for a burst of small independent tasks
+template<class Pool>
+static void BM_PoolThroughput(benchmark::State& state) {
+    Pool pool(static_cast<size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        for (int i = 0; i < kTasksPerIteration; ++i) {
+            pool.enqueue(smallTask);
+        }
+        pool.waitForAll();
+    }
+
+    state.SetItemsProcessed(state.iterations() * kTasksPerIteration);
+}
+
+// Per-call cost on the submitting thread while workers are draining
+template<class Pool>
+static void BM_PoolEnqueueLatency(benchmark::State& state) {
+    Pool pool(static_cast<size_t>(state.range(0)));
+    std::vector<double> latencies;
+    latencies.reserve(static_cast<size_t>(kTasksPerIteration));
+
+    for (auto _ : state) {
+        for (int i = 0; i < kTasksPerIteration; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            pool.enqueue(smallTask);
+            auto end = std::chrono::steady_clock::now();
+            latencies.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+        }
+        pool.waitForAll();
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    state.counters["p50_enqueue_ns"] = latencies[latencies.size() / 2];
+    state.counters["p99_enqueue_ns"] = latencies[latencies.size() * 99 / 100];
+    state.SetItemsProcessed(state.iterations() * kTasksPerIteration);
+}
+
+// A library batch: 200 one-shots of 0.1-1 ms and six 20 ms ambient loops found
+// last. FIFO order leaves the loops running alone at the end; LPT starts them first.
+// ideal_ms is max(total work / threads, longest task), the best any order can do
+static void BM_PoolBatchMakespan(benchmark::State& state) {
+    const size_t threads = static_cast<size_t>(state.range(0));
+    const bool longestFirst = state.range(1) != 0;
+
+    std::vector<double> costsMs;
+    for (int i = 0; i < 200; ++i) {
+        costsMs.push_back(0.1 + (i * 37 % 10) * 0.1);
+    }
+    for (int i = 0; i < 6; ++i) {
+        costsMs.push_back(20.0);
+    }
+    double totalMs = 0.0;
+    for (double cost : costsMs) {
+        totalMs += cost;
+    }
+
+    ThreadPool pool(threads);
+    // Sleeping rather than spinning measures the schedule, not how many cores the host has
+    auto work = [](double ms) {
+        std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(ms));
+    };
+
+    for (auto _ : state) {
+        for (double cost : costsMs) {
+            if (longestFirst) {
+                pool.enqueuePrioritized(cost, work, cost);
+            } else {
+                pool.enqueue(work, cost);
+            }
+        }
+        pool.waitForAll();
+    }
+
+    state.counters["ideal_ms"] = std::max(totalMs / threads, 20.0);
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(costsMs.size()));
+}
+
+BENCHMARK_TEMPLATE(BM_PoolThroughput, ThreadPool)->Apply(threadCounts)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_PoolThroughput, LegacyThreadPool)->Apply(threadCounts)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_PoolEnqueueLatency, ThreadPool)->Apply(threadCounts)->UseRealTime()->Iterations(20);
+BENCHMARK_TEMPLATE(BM_PoolEnqueueLatency, LegacyThreadPool)->Apply(threadCounts)->UseRealTime()->Iterations(20);
+BENCHMARK(BM_PoolBatchMakespan)->ArgNames({"threads", "lpt"})->ArgsProduct({{4}, {0, 1}})
+    ->UseRealTime()->Unit(benchmark::kMillisecond);
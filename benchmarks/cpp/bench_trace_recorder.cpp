@@ -0,0 +1,25 @@
+#include <benchmark/benchmark.h>
+#include "TraceRecorder.h"
+#include <string>
+
+// One span per pipeline chunk, with tracing off (a flag check) and on (two clock reads and an append)
+static void BM_TraceSpan(benchmark::State& state) {
+    TraceRecorder& tracer = TraceRecorder::getInstance();
+    tracer.reset();
+    tracer.setEnabled(state.range(0) != 0);
+    const std::string file = "Drums/Kicks/Kick 01.wav";
+
+    size_t spans = 0;
+    for (auto _ : state) {
+        TraceRecorder::Span span("transform", "pipeline", file, 65536);
+        // Restart before the per-thread buffer fills, so every iteration measures a stored event
+        if (++spans % (TraceRecorder::SEGMENT_EVENTS * 64) == 0) {
+            state.PauseTiming();
+            tracer.reset();
+            state.ResumeTiming();
+        }
+    }
+    tracer.setEnabled(false);
+    tracer.reset();
+}
+BENCHMARK(BM_TraceSpan)->Arg(0)->Arg(1);
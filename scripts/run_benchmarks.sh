@@ -0,0 +1,55 @@
+#!/bin/bash
+
+# M8 Sample Formatter Benchmark Runner
+# Builds the benchmarks in release mode and keeps one JSON result per commit,
+# e.g. bench_results/2024-05-01-3f2a9c1.json, so runs can be compared over time.
+# Extra arguments go to the benchmark binary (e.g. --benchmark_filter=ProcessDirectory)
+
+set -e
+
+# Colors for output
+RED='\033[0;31m'
+GREEN='\033[0;32m'
+BLUE='\033[0;34m'
+NC='\033[0m' # No Color
+
+print_status() {
+    echo -e "${BLUE}[INFO]${NC} $1"
+}
+
+print_success() {
+    echo -e "${GREEN}[SUCCESS]${NC} $1"
+}
+
+print_error() {
+    echo -e "${RED}[ERROR]${NC} $1"
+}
+
+# Check if we're in the right directory
+if [ ! -f "CMakeLists.txt" ] || [ ! -d "benchmarks/cpp" ]; then
+    print_error "Please run this script from the project root directory"
+    exit 1
+fi
+
+BUILD_DIR=${BUILD_DIR:-build-bench}
+RESULTS_DIR=${RESULTS_DIR:-bench_results}
+
+print_status "Building benchmarks..."
+cmake -S . -B "$BUILD_DIR" -DCMAKE_BUILD_TYPE=Release -DBUILD_BENCHMARKS=ON > /dev/null
+cmake --build "$BUILD_DIR" --target M8SampleFormatterBench -j"$(getconf _NPROCESSORS_ONLN)"
+
+REVISION=$(git rev-parse --short HEAD 2>/dev/null || echo unknown)
+if [ -n "$(git status --porcelain --untracked-files=no 2>/dev/null)" ]; then
+    REVISION="${REVISION}-dirty"
+fi
+mkdir -p "$RESULTS_DIR"
+OUTPUT="$RESULTS_DIR/$(date +%Y-%m-%d)-${REVISION}.json"
+
+print_status "Running benchmarks at ${REVISION}..."
+"$BUILD_DIR/benchmarks/cpp/M8SampleFormatterBench" \
+    --benchmark_out="$OUTPUT" \
+    --benchmark_out_format=json \
+    --benchmark_context=revision="$REVISION" \
+    "$@"
+
+print_success "Results written to $OUTPUT"
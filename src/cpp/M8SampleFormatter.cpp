@@ -0,0 +1,826 @@
+#include "M8SampleFormatter.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+const std::vector<std::string> kIgnoredFolders = {".DS_Store", ".Trashes", ".Spotlight-V100", ".fseventsd"};
+}
+
+M8SampleFormatter::M8SampleFormatter()
+    : m_logger(Logger::getInstance()) {
+}
+
+bool M8SampleFormatter::processDirectory(const std::string& sourceDir, const std::string& outputDir, const ProcessingOptions& options) {
+    beginRun(sourceDir, outputDir, options);
+
+    JobPlan plan;
+    plan.sourceDir = sourceDir;
+    plan.outputDir = outputDir;
+    plan.optionsKey = optionsKey();
+
+    if (m_options.dryRun || !m_options.streamScan) {
+        // Plan the whole library first, then convert it longest job first
+        if (!buildPlan(plan, nullptr)) {
+            return false;
+        }
+        plan.sortLongestFirst();
+        if (m_options.dryRun) {
+            logPlan(plan);
+            saveProfile(plan);
+            saveTrace();
+            return true;
+        }
+        return runPlan(plan, [&plan](const JobSink& submit) {
+            for (const auto& job : plan.jobs) {
+                submit(job);
+            }
+            return true;
+        });
+    }
+
+    // Streaming: every file is planned and converted while the scan continues
+    return runPlan(plan, [this, &plan](const JobSink& submit) {
+        return buildPlan(plan, submit);
+    });
+}
+
+bool M8SampleFormatter::planDirectory(const std::string& sourceDir, const std::string& outputDir,
+                                      const ProcessingOptions& options, JobPlan& plan) {
+    beginRun(sourceDir, outputDir, options);
+
+    plan = JobPlan();
+    plan.sourceDir = sourceDir;
+    plan.outputDir = outputDir;
+    plan.optionsKey = optionsKey();
+    if (!buildPlan(plan, nullptr)) {
+        return false;
+    }
+    plan.sortLongestFirst();
+    return true;
+}
+
+bool M8SampleFormatter::executePlan(const JobPlan& plan, const ProcessingOptions& options) {
+    beginRun(plan.sourceDir, plan.outputDir, options);
+
+    if (plan.optionsKey != optionsKey()) {
+        m_logger.error("Job plan was made with different options (" + plan.optionsKey + ")");
+        return false;
+    }
+    if (plan.jobs.empty()) {
+        m_logger.error("Job plan has no jobs");
+        return false;
+    }
+    m_stats.totalFiles = plan.jobs.size();
+    m_stats.rejectedFiles = plan.rejectedFiles;
+
+    return runPlan(plan, [&plan](const JobSink& submit) {
+        for (const auto& job : plan.jobs) {
+            submit(job);
+        }
+        return true;
+    });
+}
+
+bool M8SampleFormatter::watchDirectory(const std::string& sourceDir, const std::string& outputDir,
+                                       const ProcessingOptions& options, DirectoryWatcher& watcher) {
+    // Watching first, so nothing dropped while the catch-up run below is busy is missed
+    if (!watcher.start(sourceDir, kIgnoredFolders)) {
+        return false;
+    }
+    // Never mapped: a sample re-saved in place while it is read would fault a mapping with SIGBUS
+    ProcessingOptions watchOptions = options;
+    watchOptions.memoryMap = false;
+    if (!processDirectory(sourceDir, outputDir, watchOptions)) {
+        m_logger.warning("Nothing converted yet; watching for new files");
+    }
+
+    JobPlan plan;
+    plan.sourceDir = sourceDir;
+    plan.outputDir = outputDir;
+    plan.optionsKey = optionsKey();
+    const ConversionPipeline::Config config = pipelineConfig();
+    std::string indexPath = (std::filesystem::path(outputDir) / ConversionIndex::DEFAULT_FILENAME).string();
+
+    std::atomic<size_t> convertedFiles{0};
+    std::atomic<size_t> errorFiles{0};
+    std::mutex jobSourcesMutex;
+    std::unordered_map<std::string, std::pair<uint64_t, int64_t>> jobSources;
+
+    // One pipeline for the whole session: its threads and chunk buffers stay warm between batches
+    ConversionPipeline pipeline(m_audioProcessor, config,
+        [&, this](const ConversionJob& job, bool success, const AudioInfo&, ConversionPipeline::FastPath fastPath) {
+            std::pair<uint64_t, int64_t> source;
+            {
+                std::lock_guard<std::mutex> lock(jobSourcesMutex);
+                source = jobSources.at(job.inputPath);
+                jobSources.erase(job.inputPath);
+            }
+            if (!success) {
+                errorFiles.fetch_add(1);
+                m_index.remove(job.inputPath);
+                m_logger.error("Failed to convert audio file: " + job.inputPath);
+                return;
+            }
+            if (fastPath == ConversionPipeline::FastPath::DUPLICATE &&
+                m_options.dedup == ConversionPipeline::DedupMode::SKIP) {
+                // Nothing written; the primary is seeded from the index, so later runs skip it too
+                m_index.remove(job.inputPath);
+                m_logger.debug("Duplicate audio, skipped: " + job.inputPath);
+                return;
+            }
+            convertedFiles.fetch_add(1);
+            m_logger.debug("Saved: " + job.outputPath);
+            m_index.update(indexEntry(job, source.first, source.second, plan.optionsKey));
+        });
+    // The catch-up run's outputs, so a copy of a sample converted before the watch started is a duplicate
+    seedKnownContent(pipeline, plan.optionsKey);
+
+    m_logger.info("Watching " + sourceDir + " (" + std::to_string(watcher.getWatchCount()) + " folders) for new samples");
+    const auto debounce = std::chrono::milliseconds(std::max(0, m_options.watchDebounceMs));
+    while (!watcher.isStopped()) {
+        DirectoryWatcher::Changes changes = watcher.waitForChanges(debounce, std::chrono::seconds(1));
+        if (changes.files.empty() && !changes.overflowed) {
+            continue;
+        }
+        auto batchStart = std::chrono::steady_clock::now();
+
+        std::vector<AudioFile> audioFiles;
+        if (changes.overflowed) {
+            m_logger.warning("Missed file events; rescanning " + sourceDir);
+            audioFiles = m_fileScanner.scanDirectory(sourceDir, kIgnoredFolders);
+        } else {
+            for (const auto& path : changes.files) {
+                AudioFile audioFile;
+                if (m_fileScanner.scanFile(path, sourceDir, audioFile)) {
+                    audioFiles.push_back(std::move(audioFile));
+                }
+            }
+        }
+
+        // Only what the index does not already have: a touched but unchanged file is not converted again
+        size_t converted = convertedFiles.load();
+        size_t errors = errorFiles.load();
+        size_t submitted = 0;
+        for (const auto& audioFile : audioFiles) {
+            JobPlan::Job planned;
+            try {
+                planned = planJob(audioFile, plan, config);
+            } catch (const std::exception& e) {
+                m_logger.error("Error processing file " + audioFile.filename + ": " + std::string(e.what()));
+                continue;
+            }
+            if (planned.upToDate) {
+                m_logger.debug("Unchanged, skipping: " + audioFile.filepath);
+                continue;
+            }
+
+            ConversionJob job;
+            job.inputPath = plan.sourcePath(planned);
+            job.outputPath = plan.outputPath(planned);
+            job.probe = planned.probe;
+            job.cost = planned.cost;
+            {
+                std::lock_guard<std::mutex> lock(jobSourcesMutex);
+                jobSources[job.inputPath] = {planned.size, planned.modifiedTime};
+            }
+            m_logger.info("Processing: " + audioFile.filename);
+            pipeline.submit(job);
+            submitted++;
+        }
+        if (submitted == 0) {
+            continue;
+        }
+
+        pipeline.waitIdle();
+        std::error_code error;
+        std::filesystem::create_directories(outputDir, error);
+        m_index.save(indexPath);
+
+        double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - batchStart).count();
+        std::ostringstream elapsed;
+        elapsed << std::fixed << std::setprecision(1) << milliseconds;
+        m_logger.info("Converted " + std::to_string(convertedFiles.load() - converted) + " of " +
+                     std::to_string(submitted) + " new or changed files in " + elapsed.str() + " ms" +
+                     (errorFiles.load() > errors ? " (" + std::to_string(errorFiles.load() - errors) + " failed)" : ""));
+    }
+
+    pipeline.finish();
+    m_logger.info("Stopped watching " + sourceDir + ": converted " + std::to_string(convertedFiles.load()) +
+                 " files, " + std::to_string(errorFiles.load()) + " errors");
+    return !watcher.lostRoot();
+}
+
+void M8SampleFormatter::logPlan(const JobPlan& plan) {
+    size_t counts[4] = {};
+    for (const auto& job : plan.jobs) {
+        std::string kb = std::to_string(job.estimatedBytes / 1024) + " KB";
+        if (job.upToDate) {
+            m_logger.info("[unchanged] " + job.source + " -> " + job.output);
+        } else {
+            counts[static_cast<size_t>(job.conversion)]++;
+            m_logger.info("[" + std::string(ConversionPipeline::fastPathName(job.conversion)) + "] " +
+                          job.source + " -> " + job.output + " (" + kb + ")");
+        }
+    }
+
+    m_logger.info("Plan: " + std::to_string(plan.pendingJobs()) + " of " + std::to_string(plan.jobs.size()) +
+                 " files to write (" +
+                 std::to_string(counts[static_cast<size_t>(ConversionPipeline::FastPath::NONE)]) + " convert, " +
+                 std::to_string(counts[static_cast<size_t>(ConversionPipeline::FastPath::NATIVE_PCM)]) + " native-pcm, " +
+                 std::to_string(counts[static_cast<size_t>(ConversionPipeline::FastPath::COPY)]) + " copy), about " +
+                 std::to_string(plan.pendingBytes() / 1024) + " KB");
+}
+
+void M8SampleFormatter::beginRun(const std::string& sourceDir, const std::string& outputDir, const ProcessingOptions& options) {
+    m_startTime = std::chrono::high_resolution_clock::now();
+
+    m_options = options;
+    m_stats = ProcessingStats();
+    m_logger.info("=== M8 Sample Formatter ===");
+    m_logger.info("Source directory: " + sourceDir);
+    m_logger.info("Output directory: " + outputDir);
+
+    // Consult the index from the previous run so unchanged samples are not re-converted
+    std::string indexPath = (std::filesystem::path(outputDir) / ConversionIndex::DEFAULT_FILENAME).string();
+    m_index.clear();
+    if (m_options.incremental && m_index.load(indexPath)) {
+        m_logger.info("Loaded conversion index with " + std::to_string(m_index.size()) + " entries");
+    }
+
+    // Outputs written by the previous run stay with their sources, whatever order this run claims names in
+    m_outputNames.clear();
+    for (const auto& entry : m_index.entries()) {
+        m_outputNames.claim(entry.outputPath, JobPlan::relativeTo(entry.sourcePath, sourceDir), true);
+    }
+    m_seededCollisions = m_outputNames.getCollisions();
+
+    StageProfiler& profiler = StageProfiler::getInstance();
+    profiler.reset();
+    profiler.setEnabled(!m_options.profilePath.empty());
+
+    TraceRecorder& tracer = TraceRecorder::getInstance();
+    tracer.reset();
+    tracer.setEnabled(!m_options.tracePath.empty());
+    tracer.setThreadName("main");
+}
+
+bool M8SampleFormatter::buildPlan(JobPlan& plan, const JobSink& onJob) {
+    const ConversionPipeline::Config config = pipelineConfig();
+    auto addJob = [&, this](const AudioFile& audioFile) {
+        try {
+            plan.jobs.push_back(planJob(audioFile, plan, config));
+        } catch (const std::exception& e) {
+            m_logger.error("Error processing file " + audioFile.filename + ": " + std::string(e.what()));
+            m_stats.errorFiles++;
+            return;
+        }
+        if (onJob) {
+            onJob(plan.jobs.back());
+        }
+    };
+
+    // Scan source directory; with onJob every discovered file is planned (and handed on) while the scan continues
+    m_logger.info("Scanning directory...");
+    m_fileScanner.setProbeHeaders(m_options.probeHeaders);
+    if (onJob) {
+        m_fileScanner.setFileCallback(addJob);
+    }
+    std::vector<AudioFile> audioFiles;
+    {
+        TraceRecorder::Span span("scan", "plan", plan.sourceDir);
+        audioFiles = m_fileScanner.scanDirectory(plan.sourceDir, kIgnoredFolders);
+    }
+    m_fileScanner.setFileCallback(nullptr);
+    m_stats.scanTime = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - m_startTime).count();
+    m_stats.rejectedFiles = m_fileScanner.getRejectedFiles();
+    plan.rejectedFiles = m_stats.rejectedFiles;
+
+    if (audioFiles.empty()) {
+        m_logger.error("No audio files found in source directory");
+        return false;
+    }
+
+    m_stats.totalFiles = audioFiles.size();
+    m_logger.info("Found " + std::to_string(audioFiles.size()) + " audio files");
+
+    if (!onJob) {
+        // In scan order, so output names are claimed in the same order on every run
+        plan.jobs.reserve(audioFiles.size());
+        for (const auto& audioFile : audioFiles) {
+            addJob(audioFile);
+        }
+        m_logger.info("Planned " + std::to_string(plan.pendingJobs()) + " conversions (" +
+                     std::to_string(plan.jobs.size() - plan.pendingJobs()) + " unchanged)");
+    }
+    return true;
+}
+
+JobPlan::Job M8SampleFormatter::planJob(const AudioFile& audioFile, const JobPlan& plan,
+                                        const ConversionPipeline::Config& config) {
+    TraceRecorder::Span span("plan", "plan", audioFile.filepath, audioFile.fileSize);
+    std::string outputPath;
+    {
+        StageProfiler::Timer timer(StageProfiler::PATH);
+        outputPath = generateOutputPath(audioFile, plan.sourceDir, plan.outputDir);
+    }
+
+    JobPlan::Job job;
+    job.source = JobPlan::relativeTo(audioFile.filepath, plan.sourceDir);
+    job.output = JobPlan::relativeTo(outputPath, plan.outputDir);
+    job.size = audioFile.fileSize;
+    job.modifiedTime = audioFile.modifiedTime;
+    job.probe = audioFile.probe;
+    job.probe.error.clear();
+    job.conversion = ConversionPipeline::plannedFastPath(job.probe, config);
+    job.estimatedBytes = ConversionPipeline::estimateOutputBytes(job.probe, audioFile.fileSize, config);
+    job.cost = ConversionPipeline::estimateCost(job.probe, audioFile.fileSize, config);
+    job.upToDate = m_options.incremental &&
+                   m_index.isUpToDate(audioFile.filepath, audioFile.fileSize, audioFile.modifiedTime, plan.optionsKey,
+                                      outputPath, m_options.verifyContentHash) &&
+                   std::filesystem::exists(outputPath);
+    return job;
+}
+
+ConversionPipeline::Config M8SampleFormatter::pipelineConfig() const {
+    ConversionPipeline::Config config;
+    config.readerThreads = m_options.readerThreads;
+    config.transformThreads = m_options.transformThreads;
+    config.writerThreads = m_options.writerThreads;
+    config.queueDepth = m_options.queueDepth;
+    config.nativeFastPath = m_options.nativeFastPath;
+    config.dither = m_options.dither;
+    config.targetSampleRate = m_options.targetSampleRate;
+    config.memoryMap = m_options.memoryMap;
+    config.trimSilence = m_options.trimSilence;
+    config.trimThresholdDb = m_options.trimThresholdDb;
+    config.trimFadeMs = m_options.trimFadeMs;
+    config.dedup = m_options.dedup;
+    return config;
+}
+
+ConversionIndex::Entry M8SampleFormatter::indexEntry(const ConversionJob& job, uint64_t size, int64_t modifiedTime,
+                                                     const std::string& optionsKey) const {
+    ConversionIndex::Entry entry;
+    entry.sourcePath = job.inputPath;
+    entry.size = size;
+    entry.modifiedTime = modifiedTime;
+    entry.contentHash = m_options.verifyContentHash ? ConversionIndex::hashFile(job.inputPath) : 0;
+    entry.optionsKey = optionsKey;
+    entry.outputPath = job.outputPath;
+    entry.audioHash = job.audioHash;
+    return entry;
+}
+
+void M8SampleFormatter::seedKnownContent(ConversionPipeline& pipeline, const std::string& optionsKey) {
+    if (m_options.dedup == ConversionPipeline::DedupMode::NONE) {
+        return;
+    }
+    for (const auto& entry : m_index.entries()) {
+        uint64_t size = 0;
+        int64_t modifiedTime = 0;
+        if (entry.audioHash == 0 || entry.optionsKey != optionsKey ||
+            !FileScanner::statFile(entry.sourcePath, size, modifiedTime) ||
+            size != entry.size || modifiedTime != entry.modifiedTime) {
+            continue;
+        }
+        pipeline.addConvertedContent(entry.audioHash, entry.sourcePath, entry.outputPath);
+    }
+}
+
+bool M8SampleFormatter::runPlan(const JobPlan& plan, const std::function<bool(const JobSink&)>& produceJobs) {
+    const std::string& currentOptions = plan.optionsKey;
+    const std::string& outputDir = plan.outputDir;
+    std::string indexPath = (std::filesystem::path(outputDir) / ConversionIndex::DEFAULT_FILENAME).string();
+
+    // Process files through the decode -> transform -> encode pipeline with real-time progress tracking.
+    // The denominator is the number of files submitted so far, which keeps growing while a streaming scan runs.
+    std::atomic<size_t> completedTasks{0};
+    std::atomic<size_t> submittedTasks{0};
+    std::atomic<size_t> processedFiles{0};
+    std::atomic<size_t> errorFiles{0};
+    std::atomic<size_t> skippedFiles{0};
+    std::atomic<size_t> convertedBitDepth{0};
+    std::atomic<size_t> fastPathFiles{0};
+    std::atomic<size_t> copiedFiles{0};
+    std::atomic<size_t> resampledFiles{0};
+    std::atomic<bool> firstOutput{false};
+
+    // Scan-time size/mtime of every submitted source, recorded in the index once its output is written
+    std::mutex jobSourcesMutex;
+    std::unordered_map<std::string, std::pair<uint64_t, int64_t>> jobSources;
+
+    ConversionPipeline pipeline(m_audioProcessor, pipelineConfig(),
+        [&, this](const ConversionJob& job, bool success, const AudioInfo& info, ConversionPipeline::FastPath fastPath) {
+            size_t currentCompleted = completedTasks.fetch_add(1) + 1;
+
+            bool skippedDuplicate = fastPath == ConversionPipeline::FastPath::DUPLICATE &&
+                                    m_options.dedup == ConversionPipeline::DedupMode::SKIP;
+            if (success && skippedDuplicate) {
+                // Nothing written; the primary is seeded from the index, so the next run skips it again
+                m_index.remove(job.inputPath);
+                m_logger.debug("Duplicate audio, skipped: " + job.inputPath);
+            } else if (success) {
+                processedFiles.fetch_add(1);
+                if (!firstOutput.exchange(true)) {
+                    m_stats.timeToFirstOutput = std::chrono::duration<double>(
+                        std::chrono::high_resolution_clock::now() - m_startTime).count();
+                }
+                if (m_options.convertBitDepth && info.bitDepth != m_options.targetBitDepth) {
+                    convertedBitDepth.fetch_add(1);
+                    m_logger.debug("Converted to " + std::to_string(m_options.targetBitDepth) + "-bit: " + job.inputPath);
+                }
+                if (m_options.targetSampleRate > 0 && info.sampleRate > m_options.targetSampleRate) {
+                    resampledFiles.fetch_add(1);
+                    m_logger.debug("Resampled " + std::to_string(info.sampleRate) + " Hz -> " +
+                                   std::to_string(m_options.targetSampleRate) + " Hz: " + job.inputPath);
+                }
+                if (fastPath == ConversionPipeline::FastPath::DUPLICATE) {
+                    m_logger.debug("Duplicate audio, " + std::string(ConversionPipeline::dedupModeName(m_options.dedup)) +
+                                   ": " + job.inputPath);
+                } else if (fastPath != ConversionPipeline::FastPath::NONE) {
+                    fastPathFiles.fetch_add(1);
+                    if (fastPath == ConversionPipeline::FastPath::COPY) {
+                        copiedFiles.fetch_add(1);
+                    }
+                }
+                m_logger.debug("Saved: " + job.outputPath);
+
+                std::pair<uint64_t, int64_t> source;
+                {
+                    std::lock_guard<std::mutex> lock(jobSourcesMutex);
+                    source = jobSources.at(job.inputPath);
+                }
+                m_index.update(indexEntry(job, source.first, source.second, currentOptions));
+            } else {
+                errorFiles.fetch_add(1);
+                m_index.remove(job.inputPath);
+                m_logger.error("Failed to convert audio file: " + job.inputPath);
+            }
+
+            // Send progress update
+            size_t total = std::max(submittedTasks.load(), currentCompleted);
+            double progress = static_cast<double>(currentCompleted) / static_cast<double>(total);
+            m_logger.info("Progress: " + std::to_string(static_cast<int>(progress * 100)) + "% (" +
+                         std::to_string(currentCompleted) + "/" + std::to_string(total) + " files)");
+        });
+
+    auto submitJob = [&, this](const JobPlan::Job& planned) {
+        ConversionJob job;
+        job.inputPath = plan.sourcePath(planned);
+        job.outputPath = plan.outputPath(planned);
+        job.probe = planned.probe;
+        job.cost = planned.cost;
+
+        // Checked again here: a plan made elsewhere may have been planned against a different output tree
+        if (planned.upToDate && std::filesystem::exists(job.outputPath)) {
+            skippedFiles.fetch_add(1);
+            m_logger.debug("Unchanged, skipping: " + job.inputPath);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(jobSourcesMutex);
+            jobSources[job.inputPath] = {planned.size, planned.modifiedTime};
+        }
+        m_logger.info("Processing: " + std::filesystem::path(job.inputPath).filename().string());
+        submittedTasks.fetch_add(1);
+        pipeline.submit(job);
+    };
+
+    seedKnownContent(pipeline, currentOptions);
+    if (!produceJobs(submitJob)) {
+        pipeline.finish();
+        return false;
+    }
+
+    if (skippedFiles.load() > 0) {
+        m_logger.info("Skipping " + std::to_string(skippedFiles.load()) + " unchanged files");
+    }
+
+    // Wait for all jobs to complete
+    {
+        TraceRecorder::Span span("finish", "wait");
+        pipeline.finish();
+    }
+    settleOutputNames(plan.sourceDir);
+
+    if (m_options.pruneDeleted) {
+        pruneDeletedSources(plan);
+    }
+    std::error_code error;
+    std::filesystem::create_directories(outputDir, error);
+    m_index.save(indexPath);
+
+    // Update stats
+    m_stats.processedFiles = processedFiles.load();
+    m_stats.errorFiles += errorFiles.load();  // Planning may have counted some already
+    m_stats.skippedFiles = skippedFiles.load();
+    m_stats.convertedBitDepth = convertedBitDepth.load();
+    m_stats.fastPathFiles = fastPathFiles.load();
+    m_stats.copiedFiles = copiedFiles.load();
+    m_stats.resampledFiles = resampledFiles.load();
+    m_stats.trimmedFiles = pipeline.getTrimmedFiles();
+    m_stats.trimmedBytes = pipeline.getTrimmedBytes();
+    m_stats.renamedFiles = m_outputNames.getCollisions() - m_seededCollisions;
+    m_stats.duplicateFiles = pipeline.getDuplicateFiles();
+    m_stats.dedupBytesSaved = pipeline.getDedupBytesSaved();
+    m_stats.stages = pipeline.getStageStats();
+    m_stats.schedule = pipeline.getScheduleStats();
+
+    std::vector<ConversionPipeline::DuplicateGroup> duplicateGroups = pipeline.getDuplicateGroups();
+    if (!duplicateGroups.empty()) {
+        saveDedupReport(outputDir, duplicateGroups);
+    }
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    m_stats.processingTime = std::chrono::duration<double>(endTime - m_startTime).count();
+
+    // Print summary
+    printSummary();
+    saveProfile(plan);
+    saveTrace();
+
+    // Output final stats for GUI
+    m_logger.info("FINAL_STATS: " + std::to_string(m_stats.totalFiles) + " " +
+                 std::to_string(m_stats.processedFiles) + " " +
+                 std::to_string(m_stats.errorFiles) + " " +
+                 std::to_string(m_stats.processingTime) + " " +
+                 std::to_string(m_stats.skippedFiles) + " " +
+                 std::to_string(m_stats.trimmedBytes));
+
+    return true;
+}
+
+std::string M8SampleFormatter::optionsKey() const {
+    // Everything that changes the bytes or location of an output file
+    return "bitdepth=" + std::to_string(m_options.convertBitDepth ? m_options.targetBitDepth : 0) +
+           ";flatten=" + std::to_string(m_options.flattenFolders ? 1 : 0) +
+           ";dither=" + AudioProcessor::ditherModeName(m_options.dither) +
+           ";rate=" + std::to_string(m_options.targetSampleRate) +
+           ";trim=" + (m_options.trimSilence ? std::to_string(m_options.trimThresholdDb) + "," +
+                                                   std::to_string(m_options.trimFadeMs) : std::string("off")) +
+           ";dedup=" + ConversionPipeline::dedupModeName(m_options.dedup);
+}
+
+void M8SampleFormatter::pruneDeletedSources(const JobPlan& plan) {
+    std::unordered_set<std::string> seenSources;
+    seenSources.reserve(plan.jobs.size());
+    for (const auto& job : plan.jobs) {
+        seenSources.insert(plan.sourcePath(job));
+    }
+
+    for (const auto& entry : m_index.pruneMissing(seenSources)) {
+        std::error_code error;
+        if (std::filesystem::remove(entry.outputPath, error)) {
+            m_stats.prunedFiles++;
+            m_logger.debug("Pruned output of deleted source: " + entry.outputPath);
+        } else if (error) {
+            m_logger.warning("Failed to prune " + entry.outputPath + ": " + error.message());
+        }
+    }
+
+    if (m_stats.prunedFiles > 0) {
+        m_logger.info("Pruned " + std::to_string(m_stats.prunedFiles) + " outputs of deleted sources");
+    }
+}
+
+void M8SampleFormatter::settleOutputNames(const std::string& sourceDir) {
+    std::vector<OutputNameRegistry::Handover> handovers = m_outputNames.settle();
+    if (handovers.empty()) {
+        return;
+    }
+
+    std::unordered_map<std::string, ConversionIndex::Entry> entries;
+    for (auto& entry : m_index.entries()) {
+        entries.emplace(entry.sourcePath, std::move(entry));
+    }
+    auto moveOutput = [&, this](const std::string& source, const std::string& from, const std::string& to) {
+        std::error_code error;
+        if (std::filesystem::exists(from, error)) {
+            std::filesystem::rename(from, to, error);
+            if (error) {
+                m_logger.warning("Failed to move " + from + " to " + to + ": " + error.message());
+                return;
+            }
+        }
+        auto entry = entries.find((std::filesystem::path(sourceDir) / source).string());
+        if (entry != entries.end() && entry->second.outputPath == from) {
+            entry->second.outputPath = to;
+            m_index.update(entry->second);
+        }
+    };
+
+    // The holder moves aside first, so on a case-insensitive card the two names never coexist
+    for (const auto& handover : handovers) {
+        m_logger.debug("Output name " + handover.winnerWants + " goes to " + handover.winner + ", moving " +
+                       handover.holder + " to " + handover.holderPath);
+        moveOutput(handover.holder, handover.path, handover.holderPath);
+        moveOutput(handover.winner, handover.winnerPath, handover.winnerWants);
+    }
+}
+
+std::string M8SampleFormatter::generateOutputPath(const AudioFile& audioFile, const std::string& sourceDir, const std::string& outputDir) {
+    // Generate output path (preserves or flattens directory structure)
+    std::string outputPath = m_options.flattenFolders
+        ? m_pathManager.generateFlattenedOutputPath(audioFile.filepath, sourceDir, outputDir)
+        : m_pathManager.generateOutputPath(audioFile.filepath, sourceDir, outputDir);
+
+    // Different sources can shorten to the same name; each still gets its own file. Claimed by the
+    // path within the library, so a suffixed name survives the library being mounted elsewhere
+    std::string claimed = m_outputNames.claim(outputPath, JobPlan::relativeTo(audioFile.filepath, sourceDir));
+    if (claimed != outputPath) {
+        m_logger.debug("Output name " + outputPath + " is taken, writing " + audioFile.filepath + " to " + claimed);
+    }
+    return claimed;
+}
+
+void M8SampleFormatter::printSummary() {
+    m_logger.info("\n=== Processing Complete ===");
+    m_logger.info("Total files: " + std::to_string(m_stats.totalFiles));
+    m_logger.info("Processed: " + std::to_string(m_stats.processedFiles));
+    m_logger.info("Errors: " + std::to_string(m_stats.errorFiles));
+    m_logger.info("Converted bit depth: " + std::to_string(m_stats.convertedBitDepth));
+    m_logger.info("Skipped (unchanged): " + std::to_string(m_stats.skippedFiles));
+    if (m_stats.rejectedFiles > 0) {
+        m_logger.info("Rejected (corrupt or unsupported): " + std::to_string(m_stats.rejectedFiles));
+    }
+    m_logger.info("Native 16-bit fast path: " + std::to_string(m_stats.fastPathFiles) +
+                 " (" + std::to_string(m_stats.copiedFiles) + " copied)");
+    if (m_options.targetSampleRate > 0) {
+        m_logger.info("Resampled to " + std::to_string(m_options.targetSampleRate) + " Hz: " +
+                     std::to_string(m_stats.resampledFiles));
+    }
+    if (m_options.trimSilence) {
+        m_logger.info("Trimmed silence: " + std::to_string(m_stats.trimmedFiles) + " files, " +
+                     std::to_string(m_stats.trimmedBytes / 1024) + " KB saved");
+    }
+    if (m_options.dedup != ConversionPipeline::DedupMode::NONE) {
+        m_logger.info("Duplicate audio (" + std::string(ConversionPipeline::dedupModeName(m_options.dedup)) + "): " +
+                     std::to_string(m_stats.duplicateFiles) + " files, " +
+                     std::to_string(m_stats.dedupBytesSaved / 1024) + " KB saved");
+    }
+    if (m_stats.renamedFiles > 0) {
+        m_logger.info("Renamed to avoid output collisions: " + std::to_string(m_stats.renamedFiles));
+    }
+    if (m_stats.prunedFiles > 0) {
+        m_logger.info("Pruned: " + std::to_string(m_stats.prunedFiles));
+    }
+    m_logger.info("Processing time: " + std::to_string(m_stats.processingTime) + " seconds");
+    m_logger.info("Scan time: " + std::to_string(m_stats.scanTime) + " seconds");
+    m_logger.debug("Output folder cache: " + std::to_string(m_pathManager.getFolderCacheHits()) + " hits, " +
+                   std::to_string(m_pathManager.getFolderCacheMisses()) + " misses");
+    if (m_stats.processedFiles > 0) {
+        m_logger.info("Time to first output: " + std::to_string(m_stats.timeToFirstOutput) + " seconds");
+    }
+
+    if (m_stats.processingTime > 0) {
+        double filesPerSecond = m_stats.totalFiles / m_stats.processingTime;
+        m_logger.info("Average speed: " + std::to_string(filesPerSecond) + " files/second");
+    }
+
+    // How close the readers came to a perfect packing of the jobs (100% = nothing left to gain by reordering)
+    if (m_stats.schedule.jobs > 0 && m_stats.schedule.makespanSeconds > 0) {
+        m_logger.info("Read makespan: " + std::to_string(m_stats.schedule.makespanSeconds) + "s, ideal " +
+                     std::to_string(m_stats.schedule.idealSeconds) + "s (" +
+                     std::to_string(static_cast<int>(100.0 * m_stats.schedule.idealSeconds /
+                                                     m_stats.schedule.makespanSeconds)) +
+                     "%), longest job " + std::to_string(m_stats.schedule.longestJobSeconds) + "s");
+    }
+
+    // Queue depth and stall time per stage: a stage whose producers stall is the bottleneck
+    for (const auto& stage : m_stats.stages) {
+        std::string capacity = stage.capacity > 0 ? std::to_string(stage.capacity) : "unbounded";
+        m_logger.info("Stage " + stage.name + ": " + std::to_string(stage.threads) + " threads, " +
+                     std::to_string(stage.items) + " items, max queue depth " + std::to_string(stage.maxDepth) +
+                     "/" + capacity + ", upstream stalled " + std::to_string(stage.producerStallSeconds) +
+                     "s, idle " + std::to_string(stage.consumerStallSeconds) + "s");
+    }
+}
+
+void M8SampleFormatter::saveReport(const std::string& outputDir) {
+    std::string reportPath = outputDir + "/processing_report.txt";
+    std::ofstream report(reportPath);
+
+    report << "M8 Sample Formatter - Processing Report\n";
+    report << "========================================\n\n";
+    report << "Total files: " << m_stats.totalFiles << "\n";
+    report << "Processed: " << m_stats.processedFiles << "\n";
+    report << "Errors: " << m_stats.errorFiles << "\n";
+    report << "Converted bit depth: " << m_stats.convertedBitDepth << "\n";
+    report << "Silence trimmed: " << m_stats.trimmedFiles << " files, " << m_stats.trimmedBytes << " bytes saved\n";
+    report << "Processing time: " << m_stats.processingTime << " seconds\n";
+
+    if (m_stats.processingTime > 0) {
+        report << "Average speed: " << (m_stats.totalFiles / m_stats.processingTime) << " files/second\n";
+    }
+
+    report.close();
+    m_logger.info("Processing report saved to: " + reportPath);
+}
+
+void M8SampleFormatter::saveDedupReport(const std::string& outputDir,
+                                        const std::vector<ConversionPipeline::DuplicateGroup>& groups) {
+    std::string reportPath = outputDir + "/dedup_report.txt";
+    std::ofstream report(reportPath);
+
+    report << "M8 Sample Formatter - Duplicate Audio\n";
+    report << "=====================================\n";
+    for (const auto& group : groups) {
+        report << "\n" << group.primary << "\n";
+        for (const auto& duplicate : group.duplicates) {
+            report << "  = " << duplicate << "\n";
+        }
+    }
+
+    report.close();
+    m_logger.info("Duplicate report saved to: " + reportPath);
+}
+
+void M8SampleFormatter::saveProfile(const JobPlan& plan) {
+    if (m_options.profilePath.empty()) {
+        return;
+    }
+    StageProfiler& profiler = StageProfiler::getInstance();
+    profiler.setEnabled(false);
+
+    // Stage times are summed over threads (busy seconds), so they can exceed the wall-clock run
+    // time. Comparing the io and cpu totals says what a slow run was waiting on
+    double kindSeconds[3] = {};  // io, cpu, mixed
+    std::ostringstream stages;
+    stages << std::fixed << std::setprecision(6);
+    std::vector<StageProfiler::Summary> summaries = profiler.summarize();
+    for (size_t i = 0; i < summaries.size(); i++) {
+        const StageProfiler::Summary& summary = summaries[i];
+        std::string kind = StageProfiler::stageKind(summary.stage);
+        kindSeconds[kind == "io" ? 0 : kind == "cpu" ? 1 : 2] += summary.totalNanos / 1e9;
+        stages << "    {\"name\": \"" << StageProfiler::stageName(summary.stage) << "\", \"kind\": \"" << kind
+               << "\", \"count\": " << summary.count
+               << ", \"busy_seconds\": " << summary.totalNanos / 1e9
+               << ", \"mean_us\": " << summary.totalNanos / 1e3 / summary.count
+               << ", \"p50_us\": " << summary.p50Nanos / 1e3
+               << ", \"p95_us\": " << summary.p95Nanos / 1e3
+               << ", \"p99_us\": " << summary.p99Nanos / 1e3
+               << ", \"max_us\": " << summary.maxNanos / 1e3 << "}"
+               << (i + 1 < summaries.size() ? ",\n" : "\n");
+    }
+
+    std::ofstream profile(m_options.profilePath);
+    profile << std::fixed << std::setprecision(6);
+    profile << "{\n";
+    profile << "  \"source\": " << Json::quote(plan.sourceDir) << ",\n";
+    profile << "  \"output\": " << Json::quote(plan.outputDir) << ",\n";
+    profile << "  \"run\": {\"files\": " << m_stats.totalFiles << ", \"processed\": " << m_stats.processedFiles
+            << ", \"errors\": " << m_stats.errorFiles << ", \"skipped\": " << m_stats.skippedFiles
+            << ", \"seconds\": " << m_stats.processingTime << ", \"scan_seconds\": " << m_stats.scanTime
+            << ", \"first_output_seconds\": " << m_stats.timeToFirstOutput << "},\n";
+    profile << "  \"schedule\": {\"jobs\": " << m_stats.schedule.jobs
+            << ", \"makespan_seconds\": " << m_stats.schedule.makespanSeconds
+            << ", \"ideal_seconds\": " << m_stats.schedule.idealSeconds
+            << ", \"busy_seconds\": " << m_stats.schedule.busySeconds
+            << ", \"longest_job_seconds\": " << m_stats.schedule.longestJobSeconds << "},\n";
+    profile << "  \"queues\": [\n";
+    for (size_t i = 0; i < m_stats.stages.size(); i++) {
+        const auto& stage = m_stats.stages[i];
+        profile << "    {\"name\": " << Json::quote(stage.name) << ", \"threads\": " << stage.threads
+                << ", \"capacity\": " << stage.capacity << ", \"max_depth\": " << stage.maxDepth
+                << ", \"items\": " << stage.items
+                << ", \"upstream_stall_seconds\": " << stage.producerStallSeconds
+                << ", \"idle_seconds\": " << stage.consumerStallSeconds << "}"
+                << (i + 1 < m_stats.stages.size() ? ",\n" : "\n");
+    }
+    profile << "  ],\n";
+    profile << "  \"stages\": [\n" << stages.str() << "  ],\n";
+    profile << "  \"busy_seconds\": {\"io\": " << kindSeconds[0] << ", \"cpu\": " << kindSeconds[1]
+            << ", \"mixed\": " << kindSeconds[2] << "}\n";
+    profile << "}\n";
+
+    if (!profile.good()) {
+        m_logger.error("Failed to write profile: " + m_options.profilePath);
+        return;
+    }
+    m_logger.info("Profile saved to: " + m_options.profilePath);
+}
+
+void M8SampleFormatter::saveTrace() {
+    if (m_options.tracePath.empty()) {
+        return;
+    }
+    TraceRecorder& tracer = TraceRecorder::getInstance();
+    tracer.setEnabled(false);
+
+    if (!tracer.write(m_options.tracePath)) {
+        m_logger.error("Failed to write trace: " + m_options.tracePath);
+        return;
+    }
+    size_t dropped = tracer.getDroppedCount();
+    m_logger.info("Trace saved to: " + m_options.tracePath + " (" + std::to_string(tracer.getEventCount()) + " events" +
+                  (dropped > 0 ? ", " + std::to_string(dropped) + " dropped" : std::string()) + ")");
+}
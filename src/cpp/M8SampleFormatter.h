@@ -0,0 +1,162 @@
+#pragma once
+
+#include "utils/Json.h"
+#include "utils/Logger.h"
+#include "utils/StageProfiler.h"
+#include "utils/TraceRecorder.h"
+#include "filesystem/FileScanner.h"
+#include "filesystem/OutputNameRegistry.h"
+#include "filesystem/PathManager.h"
+#include "filesystem/ConversionIndex.h"
+#include "filesystem/DirectoryWatcher.h"
+#include "filesystem/JobPlan.h"
+#include "audio/AudioProcessor.h"
+#include "audio/ConversionPipeline.h"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+class M8SampleFormatter {
+public:
+    struct ProcessingOptions {
+        bool convertBitDepth = true;
+        int targetBitDepth = 16;
+        bool flattenFolders = false;  // New option for folder flattening
+
+        // Pipeline sizing (0 = pick from hardware_concurrency)
+        size_t readerThreads = 0;
+        size_t transformThreads = 0;
+        size_t writerThreads = 2;
+        size_t queueDepth = 32;
+
+        // Incremental re-runs: skip sources the index says are unchanged
+        bool incremental = true;
+        bool verifyContentHash = false;  // Hash sources so touched-but-identical files are still skipped
+        bool pruneDeleted = false;       // Delete outputs whose source no longer exists
+
+        // Submit files to the pipeline as the scanner finds them instead of after the whole scan
+        bool streamScan = true;
+        // Parse headers during the scan so corrupt files never reach the pipeline
+        bool probeHeaders = true;
+
+        // Copy/rewrite 16-bit PCM sources without converting through float
+        bool nativeFastPath = true;
+
+        // Dither applied when reducing 24/32-bit sources to 16-bit
+        AudioProcessor::DitherMode dither = AudioProcessor::DitherMode::TPDF;
+
+        // Resample sources above this rate down to it, e.g. 44100 (0 = keep source rates)
+        int targetSampleRate = 0;
+
+        // Decode sources from memory-mapped files rather than buffered reads. A source truncated
+        // while mapped kills the process with SIGBUS, so watchDirectory always reads instead
+        bool memoryMap = true;
+
+        // Cut dead air from the start and end of each sample to save M8 sample memory
+        bool trimSilence = false;
+        float trimThresholdDb = -60.0f;  // dBFS; frames whose samples all stay below this are silent
+        double trimFadeMs = 0.0;         // Fade in/out over the kept audio's edges
+
+        // Sources with identical audio (the same sample shipped in several packs) are converted once
+        ConversionPipeline::DedupMode dedup = ConversionPipeline::DedupMode::NONE;
+
+        // Plan the run and log it, without writing anything
+        bool dryRun = false;
+
+        // Time every stage of every file and write the histograms here as JSON when the run ends
+        std::string profilePath;
+        // Record what every thread did and when, written here as Chrome Trace Event JSON (for Perfetto)
+        std::string tracePath;
+
+        // Watch mode: how long the source tree must stay quiet before a burst of new files is converted
+        int watchDebounceMs = 200;
+    };
+
+    struct ProcessingStats {
+        size_t totalFiles = 0;
+        size_t processedFiles = 0;
+        size_t errorFiles = 0;
+        size_t convertedBitDepth = 0;
+        size_t skippedFiles = 0;  // Unchanged since the last run
+        size_t rejectedFiles = 0; // Failed the header probe during the scan
+        size_t prunedFiles = 0;
+        size_t fastPathFiles = 0;  // 16-bit sources that skipped float conversion
+        size_t copiedFiles = 0;    // ...of which were copied as-is
+        size_t resampledFiles = 0;
+        size_t trimmedFiles = 0;
+        uint64_t trimmedBytes = 0;  // Output bytes saved by silence trimming
+        size_t duplicateFiles = 0;  // Same audio as another source in this run or an earlier one
+        uint64_t dedupBytesSaved = 0;
+        size_t renamedFiles = 0;  // Given a suffixed name because another source mapped to the same output
+        double processingTime = 0.0;
+        double scanTime = 0.0;
+        double timeToFirstOutput = 0.0;
+        std::vector<ConversionPipeline::StageStats> stages;
+        ConversionPipeline::ScheduleStats schedule;  // Makespan of the reader stage vs. the ideal packing
+    };
+
+    M8SampleFormatter();
+
+    // Plans and converts. With streamScan each file is converted as soon as the scan has planned
+    // it; otherwise the whole plan is built first and executed longest job first
+    bool processDirectory(const std::string& sourceDir, const std::string& outputDir, const ProcessingOptions& options);
+
+    // The two phases separately: planning scans, names outputs and checks the index but writes
+    // nothing; executing converts a plan, possibly one loaded from a file made on another machine
+    bool planDirectory(const std::string& sourceDir, const std::string& outputDir, const ProcessingOptions& options,
+                       JobPlan& plan);
+    bool executePlan(const JobPlan& plan, const ProcessingOptions& options);
+
+    // Converts the library, then keeps converting files that are added or modified under sourceDir
+    // until watcher.stop(); false if sourceDir is deleted or unmounted meanwhile. The pipeline's
+    // threads, the index and the output names stay in memory between batches, so a dropped sample
+    // only costs its own conversion
+    bool watchDirectory(const std::string& sourceDir, const std::string& outputDir, const ProcessingOptions& options,
+                        DirectoryWatcher& watcher);
+    void logPlan(const JobPlan& plan);
+
+    const ProcessingStats& getStats() const { return m_stats; }
+
+private:
+    Logger& m_logger;
+    FileScanner m_fileScanner;
+    PathManager m_pathManager;
+    OutputNameRegistry m_outputNames;
+    AudioProcessor m_audioProcessor;
+    ConversionIndex m_index;
+    ProcessingOptions m_options;
+    ProcessingStats m_stats;
+    std::chrono::high_resolution_clock::time_point m_startTime;
+    size_t m_seededCollisions = 0;
+
+    using JobSink = std::function<void(const JobPlan::Job&)>;
+
+    // Resets stats and loads the output tree's index
+    void beginRun(const std::string& sourceDir, const std::string& outputDir, const ProcessingOptions& options);
+    // Scans plan.sourceDir into plan.jobs; with onJob each job is also handed on as soon as it is planned
+    bool buildPlan(JobPlan& plan, const JobSink& onJob);
+    JobPlan::Job planJob(const AudioFile& audioFile, const JobPlan& plan, const ConversionPipeline::Config& config);
+    // Runs the pipeline over the jobs produceJobs submits (false from it aborts the run)
+    bool runPlan(const JobPlan& plan, const std::function<bool(const JobSink&)>& produceJobs);
+    // Moves outputs whose names a streaming scan handed out in arrival order to the sources that
+    // sort first, as a planned run names them
+    void settleOutputNames(const std::string& sourceDir);
+    ConversionPipeline::Config pipelineConfig() const;
+    // Hands the pipeline the audio of unchanged sources whose outputs an earlier run wrote, so a
+    // duplicate of one is still recognized when its primary is not converted again
+    void seedKnownContent(ConversionPipeline& pipeline, const std::string& optionsKey);
+    // What the index records for a job whose output was written
+    ConversionIndex::Entry indexEntry(const ConversionJob& job, uint64_t size, int64_t modifiedTime,
+                                      const std::string& optionsKey) const;
+
+    std::string generateOutputPath(const AudioFile& audioFile, const std::string& sourceDir, const std::string& outputDir);
+    std::string optionsKey() const;
+    void pruneDeletedSources(const JobPlan& plan);
+    void printSummary();
+    void saveReport(const std::string& outputDir);
+    void saveDedupReport(const std::string& outputDir, const std::vector<ConversionPipeline::DuplicateGroup>& groups);
+    void saveProfile(const JobPlan& plan);
+    void saveTrace();
+};
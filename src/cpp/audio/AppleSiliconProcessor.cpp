@@ -1,4 +1,5 @@
 #include "AppleSiliconProcessor.h"
+#include "SimdKernels.h"
 #include "Logger.h"
 #include <algorithm>
 #include <cmath>
@@ -83,36 +84,15 @@ bool AppleSiliconProcessor::convertToMono(const std::vector<float>& stereoData,
     }
     #endif
 
-    // Fallback to scalar implementation
-    for (size_t i = 0; i < monoSize; ++i) {
-        monoData[i] = (stereoData[i * 2] + stereoData[i * 2 + 1]) * 0.5f;
-    }
-
+    SimdKernels::get().downmixStereo(stereoData.data(), monoData.data(), monoSize);
     return true;
 }
 
 bool AppleSiliconProcessor::convertTo16Bit(const std::vector<float>& floatData, std::vector<short>& int16Data) {
     int16Data.resize(floatData.size());
 
-    #ifdef __APPLE__
-    if (m_vectorizationEnabled) {
-        // Use vDSP for vectorized conversion
-        // First convert float to 16-bit range, then to short
-        std::vector<float> tempFloat(floatData.size());
-        float scale = 32767.0f;
-        vDSP_vsmul(floatData.data(), 1, &scale, tempFloat.data(), 1, floatData.size());
-        
-        // Convert float to short
-        vDSP_vfix16(tempFloat.data(), 1, int16Data.data(), 1, floatData.size());
-        return true;
-    }
-    #endif
-
-    // Fallback to scalar implementation
-    for (size_t i = 0; i < floatData.size(); ++i) {
-        int16Data[i] = static_cast<short>(floatData[i] * 32767.0f);
-    }
-
+    // Rounds and clips in one pass (vDSP_vfix16 truncated and wrapped on overload)
+    SimdKernels::get().floatToInt16(floatData.data(), int16Data.data(), floatData.size());
     return true;
 }
 
@@ -130,22 +110,15 @@ bool AppleSiliconProcessor::normalize(const std::vector<float>& inputData, std::
     }
     #endif
 
-    // Fallback to scalar implementation
-    float maxVal = 0.0f;
-    for (float sample : inputData) {
-        maxVal = std::max(maxVal, std::abs(sample));
-    }
+    const SimdKernels& kernels = SimdKernels::get();
+    float maxVal = kernels.peak(inputData.data(), inputData.size());
 
     if (maxVal == 0.0f) {
         outputData = inputData;
         return true;
     }
 
-    float scale = 1.0f / maxVal;
-    for (size_t i = 0; i < inputData.size(); ++i) {
-        outputData[i] = inputData[i] * scale;
-    }
-
+    kernels.applyGain(inputData.data(), outputData.data(), inputData.size(), 1.0f / maxVal);
     return true;
 }
 
@@ -161,8 +134,19 @@ bool AppleSiliconProcessor::batchProcess(const std::vector<float>& inputData, st
     }
     #endif
 
-    // Fallback to scalar implementation
-    outputData = inputData;
+    outputData.resize(inputData.size());
+    if (numChannels == 2) {
+        // Same result as the vDSP path: mono mix written back to both channels
+        size_t monoSize = inputData.size() / 2;
+        std::vector<float> monoData(monoSize);
+        SimdKernels::get().downmixStereo(inputData.data(), monoData.data(), monoSize);
+        for (size_t i = 0; i < monoSize; ++i) {
+            outputData[i * 2] = monoData[i];
+            outputData[i * 2 + 1] = monoData[i];
+        }
+    } else {
+        outputData = inputData;
+    }
     return true;
 }
 
@@ -0,0 +1,264 @@
+#include "AudioFileReader.h"
+#include "ContentHash.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+// Sample widened to a left-justified 32-bit integer, so every width shares one scale
+inline int32_t pcmAt(const unsigned char* p, int bytes, bool bigEndian) {
+    uint32_t value = 0;
+    if (bigEndian) {
+        for (int b = 0; b < bytes; b++) {
+            value = (value << 8) | p[b];
+        }
+        value <<= 8 * (4 - bytes);
+    } else {
+        for (int b = 0; b < bytes; b++) {
+            value |= static_cast<uint32_t>(p[b]) << (8 * (b + 4 - bytes));
+        }
+    }
+    return static_cast<int32_t>(value);
+}
+
+inline float floatAt(const unsigned char* p, bool bigEndian) {
+    uint32_t bits = static_cast<uint32_t>(pcmAt(p, 4, bigEndian));
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+inline int16_t le16At(const unsigned char* p) {
+    return static_cast<int16_t>(p[0] | (p[1] << 8));
+}
+}
+
+AudioFileReader::~AudioFileReader() {
+    close();
+}
+
+bool AudioFileReader::open(const std::string& filepath, bool memoryMap) {
+    close();
+
+    if (memoryMap && mapFile(filepath)) {
+        // The whole file is addressable, so the probe can follow chunks anywhere in it
+        AudioProbe::Result probe = AudioProbe::probeBuffer(m_map, m_mapSize, m_mapSize);
+        if (openDirect(probe) || openVirtual()) {
+            return true;
+        }
+        close();
+        return false;
+    }
+
+    m_file = sf_open(filepath.c_str(), SFM_READ, &m_info);
+    return m_file != nullptr;
+}
+
+void AudioFileReader::close() {
+    if (m_file) {
+        sf_close(m_file);
+        m_file = nullptr;
+    }
+    if (m_map) {
+        ::munmap(const_cast<unsigned char*>(m_map), m_mapSize);
+        m_map = nullptr;
+        m_mapSize = 0;
+    }
+    m_info = SF_INFO{};
+    m_direct = false;
+    m_data = nullptr;
+    m_bytesPerSample = 0;
+    m_float = false;
+    m_bigEndian = false;
+    m_position = 0;
+    m_virtualOffset = 0;
+}
+
+bool AudioFileReader::mapFile(const std::string& filepath) {
+    int fd = ::open(filepath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    void* map = MAP_FAILED;
+    if (::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        map = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    // The mapping keeps the file referenced
+    ::close(fd);
+
+    if (map == MAP_FAILED) {
+        return false;
+    }
+    ::madvise(map, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+
+    m_map = static_cast<const unsigned char*>(map);
+    m_mapSize = static_cast<size_t>(st.st_size);
+    return true;
+}
+
+bool AudioFileReader::openDirect(const AudioProbe::Result& probe) {
+    if (probe.status != AudioProbe::VALID || probe.dataOffset == 0 || probe.info.channels <= 0) {
+        return false;
+    }
+
+    int container = probe.format & SF_FORMAT_TYPEMASK;
+    if (container != SF_FORMAT_WAV && container != SF_FORMAT_WAVEX && container != SF_FORMAT_RF64 &&
+        container != SF_FORMAT_AIFF) {
+        return false;
+    }
+    switch (probe.format & SF_FORMAT_SUBMASK) {
+        case SF_FORMAT_PCM_16: m_bytesPerSample = 2; break;
+        case SF_FORMAT_PCM_24: m_bytesPerSample = 3; break;
+        case SF_FORMAT_PCM_32: m_bytesPerSample = 4; break;
+        case SF_FORMAT_FLOAT: m_bytesPerSample = 4; m_float = true; break;
+        default: return false;  // 8-bit and double stay with libsndfile
+    }
+
+    m_direct = true;
+    m_data = m_map + probe.dataOffset;
+    m_bigEndian = probe.bigEndian;
+    m_info.frames = static_cast<sf_count_t>(probe.info.frameCount);
+    m_info.samplerate = probe.info.sampleRate;
+    m_info.channels = probe.info.channels;
+    m_info.format = probe.format;
+    m_info.sections = 1;
+    m_info.seekable = 1;
+    return true;
+}
+
+bool AudioFileReader::openVirtual() {
+    m_virtualIo.get_filelen = &AudioFileReader::virtualLength;
+    m_virtualIo.seek = &AudioFileReader::virtualSeek;
+    m_virtualIo.read = &AudioFileReader::virtualRead;
+    m_virtualIo.write = &AudioFileReader::virtualWrite;
+    m_virtualIo.tell = &AudioFileReader::virtualTell;
+
+    m_virtualOffset = 0;
+    m_file = sf_open_virtual(&m_virtualIo, SFM_READ, &m_info, this);
+    return m_file != nullptr;
+}
+
+uint64_t AudioFileReader::contentHash() const {
+    if (!m_map) {
+        return 0;
+    }
+    if (m_direct) {
+        // Sample bytes only, so copies that differ in metadata chunks still match
+        size_t bytes = static_cast<size_t>(m_info.frames) * static_cast<size_t>(m_info.channels) *
+                       static_cast<size_t>(m_bytesPerSample);
+        return ContentHash::hash(m_data, bytes);
+    }
+    return ContentHash::hash(m_map, m_mapSize);
+}
+
+size_t AudioFileReader::claimFrames(sf_count_t frames) {
+    sf_count_t count = std::min(frames, m_info.frames - m_position);
+    if (count <= 0) {
+        return 0;
+    }
+    m_position += count;
+    return static_cast<size_t>(count);
+}
+
+sf_count_t AudioFileReader::readFloat(float* output, sf_count_t frames) {
+    if (m_file) {
+        return sf_readf_float(m_file, output, frames);
+    }
+    if (!m_direct) {
+        return 0;
+    }
+
+    const size_t stride = static_cast<size_t>(m_bytesPerSample);
+    const unsigned char* p = m_data + static_cast<size_t>(m_position) * stride * m_info.channels;
+    size_t count = claimFrames(frames);
+    size_t samples = count * static_cast<size_t>(m_info.channels);
+
+    if (m_float) {
+        for (size_t i = 0; i < samples; i++) {
+            output[i] = floatAt(p + i * 4, m_bigEndian);
+        }
+    } else if (stride == 2 && !m_bigEndian) {
+        // The common case, kept simple enough to vectorize
+        for (size_t i = 0; i < samples; i++) {
+            output[i] = static_cast<float>(le16At(p + i * 2)) * (1.0f / 32768.0f);
+        }
+    } else if (stride == 3 && !m_bigEndian) {
+        for (size_t i = 0; i < samples; i++) {
+            const unsigned char* s = p + i * 3;
+            int32_t value = static_cast<int32_t>((static_cast<uint32_t>(s[0]) << 8) | (static_cast<uint32_t>(s[1]) << 16) |
+                                                 (static_cast<uint32_t>(s[2]) << 24));
+            output[i] = static_cast<float>(value) * (1.0f / 2147483648.0f);
+        }
+    } else {
+        for (size_t i = 0; i < samples; i++) {
+            output[i] = static_cast<float>(pcmAt(p + i * stride, m_bytesPerSample, m_bigEndian)) * (1.0f / 2147483648.0f);
+        }
+    }
+    return static_cast<sf_count_t>(count);
+}
+
+sf_count_t AudioFileReader::readShort(short* output, sf_count_t frames) {
+    if (m_file) {
+        return sf_readf_short(m_file, output, frames);
+    }
+    if (!m_direct) {
+        return 0;
+    }
+
+    const size_t stride = static_cast<size_t>(m_bytesPerSample);
+    const unsigned char* p = m_data + static_cast<size_t>(m_position) * stride * m_info.channels;
+    size_t count = claimFrames(frames);
+    size_t samples = count * static_cast<size_t>(m_info.channels);
+
+    if (m_float) {
+        for (size_t i = 0; i < samples; i++) {
+            float value = std::clamp(floatAt(p + i * 4, m_bigEndian) * 32767.0f, -32768.0f, 32767.0f);
+            output[i] = static_cast<short>(std::lrintf(value));
+        }
+    } else if (stride == 2 && !m_bigEndian) {
+        for (size_t i = 0; i < samples; i++) {
+            output[i] = le16At(p + i * 2);
+        }
+    } else {
+        // Deeper samples are truncated to their top 16 bits, as libsndfile does
+        for (size_t i = 0; i < samples; i++) {
+            output[i] = static_cast<short>(pcmAt(p + i * stride, m_bytesPerSample, m_bigEndian) >> 16);
+        }
+    }
+    return static_cast<sf_count_t>(count);
+}
+
+sf_count_t AudioFileReader::virtualLength(void* userData) {
+    return static_cast<sf_count_t>(static_cast<AudioFileReader*>(userData)->m_mapSize);
+}
+
+sf_count_t AudioFileReader::virtualSeek(sf_count_t offset, int whence, void* userData) {
+    auto* reader = static_cast<AudioFileReader*>(userData);
+    sf_count_t base = whence == SEEK_CUR ? reader->m_virtualOffset
+                    : whence == SEEK_END ? static_cast<sf_count_t>(reader->m_mapSize) : 0;
+    reader->m_virtualOffset = std::clamp<sf_count_t>(base + offset, 0, static_cast<sf_count_t>(reader->m_mapSize));
+    return reader->m_virtualOffset;
+}
+
+sf_count_t AudioFileReader::virtualRead(void* ptr, sf_count_t count, void* userData) {
+    auto* reader = static_cast<AudioFileReader*>(userData);
+    sf_count_t available = static_cast<sf_count_t>(reader->m_mapSize) - reader->m_virtualOffset;
+    count = std::clamp<sf_count_t>(count, 0, available);
+    std::memcpy(ptr, reader->m_map + reader->m_virtualOffset, static_cast<size_t>(count));
+    reader->m_virtualOffset += count;
+    return count;
+}
+
+sf_count_t AudioFileReader::virtualWrite(const void*, sf_count_t, void*) {
+    return 0;  // Read-only mapping
+}
+
+sf_count_t AudioFileReader::virtualTell(void* userData) {
+    return static_cast<AudioFileReader*>(userData)->m_virtualOffset;
+}
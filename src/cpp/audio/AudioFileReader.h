@@ -0,0 +1,76 @@
+#pragma once
+
+#include "AudioProbe.h"
+#include <sndfile.h>
+#include <cstddef>
+#include <string>
+
+// Sequential sample reader over a memory-mapped source file.
+//
+// The file is mapped read-only and advised MADV_SEQUENTIAL. WAV and AIFF with
+// plain 16/24/32-bit PCM or float samples are decoded straight from the mapped
+// pages into the caller's buffer, so each sample is touched once instead of
+// being read() into libsndfile's buffer and converted out of it. Anything else
+// is handed to libsndfile through sf_open_virtual over the same mapping.
+// Without memoryMap (or if mapping fails) this is a thin wrapper over sf_open.
+//
+// A mapped file must not shrink while it is read: touching pages past its new
+// end raises SIGBUS. Pass memoryMap = false for sources that may be rewritten
+// in place meanwhile.
+//
+// Reads return the same values as sf_readf_float/sf_readf_short on the file.
+class AudioFileReader {
+public:
+    AudioFileReader() = default;
+    ~AudioFileReader();
+
+    AudioFileReader(const AudioFileReader&) = delete;
+    AudioFileReader& operator=(const AudioFileReader&) = delete;
+
+    bool open(const std::string& filepath, bool memoryMap = true);
+    void close();
+
+    // As sf_open would fill it in
+    const SF_INFO& getInfo() const { return m_info; }
+    bool isOpen() const { return m_file != nullptr || m_direct; }
+    bool isMapped() const { return m_map != nullptr; }
+    // Decoding from the mapping without going through libsndfile
+    bool isDirect() const { return m_direct; }
+
+    // ContentHash of the sample data (of the whole file when libsndfile decodes it), 0 when not mapped
+    uint64_t contentHash() const;
+
+    // Frames read, 0 at the end of the data
+    sf_count_t readFloat(float* output, sf_count_t frames);
+    sf_count_t readShort(short* output, sf_count_t frames);
+
+private:
+    SF_INFO m_info{};
+    SNDFILE* m_file = nullptr;
+
+    const unsigned char* m_map = nullptr;
+    size_t m_mapSize = 0;
+
+    // Direct decoding state
+    bool m_direct = false;
+    const unsigned char* m_data = nullptr;
+    int m_bytesPerSample = 0;
+    bool m_float = false;
+    bool m_bigEndian = false;
+    sf_count_t m_position = 0;
+
+    // sf_open_virtual cursor into the mapping
+    SF_VIRTUAL_IO m_virtualIo{};
+    sf_count_t m_virtualOffset = 0;
+
+    bool mapFile(const std::string& filepath);
+    bool openDirect(const AudioProbe::Result& probe);
+    bool openVirtual();
+    size_t claimFrames(sf_count_t frames);
+
+    static sf_count_t virtualLength(void* userData);
+    static sf_count_t virtualSeek(sf_count_t offset, int whence, void* userData);
+    static sf_count_t virtualRead(void* ptr, sf_count_t count, void* userData);
+    static sf_count_t virtualWrite(const void* ptr, sf_count_t count, void* userData);
+    static sf_count_t virtualTell(void* userData);
+};
@@ -0,0 +1,351 @@
+#include "AudioProbe.h"
+#include <sndfile.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+// Chunks walked before giving up on finding the format/data chunks
+constexpr int kMaxChunks = 64;
+
+uint16_t le16(const unsigned char* p) { return static_cast<uint16_t>(p[0] | (p[1] << 8)); }
+uint32_t le32(const unsigned char* p) { return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+                                               (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24); }
+uint64_t le64(const unsigned char* p) { return le32(p) | (static_cast<uint64_t>(le32(p + 4)) << 32); }
+uint16_t be16(const unsigned char* p) { return static_cast<uint16_t>((p[0] << 8) | p[1]); }
+uint32_t be32(const unsigned char* p) { return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+                                               (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]); }
+
+// Serves header bytes from the initial read, falling back to pread for chunks further in
+struct HeaderReader {
+    int fd;
+    const unsigned char* buffer;
+    size_t size;
+    uint64_t fileSize;
+
+    bool read(uint64_t offset, unsigned char* out, size_t length) const {
+        if (offset + length > fileSize) {
+            return false;
+        }
+        if (offset + length <= size) {
+            std::memcpy(out, buffer + offset, length);
+            return true;
+        }
+        if (fd < 0) {
+            return false;
+        }
+        ssize_t got = ::pread(fd, out, length, static_cast<off_t>(offset));
+        return got == static_cast<ssize_t>(length);
+    }
+};
+
+AudioProbe::Result invalid(const std::string& error) {
+    AudioProbe::Result result;
+    result.status = AudioProbe::INVALID;
+    result.error = error;
+    return result;
+}
+
+AudioProbe::Result unknown() {
+    return AudioProbe::Result();
+}
+
+AudioProbe::Result valid(int format, int sampleRate, int channels, int bitDepth, uint64_t frames) {
+    AudioProbe::Result result;
+    result.status = AudioProbe::VALID;
+    result.format = format;
+    result.info.sampleRate = sampleRate;
+    result.info.channels = channels;
+    result.info.bitDepth = bitDepth;
+    result.info.frameCount = static_cast<size_t>(frames);
+    result.info.isStereo = channels == 2;
+    int subtype = format & SF_FORMAT_SUBMASK;
+    result.info.isPCM = subtype == SF_FORMAT_PCM_16 || subtype == SF_FORMAT_PCM_24 || subtype == SF_FORMAT_PCM_32;
+    return result;
+}
+
+int pcmSubtype(int bytesPerSample, bool unsigned8) {
+    switch (bytesPerSample) {
+        case 1: return unsigned8 ? SF_FORMAT_PCM_U8 : SF_FORMAT_PCM_S8;
+        case 2: return SF_FORMAT_PCM_16;
+        case 3: return SF_FORMAT_PCM_24;
+        case 4: return SF_FORMAT_PCM_32;
+        default: return 0;
+    }
+}
+
+AudioProbe::Result probeWav(const HeaderReader& reader, bool rf64) {
+    unsigned char fmt[40] = {};
+    bool haveFmt = false;
+    uint64_t ds64DataSize = 0;
+    uint64_t dataOffset = 0;
+    uint64_t dataSize = 0;
+    bool haveData = false;
+
+    uint64_t offset = 12;
+    for (int chunks = 0; chunks < kMaxChunks && !(haveFmt && haveData); chunks++) {
+        unsigned char header[8];
+        if (!reader.read(offset, header, sizeof(header))) {
+            break;
+        }
+        uint64_t chunkSize = le32(header + 4);
+
+        if (std::memcmp(header, "fmt ", 4) == 0) {
+            if (chunkSize < 16 || !reader.read(offset + 8, fmt, std::min<size_t>(chunkSize, sizeof(fmt)))) {
+                return invalid("truncated fmt chunk");
+            }
+            haveFmt = true;
+        } else if (std::memcmp(header, "ds64", 4) == 0) {
+            unsigned char ds64[16];
+            if (chunkSize < 16 || !reader.read(offset + 8, ds64, sizeof(ds64))) {
+                return invalid("truncated ds64 chunk");
+            }
+            ds64DataSize = le64(ds64 + 8);
+        } else if (std::memcmp(header, "data", 4) == 0) {
+            dataOffset = offset + 8;
+            dataSize = rf64 && chunkSize == 0xFFFFFFFF ? ds64DataSize : chunkSize;
+            haveData = true;
+        }
+        offset += 8 + chunkSize + (chunkSize & 1);
+    }
+
+    if (!haveFmt) {
+        return invalid("no fmt chunk");
+    }
+    if (!haveData) {
+        return invalid("no data chunk");
+    }
+
+    uint16_t formatTag = le16(fmt);
+    int channels = le16(fmt + 2);
+    int sampleRate = static_cast<int>(le32(fmt + 4));
+    int blockAlign = le16(fmt + 12);
+    if (channels == 0 || sampleRate <= 0 || blockAlign == 0) {
+        return invalid("bad fmt chunk");
+    }
+
+    const int container = rf64 ? SF_FORMAT_RF64 : (formatTag == 0xFFFE ? SF_FORMAT_WAVEX : SF_FORMAT_WAV);
+    if (formatTag == 0xFFFE) {
+        // WAVE_FORMAT_EXTENSIBLE: the real tag is the first two bytes of the sub-format GUID
+        formatTag = le16(fmt + 24);
+    }
+
+    int bytesPerSample = blockAlign / channels;
+    int subtype = 0;
+    if (formatTag == 1) {
+        subtype = pcmSubtype(bytesPerSample, true);
+    } else if (formatTag == 3) {
+        subtype = bytesPerSample == 4 ? SF_FORMAT_FLOAT : (bytesPerSample == 8 ? SF_FORMAT_DOUBLE : 0);
+    } else {
+        return unknown();  // ADPCM, mu-law, ... are libsndfile's business
+    }
+    if (subtype == 0) {
+        return invalid("unsupported sample width");
+    }
+
+    // Truncated files decode up to the end of the file
+    uint64_t available = std::min(dataSize, reader.fileSize - std::min(dataOffset, reader.fileSize));
+    uint64_t frames = available / static_cast<uint64_t>(blockAlign);
+    int bitDepth = subtype == SF_FORMAT_DOUBLE ? 64 : bytesPerSample * 8;
+    AudioProbe::Result result = valid(container | subtype, sampleRate, channels, bitDepth, frames);
+    result.dataOffset = dataOffset;
+    result.dataBytes = frames * static_cast<uint64_t>(blockAlign);
+    return result;
+}
+
+// IEEE 754 80-bit extended, as used for the AIFF sample rate
+double extendedToDouble(const unsigned char* p) {
+    int exponent = ((p[0] & 0x7F) << 8) | p[1];
+    uint64_t mantissa = (static_cast<uint64_t>(be32(p + 2)) << 32) | be32(p + 6);
+    if (exponent == 0 && mantissa == 0) {
+        return 0.0;
+    }
+    double value = std::ldexp(static_cast<double>(mantissa), exponent - 16383 - 63);
+    return (p[0] & 0x80) ? -value : value;
+}
+
+AudioProbe::Result probeAiff(const HeaderReader& reader, bool aifc) {
+    unsigned char comm[22] = {};
+    bool haveComm = false;
+    uint64_t soundOffset = 0;
+    uint64_t soundBytes = 0;
+    bool haveSound = false;
+
+    uint64_t offset = 12;
+    for (int chunks = 0; chunks < kMaxChunks && !(haveComm && haveSound); chunks++) {
+        unsigned char header[8];
+        if (!reader.read(offset, header, sizeof(header))) {
+            break;
+        }
+        uint64_t chunkSize = be32(header + 4);
+
+        if (std::memcmp(header, "COMM", 4) == 0) {
+            size_t needed = aifc ? 22 : 18;
+            if (chunkSize < needed || !reader.read(offset + 8, comm, needed)) {
+                return invalid("truncated COMM chunk");
+            }
+            haveComm = true;
+        } else if (std::memcmp(header, "SSND", 4) == 0) {
+            unsigned char ssnd[8];
+            if (chunkSize < 8 || !reader.read(offset + 8, ssnd, sizeof(ssnd))) {
+                return invalid("truncated SSND chunk");
+            }
+            uint64_t dataOffset = offset + 16 + be32(ssnd);
+            uint64_t dataEnd = std::min(offset + 8 + chunkSize, reader.fileSize);
+            soundOffset = dataOffset;
+            soundBytes = dataEnd > dataOffset ? dataEnd - dataOffset : 0;
+            haveSound = true;
+        }
+        offset += 8 + chunkSize + (chunkSize & 1);
+    }
+
+    if (!haveComm) {
+        return invalid("no COMM chunk");
+    }
+
+    int channels = static_cast<int16_t>(be16(comm));
+    uint64_t frames = be32(comm + 2);
+    int bits = static_cast<int16_t>(be16(comm + 6));
+    double sampleRate = extendedToDouble(comm + 8);
+    if (channels <= 0 || bits <= 0 || bits > 64 || !(sampleRate >= 1.0 && sampleRate < 1e7)) {
+        return invalid("bad COMM chunk");
+    }
+    if (frames > 0 && !haveSound) {
+        return invalid("no SSND chunk");
+    }
+
+    int subtype = pcmSubtype((bits + 7) / 8, false);
+    int bytesPerSample = (bits + 7) / 8;
+    int bitDepth = bytesPerSample * 8;
+    bool bigEndian = true;
+    if (aifc) {
+        if (std::memcmp(comm + 18, "fl32", 4) == 0 || std::memcmp(comm + 18, "FL32", 4) == 0) {
+            subtype = SF_FORMAT_FLOAT;
+            bytesPerSample = 4;
+            bitDepth = 32;
+        } else if (std::memcmp(comm + 18, "fl64", 4) == 0 || std::memcmp(comm + 18, "FL64", 4) == 0) {
+            subtype = SF_FORMAT_DOUBLE;
+            bytesPerSample = 8;
+            bitDepth = 64;
+        } else if (std::memcmp(comm + 18, "sowt", 4) == 0) {
+            bigEndian = false;
+        } else if (std::memcmp(comm + 18, "NONE", 4) != 0 && std::memcmp(comm + 18, "twos", 4) != 0) {
+            return unknown();  // Compressed AIFC
+        }
+    }
+    if (subtype == 0) {
+        return invalid("unsupported sample width");
+    }
+
+    uint64_t frameBytes = static_cast<uint64_t>(bytesPerSample) * channels;
+    frames = std::min(frames, soundBytes / frameBytes);
+    AudioProbe::Result result = valid(SF_FORMAT_AIFF | subtype, static_cast<int>(std::lround(sampleRate)), channels, bitDepth, frames);
+    result.dataOffset = soundOffset;
+    result.dataBytes = frames * frameBytes;
+    result.bigEndian = bigEndian;
+    return result;
+}
+
+AudioProbe::Result probeFlac(const HeaderReader& reader, uint64_t offset) {
+    // "fLaC", then the mandatory STREAMINFO block
+    unsigned char header[8 + 34];
+    if (!reader.read(offset, header, sizeof(header))) {
+        return invalid("truncated FLAC header");
+    }
+    if (std::memcmp(header, "fLaC", 4) != 0) {
+        return unknown();  // ID3-tagged, but not FLAC (MP3)
+    }
+    if ((header[4] & 0x7F) != 0 || ((header[5] << 16) | (header[6] << 8) | header[7]) < 34) {
+        return invalid("missing STREAMINFO");
+    }
+
+    const unsigned char* info = header + 8;
+    int sampleRate = (info[10] << 12) | (info[11] << 4) | (info[12] >> 4);
+    int channels = ((info[12] >> 1) & 0x07) + 1;
+    int bits = (((info[12] & 0x01) << 4) | (info[13] >> 4)) + 1;
+    uint64_t frames = (static_cast<uint64_t>(info[13] & 0x0F) << 32) | be32(info + 14);
+    if (sampleRate == 0) {
+        return invalid("bad STREAMINFO");
+    }
+
+    int subtype = bits <= 8 ? SF_FORMAT_PCM_S8 : bits <= 16 ? SF_FORMAT_PCM_16 : bits <= 24 ? SF_FORMAT_PCM_24 : 0;
+    if (subtype == 0) {
+        return unknown();
+    }
+    return valid(SF_FORMAT_FLAC | subtype, sampleRate, channels, (bits + 7) / 8 * 8, frames);
+}
+
+
+AudioProbe::Result probeHeader(const HeaderReader& reader) {
+    if (reader.size < 12) {
+        return invalid("file too short");
+    }
+    const unsigned char* p = reader.buffer;
+    if (std::memcmp(p, "RIFF", 4) == 0 || std::memcmp(p, "RF64", 4) == 0 || std::memcmp(p, "BW64", 4) == 0) {
+        if (std::memcmp(p + 8, "WAVE", 4) != 0) {
+            return invalid("RIFF file is not WAVE");
+        }
+        return probeWav(reader, std::memcmp(p, "RIFF", 4) != 0);
+    }
+    if (std::memcmp(p, "FORM", 4) == 0) {
+        if (std::memcmp(p + 8, "AIFF", 4) == 0 || std::memcmp(p + 8, "AIFC", 4) == 0) {
+            return probeAiff(reader, p[11] == 'C');
+        }
+        return unknown();  // 8SVX and friends
+    }
+    if (std::memcmp(p, "fLaC", 4) == 0) {
+        return probeFlac(reader, 0);
+    }
+    if (std::memcmp(p, "ID3", 3) == 0) {
+        // ID3v2 tag in front of FLAC (or MP3): syncsafe size, plus a footer when flagged
+        uint64_t tagSize = 10 + ((p[6] & 0x7F) << 21 | (p[7] & 0x7F) << 14 | (p[8] & 0x7F) << 7 | (p[9] & 0x7F));
+        if (p[5] & 0x10) {
+            tagSize += 10;
+        }
+        return probeFlac(reader, tagSize);
+    }
+
+    // Other containers libsndfile can open
+    static const char* const otherMagics[] = {"RIFX", "riff", "OggS", ".snd", "caff", "wvpk"};
+    for (const char* magic : otherMagics) {
+        if (std::memcmp(p, magic, 4) == 0) {
+            return unknown();
+        }
+    }
+    if (p[0] == 0xFF && (p[1] & 0xE0) == 0xE0) {
+        return unknown();  // MPEG audio frame sync
+    }
+    return invalid("unrecognized header");
+}
+}
+
+AudioProbe::Result AudioProbe::probe(const std::string& filepath) {
+    int fd = ::open(filepath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return invalid("cannot open file");
+    }
+
+    Result result;
+    struct stat st;
+    unsigned char buffer[HEADER_BYTES];
+    if (::fstat(fd, &st) != 0) {
+        result = invalid("cannot stat file");
+    } else {
+        uint64_t fileSize = static_cast<uint64_t>(st.st_size);
+        ssize_t got = ::pread(fd, buffer, static_cast<size_t>(std::min<uint64_t>(sizeof(buffer), fileSize)), 0);
+        if (got < 0) {
+            result = invalid("read failed");
+        } else {
+            result = probeHeader(HeaderReader{fd, buffer, static_cast<size_t>(got), fileSize});
+        }
+    }
+    ::close(fd);
+    return result;
+}
+
+AudioProbe::Result AudioProbe::probeBuffer(const unsigned char* data, size_t size, uint64_t fileSize) {
+    return probeHeader(HeaderReader{-1, data, size, std::max<uint64_t>(fileSize, size)});
+}
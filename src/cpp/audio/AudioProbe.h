@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+struct AudioInfo {
+    int sampleRate;
+    int channels;
+    int bitDepth;
+    size_t frameCount;
+    bool isStereo;
+    bool isPCM;
+};
+
+// Header-only inspection of WAV/RF64, AIFF/AIFC and FLAC files.
+//
+// One pread of the first few KB is usually enough (another follows only when
+// the format chunk sits behind large metadata), so validating a library costs
+// a single open per file instead of a full libsndfile open for every check.
+// Other containers (Ogg, MP3, RIFX, ...) and codecs the parser does not know
+// come back UNKNOWN and are left for libsndfile to decide.
+class AudioProbe {
+public:
+    enum Status {
+        VALID,    // Header parsed, info filled in
+        INVALID,  // Recognized container but corrupt or not decodable
+        UNKNOWN   // Not something the probe parses
+    };
+
+    struct Result {
+        Status status = UNKNOWN;
+        AudioInfo info{};
+        int format = 0;     // libsndfile SF_FORMAT_* container | subtype, as sf_open would report
+        std::string error;  // Why the file is INVALID
+
+        // Sample data location for WAV/AIFF (0 bytes for FLAC), clamped to the file
+        uint64_t dataOffset = 0;
+        uint64_t dataBytes = 0;
+        bool bigEndian = false;  // AIFF byte order (except AIFC 'sowt')
+    };
+
+    static constexpr size_t HEADER_BYTES = 4096;
+
+    static Result probe(const std::string& filepath);
+    // Parses a header already in memory; fileSize bounds chunk offsets
+    static Result probeBuffer(const unsigned char* data, size_t size, uint64_t fileSize);
+};
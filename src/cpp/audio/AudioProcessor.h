@@ -1,17 +1,13 @@
 #pragma once
 
+#include "AudioProbe.h"
+#include "SimdKernels.h"
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <memory>
 
-struct AudioInfo {
-    int sampleRate;
-    int channels;
-    int bitDepth;
-    size_t frameCount;
-    bool isStereo;
-    bool isPCM;
-};
+struct SF_INFO;
 
 class AudioProcessor {
 public:
@@ -22,11 +18,42 @@ public:
     bool loadAudioFile(const std::string& filepath, std::vector<float>& audioData, AudioInfo& info);
     bool saveAudioFile(const std::string& filepath, const std::vector<float>& audioData, const AudioInfo& info);
     
+    // Block size ConversionPipeline falls back to when configured with blockFrames = 0
+    static constexpr size_t DEFAULT_BLOCK_FRAMES = 65536;
+    void fillAudioInfo(const SF_INFO& sfInfo, AudioInfo& info);
+    
+    // Requantization to 16-bit. TPDF adds +-1 LSB triangular dither so the error is
+    // independent of the signal; SHAPED also feeds the error back through a 3-tap filter
+    // that moves the noise floor towards high frequencies (tuned for 44.1/48 kHz)
+    enum class DitherMode {
+        NONE,
+        TPDF,
+        SHAPED
+    };
+
+    // Carried across the blocks of one stream so dither and shaping stay continuous
+    struct DitherState {
+        explicit DitherState(uint64_t seed = 0);
+        uint32_t rng[SimdKernels::DITHER_LANES];
+        std::vector<float> error;  // Last shaping errors, 3 per channel
+    };
+
+    static const char* ditherModeName(DitherMode mode);
+    static bool parseDitherMode(const std::string& name, DitherMode& mode);
+
     // Format conversions
     bool convertToMono(const std::vector<float>& stereoData, std::vector<float>& monoData);
-    bool convertBitDepth(const std::vector<float>& inputData, std::vector<float>& outputData, int targetBitDepth);
+    // Snaps samples onto the target grid (16-bit only) so the float write in libsndfile is exact.
+    // inputData is interleaved; noise shaping filters each of its channels separately
+    bool convertBitDepth(const std::vector<float>& inputData, std::vector<float>& outputData, int targetBitDepth,
+                         DitherMode dither = DitherMode::TPDF, int channels = 1);
     bool convertToPCM(const std::string& inputFile, const std::string& outputFile);
     
+    // Float to 16-bit PCM with rounding and clipping, same scaling as libsndfile (SIMD-dispatched)
+    void convertTo16Bit(const float* input, short* output, size_t sampleCount);
+    void requantizeTo16Bit(const float* input, short* output, size_t frames, int channels,
+                           DitherMode mode, DitherState& state);
+    
     // Validation
     bool isValidAudioFile(const std::string& filepath);
     bool isPCMFormat(const std::string& filepath);
@@ -34,7 +61,11 @@ public:
     
     // Audio analysis
     float calculateRMS(const std::vector<float>& audioData);
+    float calculatePeak(const std::vector<float>& audioData);
     bool isSilent(const std::vector<float>& audioData, float threshold = 0.01f);
+    // Removes leading/trailing frames whose samples all stay below thresholdDb (dBFS),
+    // fading the kept audio in and out over fadeFrames; returns the number of frames removed
+    size_t trimSilence(std::vector<float>& audioData, int channels, float thresholdDb, size_t fadeFrames = 0);
     
     // Apple Silicon acceleration (macOS only)
     bool initializeAppleSilicon();
@@ -0,0 +1,823 @@
+#include "ConversionPipeline.h"
+#include "AudioFileReader.h"
+#include "ContentHash.h"
+#include "ConversionIndex.h"
+#include "FileOperations.h"
+#include "Logger.h"
+#include "Resampler.h"
+#include "SilenceTrimmer.h"
+#include "StageProfiler.h"
+#include "TraceRecorder.h"
+#include <sndfile.h>
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+
+namespace {
+size_t resolveThreadCount(size_t requested) {
+    if (requested > 0) {
+        return requested;
+    }
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+void storeMin(std::atomic<int64_t>& target, int64_t value) {
+    int64_t current = target.load();
+    while (value < current && !target.compare_exchange_weak(current, value)) {
+    }
+}
+
+void storeMax(std::atomic<int64_t>& target, int64_t value) {
+    int64_t current = target.load();
+    while (value > current && !target.compare_exchange_weak(current, value)) {
+    }
+}
+}
+
+struct ConversionPipeline::FileState {
+    ConversionJob job;
+    AudioInfo info{};
+    SNDFILE* output = nullptr;
+    FastPath fastPath = FastPath::NONE;  // Set by the reader before the first chunk is queued
+    bool failed = false;  // Only touched by the writer holding this file's turn
+    AudioProcessor::DitherState dither;   // Only touched by the transformer holding this file's turn
+    std::unique_ptr<SilenceTrimmer<float>> trimmer;     // Created by the reader, then used like dither
+    std::unique_ptr<SilenceTrimmer<short>> pcmTrimmer;  // Likewise, on the native PCM path
+    std::unique_ptr<Resampler> resampler;               // Likewise
+    int outputSampleRate = 0;
+    std::shared_ptr<DedupEntry> dedup;  // Set when this file is the one converted for its content
+    bool dedupChecked = false;          // Content already claimed (or not hashable)
+    // Time spent on this file per StageProfiler stage, recorded as one sample each when it completes.
+    // Each stage's entry is only touched by the thread working on that stage of the file
+    uint64_t stageNanos[StageProfiler::STAGE_COUNT] = {};
+
+    std::mutex mutex;
+    std::condition_variable turn;
+    size_t nextTransform = 0;
+    size_t nextWrite = 0;
+};
+
+struct ConversionPipeline::Chunk {
+    std::shared_ptr<FileState> file;
+    size_t sequence = 0;
+    size_t frames = 0;
+    bool last = false;
+    bool readFailed = false;
+    std::vector<float> samples;  // Decoded, interleaved
+    std::vector<short> pcm;      // Transformed output samples (or read directly for native PCM)
+    std::vector<float> scratch;  // Trimmer/resampler output, swapped with samples
+    std::vector<short> pcmScratch;  // Same for pcm
+};
+
+// Guarded by the owning shard's mutex
+struct ConversionPipeline::DedupEntry {
+    uint64_t hash = 0;
+    size_t shard = 0;
+    std::string inputPath;
+    std::string outputPath;
+    bool done = false;         // Primary's output is complete; fields above no longer change
+    uint64_t outputBytes = 0;
+    std::vector<std::string> duplicates;
+    std::vector<std::shared_ptr<FileState>> waiting;  // Duplicates seen while the primary was in flight
+};
+
+ConversionPipeline::ConversionPipeline(AudioProcessor& audioProcessor, const Config& config, CompletionCallback onComplete)
+    : m_audioProcessor(audioProcessor),
+      m_config(config),
+      m_onComplete(std::move(onComplete)),
+      m_readers(resolveThreadCount(config.readerThreads), "read"),
+      m_transformQueue(config.queueDepth),
+      m_writeQueue(config.queueDepth) {
+    if (m_config.blockFrames == 0) {
+        m_config.blockFrames = AudioProcessor::DEFAULT_BLOCK_FRAMES;
+    }
+    m_config.readerThreads = m_readers.getThreadCount();
+    m_config.transformThreads = resolveThreadCount(config.transformThreads);
+    m_config.writerThreads = std::max<size_t>(config.writerThreads, 1);
+
+    for (size_t i = 0; i < m_config.transformThreads; ++i) {
+        m_transformThreads.emplace_back([this, i] {
+            TraceRecorder::getInstance().setThreadName("transform " + std::to_string(i));
+            transformLoop();
+        });
+    }
+    for (size_t i = 0; i < m_config.writerThreads; ++i) {
+        m_writerThreads.emplace_back([this, i] {
+            TraceRecorder::getInstance().setThreadName("write " + std::to_string(i));
+            writeLoop();
+        });
+    }
+
+    Logger::getInstance().debug("ConversionPipeline started: " + std::to_string(m_config.readerThreads) + " readers, " +
+                                std::to_string(m_config.transformThreads) + " transformers, " +
+                                std::to_string(m_config.writerThreads) + " writers");
+}
+
+ConversionPipeline::~ConversionPipeline() {
+    finish();
+}
+
+void ConversionPipeline::submit(const ConversionJob& job) {
+    auto file = std::make_shared<FileState>();
+    file->job = job;
+    // Seeded from the path so re-running a conversion reproduces the same output
+    file->dither = AudioProcessor::DitherState(std::hash<std::string>()(job.inputPath));
+
+    {
+        std::lock_guard<std::mutex> lock(m_completionMutex);
+        m_pendingJobs++;
+    }
+    m_submittedJobs++;
+
+    size_t queued = m_queuedJobs.fetch_add(1) + 1;
+    size_t maxQueued = m_maxQueuedJobs.load();
+    while (queued > maxQueued && !m_maxQueuedJobs.compare_exchange_weak(maxQueued, queued)) {
+    }
+
+    scheduleRead(file);
+}
+
+void ConversionPipeline::scheduleRead(const std::shared_ptr<FileState>& file) {
+    m_readers.enqueuePrioritized(file->job.cost, [this, file] {
+        auto start = std::chrono::steady_clock::now();
+        {
+            TraceRecorder::Span span("read", "pipeline", file->job.inputPath, file->job.probe.dataBytes);
+            readFile(file);
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        int64_t startNs = std::chrono::duration_cast<std::chrono::nanoseconds>(start - m_created).count();
+        int64_t endNs = std::chrono::duration_cast<std::chrono::nanoseconds>(end - m_created).count();
+        m_readJobs++;
+        m_readBusy += endNs - startNs;
+        storeMin(m_firstReadStart, startNs);
+        storeMax(m_lastReadEnd, endNs);
+        storeMax(m_longestRead, endNs - startNs);
+    });
+}
+
+void ConversionPipeline::waitIdle() {
+    std::unique_lock<std::mutex> lock(m_completionMutex);
+    m_completionCondition.wait(lock, [this] { return m_pendingJobs == 0; });
+}
+
+void ConversionPipeline::finish() {
+    {
+        std::unique_lock<std::mutex> lock(m_completionMutex);
+        if (m_finished) {
+            return;
+        }
+        m_completionCondition.wait(lock, [this] { return m_pendingJobs == 0; });
+        m_finished = true;
+    }
+
+    m_readers.shutdown();
+    m_transformQueue.close();
+    m_writeQueue.close();
+
+    for (auto& thread : m_transformThreads) {
+        thread.join();
+    }
+    for (auto& thread : m_writerThreads) {
+        thread.join();
+    }
+}
+
+std::vector<ConversionPipeline::StageStats> ConversionPipeline::getStageStats() const {
+    std::vector<StageStats> stats;
+
+    StageStats read;
+    read.name = "read";
+    read.threads = m_config.readerThreads;
+    read.maxDepth = m_maxQueuedJobs.load();
+    read.items = m_submittedJobs.load();
+    stats.push_back(read);
+
+    auto fromQueue = [](const std::string& name, size_t threads, const BoundedQueue<ChunkPtr>::Stats& queueStats) {
+        StageStats stage;
+        stage.name = name;
+        stage.threads = threads;
+        stage.capacity = queueStats.capacity;
+        stage.maxDepth = queueStats.maxDepth;
+        stage.items = queueStats.pushed;
+        stage.producerStallSeconds = queueStats.producerStallSeconds;
+        stage.consumerStallSeconds = queueStats.consumerStallSeconds;
+        return stage;
+    };
+    stats.push_back(fromQueue("transform", m_config.transformThreads, m_transformQueue.getStats()));
+    stats.push_back(fromQueue("write", m_config.writerThreads, m_writeQueue.getStats()));
+
+    return stats;
+}
+
+ConversionPipeline::ScheduleStats ConversionPipeline::getScheduleStats() const {
+    ScheduleStats stats;
+    stats.jobs = m_readJobs.load();
+    if (stats.jobs == 0) {
+        return stats;
+    }
+    stats.makespanSeconds = (m_lastReadEnd.load() - m_firstReadStart.load()) / 1e9;
+    stats.busySeconds = m_readBusy.load() / 1e9;
+    stats.longestJobSeconds = m_longestRead.load() / 1e9;
+    stats.idealSeconds = std::max(stats.busySeconds / m_config.readerThreads, stats.longestJobSeconds);
+    return stats;
+}
+
+std::vector<ConversionPipeline::DuplicateGroup> ConversionPipeline::getDuplicateGroups() const {
+    std::vector<DuplicateGroup> groups;
+    for (const DedupShard& shard : m_dedupShards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (const auto& [hash, entry] : shard.entries) {
+            if (!entry->duplicates.empty()) {
+                groups.push_back({entry->inputPath, entry->duplicates});
+            }
+        }
+    }
+    std::sort(groups.begin(), groups.end(),
+              [](const DuplicateGroup& a, const DuplicateGroup& b) { return a.primary < b.primary; });
+    return groups;
+}
+
+const char* ConversionPipeline::dedupModeName(DedupMode mode) {
+    switch (mode) {
+        case DedupMode::REPORT:
+            return "report";
+        case DedupMode::SKIP:
+            return "skip";
+        case DedupMode::LINK:
+            return "link";
+        default:
+            return "none";
+    }
+}
+
+bool ConversionPipeline::parseDedupMode(const std::string& name, DedupMode& mode) {
+    for (DedupMode candidate : {DedupMode::NONE, DedupMode::REPORT, DedupMode::SKIP, DedupMode::LINK}) {
+        if (name == dedupModeName(candidate)) {
+            mode = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+ConversionPipeline::FastPath ConversionPipeline::plannedFastPath(const AudioProbe::Result& probe, const Config& config) {
+    bool needsResample = config.targetSampleRate > 0 && probe.info.sampleRate > config.targetSampleRate;
+    if (!config.nativeFastPath || probe.status != AudioProbe::VALID || needsResample ||
+        (probe.format & SF_FORMAT_SUBMASK) != SF_FORMAT_PCM_16) {
+        return FastPath::NONE;
+    }
+    if (probe.format == (SF_FORMAT_WAV | SF_FORMAT_PCM_16) && !config.trimSilence) {
+        return FastPath::COPY;
+    }
+    return FastPath::NATIVE_PCM;
+}
+
+uint64_t ConversionPipeline::estimateOutputBytes(const AudioProbe::Result& probe, uint64_t sourceBytes,
+                                                 const Config& config) {
+    if (plannedFastPath(probe, config) == FastPath::COPY || probe.status != AudioProbe::VALID) {
+        return sourceBytes;
+    }
+
+    // 16-bit samples behind a canonical 44-byte WAV header (before any silence trimming)
+    double frames = static_cast<double>(probe.info.frameCount);
+    if (config.targetSampleRate > 0 && probe.info.sampleRate > config.targetSampleRate) {
+        frames = frames * config.targetSampleRate / probe.info.sampleRate;
+    }
+    return 44 + static_cast<uint64_t>(std::ceil(frames)) * static_cast<uint64_t>(probe.info.channels) * 2;
+}
+
+double ConversionPipeline::estimateCost(const AudioProbe::Result& probe, uint64_t sourceBytes, const Config& config) {
+    // Converting costs about the same per sample whatever the width (roughly 20 ns on one
+    // reader for 16/24-bit, a little less for float), so per source byte it scales with
+    // 3 / bytes per sample. Copies are I/O only; compressed sources pay for decoding
+    double factor = 2.0;  // Left to libsndfile, possibly a compressed codec
+    if (probe.status == AudioProbe::VALID) {
+        FastPath path = plannedFastPath(probe, config);
+        if (path == FastPath::COPY) {
+            factor = 0.1;
+        } else if ((probe.format & SF_FORMAT_TYPEMASK) == SF_FORMAT_FLAC) {
+            factor = 3.0;
+        } else {
+            factor = 3.0 / std::max(1, probe.info.bitDepth / 8);
+        }
+
+        if (config.targetSampleRate > 0 && probe.info.sampleRate > config.targetSampleRate) {
+            factor *= 1.5;
+        }
+    }
+    return static_cast<double>(sourceBytes) * factor;
+}
+
+const char* ConversionPipeline::fastPathName(FastPath fastPath) {
+    switch (fastPath) {
+        case FastPath::NATIVE_PCM:
+            return "native-pcm";
+        case FastPath::COPY:
+            return "copy";
+        case FastPath::DUPLICATE:
+            return "duplicate";
+        default:
+            return "convert";
+    }
+}
+
+void ConversionPipeline::readFile(const std::shared_ptr<FileState>& file) {
+    m_queuedJobs--;
+
+    const std::string& inputPath = file->job.inputPath;
+    size_t sequence = 0;
+    bool failed = false;
+    AudioFileReader input;
+
+    if (m_config.dedup != DedupMode::NONE && !file->dedupChecked) {
+        file->dedupChecked = true;
+        // Hashed from the pages the decode below reads anyway, so the mapping is faulted in once
+        if (input.open(inputPath, m_config.memoryMap)) {
+            const SF_INFO& sfInfo = input.getInfo();
+            m_audioProcessor.fillAudioInfo(sfInfo, file->info);
+
+            uint64_t hash = input.contentHash();
+            if (hash == 0) {
+                hash = ConversionIndex::hashFile(inputPath);
+            }
+            // Identical bytes in a different layout are different audio
+            hash = ContentHash::combine(hash, static_cast<uint64_t>(sfInfo.format));
+            hash = ContentHash::combine(hash, static_cast<uint64_t>(sfInfo.channels));
+            hash = ContentHash::combine(hash, static_cast<uint64_t>(sfInfo.samplerate));
+            file->job.audioHash = hash;
+            if (!claimContent(file, hash)) {
+                return;
+            }
+        }
+    }
+
+    // A probed plain 16-bit WAV is copied without ever being opened by libsndfile
+    const AudioProbe::Result& probe = file->job.probe;
+    if (!input.isOpen() && plannedFastPath(probe, m_config) == FastPath::COPY) {
+        file->info = probe.info;
+        copyFile(file);
+        return;
+    }
+
+    try {
+        bool opened = input.isOpen();
+        if (!opened) {
+            StageProfiler::Timer timer(file->stageNanos[StageProfiler::DECODE]);
+            opened = input.open(inputPath, m_config.memoryMap);
+        }
+        if (!opened) {
+            Logger::getInstance().error("Failed to open audio file: " + inputPath);
+            failed = true;
+        } else {
+            const SF_INFO& sfInfo = input.getInfo();
+            m_audioProcessor.fillAudioInfo(sfInfo, file->info);
+
+            file->outputSampleRate = sfInfo.samplerate;
+            if (m_config.targetSampleRate > 0 && sfInfo.samplerate > m_config.targetSampleRate) {
+                file->resampler = std::make_unique<Resampler>(sfInfo.samplerate, m_config.targetSampleRate, sfInfo.channels);
+                file->outputSampleRate = m_config.targetSampleRate;
+            }
+
+            if (m_config.nativeFastPath && !file->resampler && (sfInfo.format & SF_FORMAT_SUBMASK) == SF_FORMAT_PCM_16) {
+                if ((sfInfo.format & SF_FORMAT_TYPEMASK) == SF_FORMAT_WAV && !m_config.trimSilence) {
+                    // Already an M8-ready 16-bit WAV: nothing to decode
+                    input.close();
+                    copyFile(file);
+                    return;
+                }
+                file->fastPath = FastPath::NATIVE_PCM;
+            }
+            const bool nativePcm = file->fastPath == FastPath::NATIVE_PCM;
+
+            if (m_config.trimSilence) {
+                auto fadeFrames = static_cast<size_t>(std::lround(m_config.trimFadeMs * sfInfo.samplerate / 1000.0));
+                if (nativePcm) {
+                    file->pcmTrimmer = std::make_unique<SilenceTrimmer<short>>(sfInfo.channels, m_config.trimThresholdDb, fadeFrames);
+                } else {
+                    file->trimmer = std::make_unique<SilenceTrimmer<float>>(sfInfo.channels, m_config.trimThresholdDb, fadeFrames);
+                }
+            }
+
+            const size_t channels = static_cast<size_t>(sfInfo.channels);
+            sf_count_t framesRead = 0;
+
+            while (true) {
+                ChunkPtr chunk = acquireChunk();
+                sf_count_t count;
+                {
+                    StageProfiler::Timer timer(file->stageNanos[StageProfiler::DECODE]);
+                    if (nativePcm) {
+                        chunk->pcm.resize(m_config.blockFrames * channels);
+                        count = input.readShort(chunk->pcm.data(), m_config.blockFrames);
+                    } else {
+                        chunk->samples.resize(m_config.blockFrames * channels);
+                        count = input.readFloat(chunk->samples.data(), m_config.blockFrames);
+                    }
+                }
+                if (count < 0) {
+                    count = 0;
+                }
+                framesRead += count;
+
+                chunk->file = file;
+                chunk->sequence = sequence;
+                chunk->frames = static_cast<size_t>(count);
+                chunk->last = count < static_cast<sf_count_t>(m_config.blockFrames) || framesRead >= sfInfo.frames;
+
+                bool last = chunk->last;
+                if (!m_transformQueue.push(std::move(chunk))) {
+                    // Pipeline is shutting down
+                    return;
+                }
+                sequence++;
+
+                if (last) {
+                    break;
+                }
+            }
+
+            if (framesRead != sfInfo.frames) {
+                Logger::getInstance().warning("Did not read all frames from: " + inputPath);
+            }
+        }
+    } catch (const std::exception& e) {
+        Logger::getInstance().error("Error reading file " + inputPath + ": " + std::string(e.what()));
+        failed = true;
+    }
+
+    input.close();
+
+    if (failed) {
+        // Terminal chunk so the writer stage completes the job in order
+        ChunkPtr chunk = acquireChunk();
+        chunk->file = file;
+        chunk->sequence = sequence;
+        chunk->last = true;
+        chunk->readFailed = true;
+        m_transformQueue.push(std::move(chunk));
+    }
+}
+
+void ConversionPipeline::copyFile(const std::shared_ptr<FileState>& file) {
+    file->fastPath = FastPath::COPY;
+    const std::string& outputPath = file->job.outputPath;
+
+    try {
+        {
+            StageProfiler::Timer timer(file->stageNanos[StageProfiler::MKDIR]);
+            std::filesystem::create_directories(std::filesystem::path(outputPath).parent_path());
+        }
+        StageProfiler::Timer timer(file->stageNanos[StageProfiler::COPY]);
+        file->failed = !FileOperations::cloneFile(file->job.inputPath, outputPath);
+    } catch (const std::exception& e) {
+        Logger::getInstance().error("Error copying file " + file->job.inputPath + ": " + std::string(e.what()));
+        file->failed = true;
+    }
+
+    if (file->failed) {
+        std::error_code ec;
+        std::filesystem::remove(outputPath, ec);
+    }
+
+    // No chunks were queued, so the job completes right here
+    completeJob(file);
+}
+
+void ConversionPipeline::transformLoop() {
+    ChunkPtr chunk;
+    while (m_transformQueue.pop(chunk)) {
+        std::shared_ptr<FileState> file = chunk->file;
+        waitTurn(*file, file->nextTransform, chunk->sequence);
+        {
+            StageProfiler::Timer timer(file->stageNanos[StageProfiler::TRANSFORM]);
+            TraceRecorder::Span span("transform", "pipeline", file->job.inputPath);
+
+            if (file->trimmer) {
+                chunk->scratch.clear();
+                file->trimmer->process(chunk->samples.data(), chunk->frames, chunk->scratch);
+                if (chunk->last) {
+                    file->trimmer->flush(chunk->scratch);
+                }
+                chunk->samples.swap(chunk->scratch);
+                chunk->frames = chunk->samples.size() / static_cast<size_t>(file->info.channels);
+            } else if (file->pcmTrimmer) {
+                chunk->pcmScratch.clear();
+                file->pcmTrimmer->process(chunk->pcm.data(), chunk->frames, chunk->pcmScratch);
+                if (chunk->last) {
+                    file->pcmTrimmer->flush(chunk->pcmScratch);
+                }
+                chunk->pcm.swap(chunk->pcmScratch);
+                chunk->frames = chunk->pcm.size() / static_cast<size_t>(file->info.channels);
+            }
+
+            if (file->resampler) {
+                chunk->scratch.clear();
+                file->resampler->process(chunk->samples.data(), chunk->frames, chunk->scratch);
+                if (chunk->last) {
+                    file->resampler->flush(chunk->scratch);
+                }
+                chunk->samples.swap(chunk->scratch);
+                chunk->frames = chunk->samples.size() / static_cast<size_t>(file->info.channels);
+            }
+
+            if (file->fastPath == FastPath::NONE) {
+                // Sources at 16 bits or below are already on the output grid unless resampled or faded
+                bool faded = file->trimmer && file->trimmer->getFadeFrames() > 0;
+                bool offGrid = file->info.bitDepth > 16 || file->resampler || faded;
+                auto dither = offGrid ? m_config.dither : AudioProcessor::DitherMode::NONE;
+                chunk->pcm.resize(chunk->frames * static_cast<size_t>(file->info.channels));
+                m_audioProcessor.requantizeTo16Bit(chunk->samples.data(), chunk->pcm.data(), chunk->frames,
+                                                   file->info.channels, dither, file->dither);
+            }
+            span.setBytes(chunk->frames * static_cast<size_t>(file->info.channels) * sizeof(short));
+        }
+
+        // Hand off before passing the turn so the write queue sees this file's chunks in order
+        m_writeQueue.push(std::move(chunk));
+        advanceTurn(*file, file->nextTransform);
+    }
+}
+
+void ConversionPipeline::writeLoop() {
+    ChunkPtr chunk;
+    while (m_writeQueue.pop(chunk)) {
+        std::shared_ptr<FileState> file = chunk->file;
+        waitTurn(*file, file->nextWrite, chunk->sequence);
+
+        {
+            TraceRecorder::Span span("write", "pipeline", file->job.outputPath,
+                                     chunk->frames * static_cast<size_t>(file->info.channels) * sizeof(short));
+            writeChunk(*file, *chunk);
+        }
+        bool last = chunk->last;
+        releaseChunk(std::move(chunk));
+        advanceTurn(*file, file->nextWrite);
+
+        if (last) {
+            completeJob(file);
+        }
+    }
+}
+
+void ConversionPipeline::writeChunk(FileState& file, const Chunk& chunk) {
+    const std::string& outputPath = file.job.outputPath;
+
+    if (chunk.readFailed) {
+        file.failed = true;
+    }
+
+    try {
+        if (!file.failed && !file.output) {
+            {
+                // Create output directory if it doesn't exist
+                StageProfiler::Timer timer(file.stageNanos[StageProfiler::MKDIR]);
+                std::filesystem::create_directories(std::filesystem::path(outputPath).parent_path());
+            }
+
+            StageProfiler::Timer timer(file.stageNanos[StageProfiler::ENCODE]);
+            SF_INFO sfInfo;
+            sfInfo.samplerate = file.outputSampleRate;
+            sfInfo.channels = file.info.channels;
+            sfInfo.format = SF_FORMAT_WAV | SF_FORMAT_PCM_16; // Always save as 16-bit WAV
+
+            // Unlinked first: an output hard-linked by --dedup link must not rewrite its other names
+            std::error_code ec;
+            std::filesystem::remove(outputPath, ec);
+            file.output = sf_open(outputPath.c_str(), SFM_WRITE, &sfInfo);
+            if (!file.output) {
+                Logger::getInstance().error("Failed to create audio file: " + outputPath);
+                file.failed = true;
+            }
+        }
+
+        if (!file.failed && chunk.frames > 0) {
+            StageProfiler::Timer timer(file.stageNanos[StageProfiler::ENCODE]);
+            sf_count_t written = sf_writef_short(file.output, chunk.pcm.data(), static_cast<sf_count_t>(chunk.frames));
+            if (written != static_cast<sf_count_t>(chunk.frames)) {
+                Logger::getInstance().warning("Did not write all frames to: " + outputPath);
+                file.failed = true;
+            }
+        }
+    } catch (const std::exception& e) {
+        Logger::getInstance().error("Error writing file " + outputPath + ": " + std::string(e.what()));
+        file.failed = true;
+    }
+
+    if (chunk.last && file.output) {
+        {
+            StageProfiler::Timer timer(file.stageNanos[StageProfiler::CLOSE]);
+            sf_close(file.output);
+        }
+        file.output = nullptr;
+
+        if (file.failed) {
+            // Don't leave truncated files behind
+            std::error_code ec;
+            std::filesystem::remove(outputPath, ec);
+        }
+    }
+}
+
+void ConversionPipeline::addConvertedContent(uint64_t audioHash, const std::string& sourcePath,
+                                             const std::string& outputPath) {
+    if (m_config.dedup == DedupMode::NONE || audioHash == 0) {
+        return;
+    }
+    std::error_code ec;
+    uintmax_t size = std::filesystem::file_size(outputPath, ec);
+    if (ec) {
+        return;
+    }
+
+    size_t index = static_cast<size_t>(audioHash % kDedupShards);
+    DedupShard& shard = m_dedupShards[index];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    std::shared_ptr<DedupEntry>& slot = shard.entries[audioHash];
+    if (!slot) {
+        slot = std::make_shared<DedupEntry>();
+        slot->hash = audioHash;
+        slot->shard = index;
+        slot->inputPath = sourcePath;
+        slot->outputPath = outputPath;
+        slot->done = true;
+        slot->outputBytes = static_cast<uint64_t>(size);
+    }
+}
+
+bool ConversionPipeline::claimContent(const std::shared_ptr<FileState>& file, uint64_t hash) {
+    std::shared_ptr<DedupEntry> entry;
+    {
+        size_t index = static_cast<size_t>(hash % kDedupShards);
+        DedupShard& shard = m_dedupShards[index];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        std::shared_ptr<DedupEntry>& slot = shard.entries[hash];
+        if (!slot) {
+            slot = std::make_shared<DedupEntry>();
+            slot->hash = hash;
+            slot->shard = index;
+            slot->inputPath = file->job.inputPath;
+            slot->outputPath = file->job.outputPath;
+            file->dedup = slot;
+            return true;
+        }
+        if (m_config.dedup == DedupMode::REPORT) {
+            slot->duplicates.push_back(file->job.inputPath);
+            m_duplicateFiles++;
+            return true;
+        }
+        if (!slot->done) {
+            // The primary's completeJob picks this file up
+            slot->waiting.push_back(file);
+            return false;
+        }
+        entry = slot;
+    }
+
+    resolveDuplicate(file, *entry);
+    return false;
+}
+
+void ConversionPipeline::resolveDuplicate(const std::shared_ptr<FileState>& file, DedupEntry& primary) {
+    file->fastPath = FastPath::DUPLICATE;
+    const std::string& outputPath = file->job.outputPath;
+    bool saved = true;
+
+    if (m_config.dedup == DedupMode::LINK && outputPath != primary.outputPath) {
+        try {
+            std::filesystem::create_directories(std::filesystem::path(outputPath).parent_path());
+            std::error_code ec;
+            std::filesystem::remove(outputPath, ec);
+            std::filesystem::create_hard_link(primary.outputPath, outputPath, ec);
+            if (ec) {
+                // Across filesystems: fall back to a (possibly reflinked) copy
+                saved = false;
+                file->failed = !FileOperations::cloneFile(primary.outputPath, outputPath);
+            }
+        } catch (const std::exception& e) {
+            Logger::getInstance().error("Error linking duplicate " + outputPath + ": " + std::string(e.what()));
+            file->failed = true;
+        }
+    }
+
+    if (!file->failed) {
+        {
+            std::lock_guard<std::mutex> lock(m_dedupShards[primary.shard].mutex);
+            primary.duplicates.push_back(file->job.inputPath);
+        }
+        m_duplicateFiles++;
+        if (saved) {
+            m_dedupBytesSaved += primary.outputBytes;
+        }
+    }
+
+    completeJob(file);
+}
+
+void ConversionPipeline::completeJob(const std::shared_ptr<FileState>& file) {
+    if (file->dedup && m_config.dedup != DedupMode::REPORT) {
+        std::shared_ptr<DedupEntry> entry = file->dedup;
+        std::vector<std::shared_ptr<FileState>> waiting;
+        std::shared_ptr<FileState> promoted;
+        {
+            DedupShard& shard = m_dedupShards[entry->shard];
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            if (file->failed && entry->waiting.empty()) {
+                // Nobody is waiting, so the next source with this content starts over
+                shard.entries.erase(entry->hash);
+            } else if (file->failed) {
+                // The next duplicate in line is converted in its place
+                promoted = entry->waiting.front();
+                entry->waiting.erase(entry->waiting.begin());
+                entry->inputPath = promoted->job.inputPath;
+                entry->outputPath = promoted->job.outputPath;
+                promoted->dedup = entry;
+            } else {
+                std::error_code ec;
+                uintmax_t size = std::filesystem::file_size(entry->outputPath, ec);
+                entry->outputBytes = ec ? 0 : static_cast<uint64_t>(size);
+                entry->done = true;
+                waiting.swap(entry->waiting);
+            }
+        }
+
+        if (promoted) {
+            m_queuedJobs++;
+            scheduleRead(promoted);
+        }
+        for (const auto& duplicate : waiting) {
+            resolveDuplicate(duplicate, *entry);
+        }
+    }
+
+    if ((file->trimmer || file->pcmTrimmer) && !file->failed) {
+        uint64_t removed = file->trimmer ? file->trimmer->getInputFrames() - file->trimmer->getOutputFrames()
+                                         : file->pcmTrimmer->getInputFrames() - file->pcmTrimmer->getOutputFrames();
+        if (removed > 0) {
+            // Counted at the output rate, 2 bytes per sample
+            if (file->resampler) {
+                removed = Resampler::outputFrames(removed, file->info.sampleRate, file->outputSampleRate);
+            }
+            m_trimmedFiles++;
+            m_trimmedBytes += removed * static_cast<uint64_t>(file->info.channels) * sizeof(short);
+        }
+    }
+
+    StageProfiler& profiler = StageProfiler::getInstance();
+    for (int stage = 0; stage < StageProfiler::STAGE_COUNT; stage++) {
+        if (file->stageNanos[stage] > 0) {
+            profiler.record(static_cast<StageProfiler::Stage>(stage), file->stageNanos[stage]);
+        }
+    }
+
+    if (m_onComplete) {
+        m_onComplete(file->job, !file->failed, file->info, file->fastPath);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_completionMutex);
+        m_pendingJobs--;
+    }
+    m_completionCondition.notify_all();
+}
+
+ConversionPipeline::ChunkPtr ConversionPipeline::acquireChunk() {
+    {
+        std::lock_guard<std::mutex> lock(m_freeChunksMutex);
+        if (!m_freeChunks.empty()) {
+            ChunkPtr chunk = std::move(m_freeChunks.back());
+            m_freeChunks.pop_back();
+            return chunk;
+        }
+    }
+    return std::make_unique<Chunk>();
+}
+
+void ConversionPipeline::releaseChunk(ChunkPtr chunk) {
+    chunk->file.reset();
+    chunk->sequence = 0;
+    chunk->frames = 0;
+    chunk->last = false;
+    chunk->readFailed = false;
+
+    std::lock_guard<std::mutex> lock(m_freeChunksMutex);
+    m_freeChunks.push_back(std::move(chunk));
+}
+
+void ConversionPipeline::waitTurn(FileState& file, size_t& counter, size_t sequence) {
+    std::unique_lock<std::mutex> lock(file.mutex);
+    if (counter != sequence) {
+        // An earlier chunk of this file is still with another thread
+        TraceRecorder::Span span("wait turn", "wait", file.job.inputPath);
+        file.turn.wait(lock, [&counter, sequence] { return counter == sequence; });
+    }
+}
+
+void ConversionPipeline::advanceTurn(FileState& file, size_t& counter) {
+    {
+        std::lock_guard<std::mutex> lock(file.mutex);
+        counter++;
+    }
+    file.turn.notify_all();
+}
@@ -0,0 +1,243 @@
+#pragma once
+
+#include "AudioProcessor.h"
+#include "BoundedQueue.h"
+#include "ThreadPool.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+struct ConversionJob {
+    std::string inputPath;
+    std::string outputPath;
+    AudioProbe::Result probe{};  // Scanner's header probe, UNKNOWN when not probed
+    double cost = 0.0;           // Estimated work (see ConversionPipeline::estimateCost); costlier jobs are read first
+    uint64_t audioHash = 0;      // Set by the pipeline when deduplicating: the key the source's audio was matched on
+};
+
+// Three-stage conversion pipeline: decode -> transform -> encode.
+//
+// Reader threads decode source files into fixed-size chunks, a CPU transform
+// pool converts each chunk to the output sample format, and writer threads
+// create output directories and encode. Stages are connected by bounded queues,
+// so a slow stage stalls the one feeding it instead of letting decoded audio
+// pile up in memory, and each stage can be sized independently.
+//
+// Sources that are already 16-bit PCM bypass float conversion entirely.
+// Sources above Config::targetSampleRate are resampled on the way through,
+// after silence trimming when that is enabled.
+//
+// Jobs wait for a reader in a priority queue ordered by ConversionJob::cost, so
+// when there is a backlog the longest conversions start first (LPT scheduling)
+// and the batch does not end with one big file decoding while the other
+// readers sit idle.
+//
+// Chunks of the same file pass through the transform and write stages strictly
+// in order, so per-file state in those stages never sees chunks out of sequence.
+//
+// With deduplication on, readers hash each source's samples from the mapped
+// pages just before decoding and claim the hash in a table shared by all
+// readers. The first claimant is converted; later ones wait (off the reader
+// threads) for it to finish and are then linked to its output, skipped, or only
+// reported, without being decoded at all.
+class ConversionPipeline {
+public:
+    // What happens to a source whose audio matches one already converted in this run
+    enum class DedupMode {
+        NONE,    // Convert every source
+        REPORT,  // Convert every source, but record the duplicate groups
+        SKIP,    // Write nothing for the duplicate
+        LINK     // Hard-link the duplicate's output to the first copy's output
+    };
+
+    struct Config {
+        size_t readerThreads = 0;     // 0 = hardware_concurrency
+        size_t transformThreads = 0;  // 0 = hardware_concurrency
+        size_t writerThreads = 2;
+        size_t queueDepth = 32;       // Chunks per stage queue
+        size_t blockFrames = 16384;   // Frames per chunk
+
+        // 16-bit PCM sources skip the float round-trip: plain WAVs are copied
+        // (reflink where the filesystem supports it), other containers are
+        // rewritten with sf_readf_short/sf_writef_short
+        bool nativeFastPath = true;
+
+        // Requantization of sources deeper than 16 bits (and of resampled ones)
+        AudioProcessor::DitherMode dither = AudioProcessor::DitherMode::TPDF;
+
+        // Sources above this rate are resampled down to it in the transform stage (0 = keep every rate)
+        int targetSampleRate = 0;
+
+        // Read sources through a memory mapping (see AudioFileReader) instead of libsndfile's buffered read()
+        bool memoryMap = true;
+
+        // Drop leading/trailing frames below the threshold (see SilenceTrimmer). 16-bit
+        // WAVs are then rewritten on the native PCM path instead of being copied
+        bool trimSilence = false;
+        float trimThresholdDb = -60.0f;
+        double trimFadeMs = 0.0;
+
+        DedupMode dedup = DedupMode::NONE;
+    };
+
+    // How a job's output was produced
+    enum class FastPath {
+        NONE,        // Decoded to float and converted
+        NATIVE_PCM,  // Container rewritten from 16-bit samples
+        COPY,        // Source file copied as-is
+        DUPLICATE    // Same audio as another source; linked or skipped per Config::dedup
+    };
+
+    // Sources with identical audio, in completion order of the duplicates
+    struct DuplicateGroup {
+        std::string primary;  // The source that was converted
+        std::vector<std::string> duplicates;
+    };
+
+    struct StageStats {
+        std::string name;
+        size_t threads = 0;
+        size_t capacity = 0;   // 0 = unbounded
+        size_t maxDepth = 0;
+        size_t items = 0;
+        double producerStallSeconds = 0.0;  // Upstream blocked because this stage's queue was full
+        double consumerStallSeconds = 0.0;  // This stage idle because its queue was empty
+    };
+
+    // How well the reader stage was packed. A job occupies a reader from the start of its
+    // read until its last chunk is queued (or it was copied); no schedule of the same jobs
+    // on the same readers can finish before idealSeconds
+    struct ScheduleStats {
+        size_t jobs = 0;
+        double makespanSeconds = 0.0;    // First read started to last read finished
+        double busySeconds = 0.0;        // Sum over jobs
+        double longestJobSeconds = 0.0;
+        double idealSeconds = 0.0;       // max(busy / readers, longest job)
+    };
+
+    // Invoked on a writer thread (a reader thread for copied files) once a job's output is closed or the job failed
+    using CompletionCallback = std::function<void(const ConversionJob& job, bool success, const AudioInfo& info, FastPath fastPath)>;
+
+    ConversionPipeline(AudioProcessor& audioProcessor, const Config& config, CompletionCallback onComplete);
+    ~ConversionPipeline();
+
+    ConversionPipeline(const ConversionPipeline&) = delete;
+    ConversionPipeline& operator=(const ConversionPipeline&) = delete;
+
+    // Audio an earlier run already converted from sourcePath to outputPath: sources with the same
+    // audioHash are handled as its duplicates. Call before submitting; ignored without dedup
+    void addConvertedContent(uint64_t audioHash, const std::string& sourcePath, const std::string& outputPath);
+
+    void submit(const ConversionJob& job);
+
+    // Blocks until every job submitted so far has completed; the stages keep running for more
+    void waitIdle();
+
+    // Blocks until every submitted job has completed, then stops all stages
+    void finish();
+
+    std::vector<StageStats> getStageStats() const;
+    ScheduleStats getScheduleStats() const;
+
+    // Successful outputs that silence trimming made shorter, and the 16-bit output bytes it saved
+    size_t getTrimmedFiles() const { return m_trimmedFiles.load(); }
+    uint64_t getTrimmedBytes() const { return m_trimmedBytes.load(); }
+
+    // Sources found to duplicate another one, and the output bytes not written for them
+    // (in REPORT mode nothing is saved, so only the count is kept)
+    size_t getDuplicateFiles() const { return m_duplicateFiles.load(); }
+    uint64_t getDedupBytesSaved() const { return m_dedupBytesSaved.load(); }
+    // Valid after finish()
+    std::vector<DuplicateGroup> getDuplicateGroups() const;
+
+    static const char* dedupModeName(DedupMode mode);
+    static bool parseDedupMode(const std::string& name, DedupMode& mode);
+
+    // The path readFile will take for a source with this header probe (NONE when the
+    // probe cannot tell; the reader then decides from the opened file)
+    static FastPath plannedFastPath(const AudioProbe::Result& probe, const Config& config);
+    // Output file size for a source of sourceBytes, exact for COPY and from the probed frame count otherwise
+    static uint64_t estimateOutputBytes(const AudioProbe::Result& probe, uint64_t sourceBytes, const Config& config);
+    // Relative conversion time: source bytes weighted by how expensive the source's codec is to
+    // decode (and whether it is resampled), in units of a 24-bit PCM source byte
+    static double estimateCost(const AudioProbe::Result& probe, uint64_t sourceBytes, const Config& config);
+    static const char* fastPathName(FastPath fastPath);
+
+private:
+    struct FileState;
+    struct Chunk;
+    struct DedupEntry;
+    using ChunkPtr = std::unique_ptr<Chunk>;
+
+    AudioProcessor& m_audioProcessor;
+    Config m_config;
+    CompletionCallback m_onComplete;
+
+    ThreadPool m_readers;
+    BoundedQueue<ChunkPtr> m_transformQueue;
+    BoundedQueue<ChunkPtr> m_writeQueue;
+    std::vector<std::thread> m_transformThreads;
+    std::vector<std::thread> m_writerThreads;
+
+    // Recycled chunk buffers so steady-state decoding does not allocate
+    std::mutex m_freeChunksMutex;
+    std::vector<ChunkPtr> m_freeChunks;
+
+    std::atomic<size_t> m_submittedJobs{0};
+    std::atomic<size_t> m_queuedJobs{0};
+    std::atomic<size_t> m_maxQueuedJobs{0};
+    std::atomic<size_t> m_trimmedFiles{0};
+    std::atomic<uint64_t> m_trimmedBytes{0};
+    std::atomic<size_t> m_duplicateFiles{0};
+    std::atomic<uint64_t> m_dedupBytesSaved{0};
+
+    // Reader occupancy, in nanoseconds since m_created
+    std::chrono::steady_clock::time_point m_created = std::chrono::steady_clock::now();
+    std::atomic<size_t> m_readJobs{0};
+    std::atomic<int64_t> m_firstReadStart{INT64_MAX};
+    std::atomic<int64_t> m_lastReadEnd{0};
+    std::atomic<int64_t> m_readBusy{0};
+    std::atomic<int64_t> m_longestRead{0};
+
+    // Content hash -> first source seen with it, sharded so readers rarely contend
+    struct DedupShard {
+        mutable std::mutex mutex;
+        std::unordered_map<uint64_t, std::shared_ptr<DedupEntry>> entries;
+    };
+    static constexpr size_t kDedupShards = 16;
+    std::array<DedupShard, kDedupShards> m_dedupShards;
+
+    std::mutex m_completionMutex;
+    std::condition_variable m_completionCondition;
+    size_t m_pendingJobs = 0;
+    bool m_finished = false;
+
+    // Queues readFile at the job's cost and records how long it held the reader
+    void scheduleRead(const std::shared_ptr<FileState>& file);
+    void readFile(const std::shared_ptr<FileState>& file);
+    void copyFile(const std::shared_ptr<FileState>& file);
+    void transformLoop();
+    void writeLoop();
+    void writeChunk(FileState& file, const Chunk& chunk);
+    void completeJob(const std::shared_ptr<FileState>& file);
+
+    // False when the file is a duplicate that will be completed by its primary
+    bool claimContent(const std::shared_ptr<FileState>& file, uint64_t hash);
+    void resolveDuplicate(const std::shared_ptr<FileState>& file, DedupEntry& primary);
+
+    ChunkPtr acquireChunk();
+    void releaseChunk(ChunkPtr chunk);
+
+    // Per-file sequencing of chunks within a stage
+    void waitTurn(FileState& file, size_t& counter, size_t sequence);
+    void advanceTurn(FileState& file, size_t& counter);
+};
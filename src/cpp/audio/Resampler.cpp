@@ -0,0 +1,189 @@
+#include "Resampler.h"
+#include "SimdKernels.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <numeric>
+
+namespace {
+// Sinc zero crossings on each side of the centre at the output rate; with the
+// Kaiser window below this puts the transition band at about 0.46-0.54 fs_out
+constexpr double kZeroCrossings = 32.0;
+constexpr double kKaiserBeta = 9.0;  // ~90 dB stopband
+// Ratios with more phases than this (e.g. 44056 -> 44100) round to the nearest phase
+constexpr uint64_t kMaxPhases = 4096;
+
+double besselI0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    for (int k = 1; k < 50; k++) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+        if (term < sum * 1e-12) {
+            break;
+        }
+    }
+    return sum;
+}
+}
+
+struct Resampler::Table {
+    size_t half = 0;    // Taps before and after the output position
+    size_t taps = 0;    // 2 * half
+    uint64_t phases = 0;
+    std::vector<float> coefficients;  // phases rows of taps
+
+    const float* row(uint64_t phase) const { return coefficients.data() + phase * taps; }
+};
+
+namespace {
+std::shared_ptr<const Resampler::Table> buildTable(uint64_t up, uint64_t down) {
+    auto table = std::make_shared<Resampler::Table>();
+
+    // Cutoff relative to the input rate: the lower of the two Nyquist frequencies
+    const double cutoff = std::min(1.0, static_cast<double>(up) / static_cast<double>(down));
+    table->half = static_cast<size_t>(std::ceil(kZeroCrossings / cutoff));
+    table->taps = table->half * 2;
+    table->phases = std::min(up, kMaxPhases);
+    table->coefficients.resize(table->phases * table->taps);
+
+    const double i0Beta = besselI0(kKaiserBeta);
+    for (uint64_t phase = 0; phase < table->phases; phase++) {
+        // Output position lies this far past the input frame at index half - 1
+        double fraction = static_cast<double>(phase) / static_cast<double>(table->phases);
+        float* row = table->coefficients.data() + phase * table->taps;
+
+        double sum = 0.0;
+        for (size_t i = 0; i < table->taps; i++) {
+            double t = static_cast<double>(i) - static_cast<double>(table->half - 1) - fraction;
+            double x = cutoff * t;
+            double sinc = x == 0.0 ? 1.0 : std::sin(M_PI * x) / (M_PI * x);
+            double r = t / static_cast<double>(table->half);
+            double window = r * r < 1.0 ? besselI0(kKaiserBeta * std::sqrt(1.0 - r * r)) / i0Beta : 0.0;
+            double h = cutoff * sinc * window;
+            row[i] = static_cast<float>(h);
+            sum += h;
+        }
+
+        // Unity gain at DC for every phase
+        for (size_t i = 0; i < table->taps; i++) {
+            row[i] = static_cast<float>(row[i] / sum);
+        }
+    }
+    return table;
+}
+
+std::shared_ptr<const Resampler::Table> tableFor(uint64_t up, uint64_t down) {
+    static std::mutex cacheMutex;
+    static std::map<std::pair<uint64_t, uint64_t>, std::shared_ptr<const Resampler::Table>> cache;
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto& table = cache[{up, down}];
+    if (!table) {
+        table = buildTable(up, down);
+    }
+    return table;
+}
+}
+
+Resampler::Resampler(int inputRate, int outputRate, int channels)
+    : m_inputRate(inputRate)
+    , m_outputRate(outputRate)
+    , m_channels(std::max(channels, 1)) {
+    uint64_t divisor = std::gcd(static_cast<uint64_t>(inputRate), static_cast<uint64_t>(outputRate));
+    m_up = static_cast<uint64_t>(outputRate) / divisor;
+    m_down = static_cast<uint64_t>(inputRate) / divisor;
+    m_table = tableFor(m_up, m_down);
+
+    // Zeros stand in for the input before the first frame
+    m_history.assign(m_channels, std::vector<float>(m_table->half - 1, 0.0f));
+}
+
+Resampler::~Resampler() = default;
+
+size_t Resampler::getTapsPerPhase() const {
+    return m_table->taps;
+}
+
+uint64_t Resampler::outputFrames(uint64_t inputFrames, int inputRate, int outputRate) {
+    uint64_t divisor = std::gcd(static_cast<uint64_t>(inputRate), static_cast<uint64_t>(outputRate));
+    uint64_t up = static_cast<uint64_t>(outputRate) / divisor;
+    uint64_t down = static_cast<uint64_t>(inputRate) / divisor;
+    return (inputFrames * up + down - 1) / down;
+}
+
+void Resampler::process(const float* input, size_t frames, std::vector<float>& output) {
+    if (m_flushed) {
+        return;
+    }
+
+    for (int ch = 0; ch < m_channels; ch++) {
+        std::vector<float>& history = m_history[ch];
+        size_t offset = history.size();
+        history.resize(offset + frames);
+        for (size_t i = 0; i < frames; i++) {
+            history[offset + i] = input[i * m_channels + ch];
+        }
+    }
+    m_inputFrames += frames;
+
+    produce(output, outputFrames(m_inputFrames, m_inputRate, m_outputRate));
+
+    // Drop input no later output frame can reach
+    uint64_t nextBase = m_outputFrames * m_down / m_up;
+    if (nextBase > m_historyStart) {
+        size_t live = m_history[0].size() - m_historyOffset;
+        m_historyOffset += std::min(static_cast<size_t>(nextBase - m_historyStart), live);
+        m_historyStart = nextBase;
+
+        // Move the live frames (about one filter length) to the front only once the spent ones
+        // outnumber them, so every input frame is moved at most once
+        live = m_history[0].size() - m_historyOffset;
+        if (m_historyOffset >= live) {
+            for (auto& history : m_history) {
+                std::copy(history.begin() + static_cast<std::ptrdiff_t>(m_historyOffset), history.end(), history.begin());
+                history.resize(live);
+            }
+            m_historyOffset = 0;
+        }
+    }
+}
+
+void Resampler::flush(std::vector<float>& output) {
+    if (m_flushed) {
+        return;
+    }
+    m_flushed = true;
+
+    // Zeros after the last frame complete the final windows
+    for (auto& history : m_history) {
+        history.resize(history.size() + m_table->half, 0.0f);
+    }
+    produce(output, outputFrames(m_inputFrames, m_inputRate, m_outputRate));
+}
+
+void Resampler::produce(std::vector<float>& output, uint64_t limit) {
+    const SimdKernels& kernels = SimdKernels::get();
+    const size_t available = m_history[0].size() - m_historyOffset;
+
+    while (m_outputFrames < limit) {
+        uint64_t position = m_outputFrames * m_down;
+        uint64_t base = position / m_up;
+        size_t start = static_cast<size_t>(base - m_historyStart);
+        if (start + m_table->taps > available) {
+            break;
+        }
+
+        uint64_t phase = position % m_up;
+        if (m_table->phases != m_up) {
+            phase = std::min((phase * m_table->phases + m_up / 2) / m_up, m_table->phases - 1);
+        }
+        const float* row = m_table->row(phase);
+
+        for (int ch = 0; ch < m_channels; ch++) {
+            output.push_back(kernels.dotProduct(row, m_history[ch].data() + m_historyOffset + start, m_table->taps));
+        }
+        m_outputFrames++;
+    }
+}
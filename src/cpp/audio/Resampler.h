@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Streaming polyphase windowed-sinc sample-rate converter.
+//
+// The rate ratio is reduced to L/M (output/input); output frame k sits at input
+// position k * M / L and is the dot product of one of L precomputed phase rows
+// with the surrounding input. Rows are Kaiser-windowed sincs with the cutoff at
+// the lower of the two Nyquist frequencies, about 90 dB stopband rejection, and
+// are shared by every Resampler with the same ratio. Audio is fed in arbitrary
+// blocks and the output is identical to converting it in one go.
+class Resampler {
+public:
+    Resampler(int inputRate, int outputRate, int channels);
+    ~Resampler();
+
+    // Appends the frames that became computable to output (interleaved)
+    void process(const float* input, size_t frames, std::vector<float>& output);
+    // Emits the remaining frames; total output is ceil(inputFrames * outputRate / inputRate)
+    void flush(std::vector<float>& output);
+
+    int getInputRate() const { return m_inputRate; }
+    int getOutputRate() const { return m_outputRate; }
+    size_t getTapsPerPhase() const;
+    // Output frames for a whole source of inputFrames
+    static uint64_t outputFrames(uint64_t inputFrames, int inputRate, int outputRate);
+
+    struct Table;
+
+private:
+    int m_inputRate;
+    int m_outputRate;
+    int m_channels;
+    uint64_t m_up;    // L
+    uint64_t m_down;  // M
+    std::shared_ptr<const Table> m_table;
+
+    // Per channel; element m_historyOffset is input frame m_historyStart - (half - 1), the ones before it
+    // are spent and get reused once they outnumber the live frames
+    std::vector<std::vector<float>> m_history;
+    size_t m_historyOffset = 0;
+    uint64_t m_historyStart = 0;
+    uint64_t m_inputFrames = 0;
+    uint64_t m_outputFrames = 0;  // Next output frame index
+    bool m_flushed = false;
+
+    void produce(std::vector<float>& output, uint64_t limit);
+};
@@ -0,0 +1,193 @@
+#include "SilenceTrimmer.h"
+#include "SimdKernels.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// Frames per peak block: enough to amortize the kernel call, few enough that the scan stops close to the edge
+constexpr size_t kScanFrames = 256;
+
+// Block peaks and per-sample magnitudes in the sample type's own units
+float blockPeak(const float* data, size_t count) {
+    return SimdKernels::get().peak(data, count);
+}
+
+float blockPeak(const short* data, size_t count) {
+    return static_cast<float>(SimdKernels::get().peakInt16(data, count));
+}
+
+float magnitude(float sample) {
+    return std::fabs(sample);
+}
+
+float magnitude(short sample) {
+    return std::fabs(static_cast<float>(sample));
+}
+
+// Linear threshold in the units above
+float sampleThreshold(float threshold, const float*) {
+    return threshold;
+}
+
+float sampleThreshold(float threshold, const short*) {
+    return threshold * 32768.0f;
+}
+
+template <typename Sample>
+bool frameAudible(const Sample* frame, int channels, float threshold) {
+    for (int ch = 0; ch < channels; ch++) {
+        if (magnitude(frame[ch]) > threshold) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void applyGain(float* frame, size_t channels, float gain) {
+    for (size_t ch = 0; ch < channels; ch++) {
+        frame[ch] *= gain;
+    }
+}
+
+void applyGain(short* frame, size_t channels, float gain) {
+    for (size_t ch = 0; ch < channels; ch++) {
+        frame[ch] = static_cast<short>(std::lrintf(static_cast<float>(frame[ch]) * gain));
+    }
+}
+}
+
+template <typename Sample>
+SilenceTrimmer<Sample>::SilenceTrimmer(int channels, float thresholdDb, size_t fadeFrames, size_t maxHeldFrames)
+    : m_channels(std::max(channels, 1))
+    , m_threshold(dbToLinear(thresholdDb))
+    , m_fadeFrames(fadeFrames)
+    , m_maxHeldFrames(std::max(maxHeldFrames, fadeFrames)) {
+}
+
+template <typename Sample>
+float SilenceTrimmer<Sample>::dbToLinear(float db) {
+    return std::pow(10.0f, db / 20.0f);
+}
+
+template <typename Sample>
+size_t SilenceTrimmer<Sample>::firstAudibleFrame(const Sample* data, size_t frames, int channels, float threshold) {
+    const size_t stride = static_cast<size_t>(channels);
+    threshold = sampleThreshold(threshold, data);
+
+    for (size_t start = 0; start < frames; start += kScanFrames) {
+        size_t count = std::min(kScanFrames, frames - start);
+        if (blockPeak(data + start * stride, count * stride) > threshold) {
+            for (size_t i = start; i < start + count; i++) {
+                if (frameAudible(data + i * stride, channels, threshold)) {
+                    return i;
+                }
+            }
+        }
+    }
+    return frames;
+}
+
+template <typename Sample>
+size_t SilenceTrimmer<Sample>::audibleEnd(const Sample* data, size_t frames, int channels, float threshold) {
+    const size_t stride = static_cast<size_t>(channels);
+    threshold = sampleThreshold(threshold, data);
+
+    size_t end = frames;
+    while (end > 0) {
+        size_t start = end > kScanFrames ? end - kScanFrames : 0;
+        if (blockPeak(data + start * stride, (end - start) * stride) > threshold) {
+            for (size_t i = end; i > start; i--) {
+                if (frameAudible(data + (i - 1) * stride, channels, threshold)) {
+                    return i;
+                }
+            }
+        }
+        end = start;
+    }
+    return 0;
+}
+
+template <typename Sample>
+void SilenceTrimmer<Sample>::process(const Sample* input, size_t frames, std::vector<Sample>& output) {
+    if (m_flushed) {
+        return;
+    }
+    m_inputFrames += frames;
+
+    const size_t stride = static_cast<size_t>(m_channels);
+    if (!m_started) {
+        size_t first = firstAudibleFrame(input, frames, m_channels, m_threshold);
+        if (first == frames) {
+            return;
+        }
+        input += first * stride;
+        frames -= first;
+        m_started = true;
+    }
+
+    size_t offset = getHeldFrames();
+    m_pending.insert(m_pending.end(), input, input + frames * stride);
+    size_t end = audibleEnd(input, frames, m_channels, m_threshold);
+    if (end > 0) {
+        m_pendingAudibleEnd = offset + end;
+    }
+
+    // Keep the last fadeFrames audible frames back in case the stream ends right after them
+    if (m_pendingAudibleEnd > m_fadeFrames) {
+        emit(m_pendingAudibleEnd - m_fadeFrames, output);
+    }
+    // Quiet this long is part of the sample rather than a tail to trim
+    if (getHeldFrames() > m_maxHeldFrames) {
+        emit(getHeldFrames(), output);
+    }
+}
+
+template <typename Sample>
+void SilenceTrimmer<Sample>::flush(std::vector<Sample>& output) {
+    if (m_flushed) {
+        return;
+    }
+    m_flushed = true;
+
+    const size_t stride = static_cast<size_t>(m_channels);
+    m_pending.resize((m_pendingOffset + m_pendingAudibleEnd) * stride);
+
+    Sample* held = m_pending.data() + m_pendingOffset * stride;
+    size_t fade = std::min(m_fadeFrames, m_pendingAudibleEnd);
+    for (size_t i = 0; i < fade; i++) {
+        // Frame i from the end: the last frame gets 1/fadeFrames
+        float gain = static_cast<float>(i + 1) / static_cast<float>(m_fadeFrames);
+        applyGain(held + (m_pendingAudibleEnd - 1 - i) * stride, stride, gain);
+    }
+    emit(m_pendingAudibleEnd, output);
+}
+
+template <typename Sample>
+void SilenceTrimmer<Sample>::emit(size_t frames, std::vector<Sample>& output) {
+    const size_t stride = static_cast<size_t>(m_channels);
+    size_t first = output.size();
+    const Sample* held = m_pending.data() + m_pendingOffset * stride;
+    output.insert(output.end(), held, held + frames * stride);
+    m_pendingOffset += frames;
+    m_pendingAudibleEnd -= std::min(frames, m_pendingAudibleEnd);
+
+    // Move what is still held to the front only once the emitted frames outnumber it, so every
+    // frame is moved at most once
+    size_t remaining = getHeldFrames();
+    if (m_pendingOffset >= remaining) {
+        std::copy(m_pending.begin() + static_cast<std::ptrdiff_t>(m_pendingOffset * stride), m_pending.end(),
+                  m_pending.begin());
+        m_pending.resize(remaining * stride);
+        m_pendingOffset = 0;
+    }
+
+    // Fade in over the first fadeFrames of the whole output, starting from silence
+    for (size_t i = 0; i < frames && m_outputFrames + i < m_fadeFrames; i++) {
+        float gain = static_cast<float>(m_outputFrames + i) / static_cast<float>(m_fadeFrames);
+        applyGain(output.data() + first + i * stride, stride, gain);
+    }
+    m_outputFrames += frames;
+}
+
+template class SilenceTrimmer<float>;
+template class SilenceTrimmer<short>;
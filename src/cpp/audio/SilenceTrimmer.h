@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Streaming removal of leading and trailing silence, on float samples or on
+// 16-bit PCM (so sources on the native fast path stay bit-exact).
+//
+// A frame is audible when any of its samples exceeds the threshold. Leading
+// frames are dropped until the first audible one; everything after the last
+// audible frame seen so far is held back until more audio arrives or the stream
+// ends, so blocks can be fed as they are decoded. A quiet stretch longer than
+// maxHeldFrames is let through instead of held, which bounds memory: of a
+// trailing silence that long, only the part after the last full stretch is
+// trimmed. Both searches scan SIMD block
+// peaks and stop at the first block that crosses the threshold, so a sample with
+// a short tail only touches the edges of each block.
+//
+// With fadeFrames > 0 the kept audio fades in and out linearly over that many
+// frames. A stream with no audible frame produces no output.
+template <typename Sample>
+class SilenceTrimmer {
+public:
+    static constexpr size_t DEFAULT_MAX_HELD_FRAMES = size_t(1) << 20;  // About 22 s at 48 kHz
+
+    SilenceTrimmer(int channels, float thresholdDb, size_t fadeFrames = 0,
+                   size_t maxHeldFrames = DEFAULT_MAX_HELD_FRAMES);
+
+    // Appends the frames that are known to be kept (interleaved)
+    void process(const Sample* input, size_t frames, std::vector<Sample>& output);
+    // Emits the held-back audio up to the last audible frame
+    void flush(std::vector<Sample>& output);
+
+    size_t getFadeFrames() const { return m_fadeFrames; }
+    uint64_t getInputFrames() const { return m_inputFrames; }
+    uint64_t getOutputFrames() const { return m_outputFrames; }
+    // Frames taken in but neither emitted nor dropped yet
+    size_t getHeldFrames() const { return m_pending.size() / static_cast<size_t>(m_channels) - m_pendingOffset; }
+
+    // Thresholds below are linear, 1.0 = full scale for both sample types.
+    // First audible frame, or frames if there is none
+    static size_t firstAudibleFrame(const Sample* data, size_t frames, int channels, float threshold);
+    // One past the last audible frame, or 0 if there is none
+    static size_t audibleEnd(const Sample* data, size_t frames, int channels, float threshold);
+
+    static float dbToLinear(float db);
+
+private:
+    int m_channels;
+    float m_threshold;
+    size_t m_fadeFrames;
+    size_t m_maxHeldFrames;
+
+    bool m_started = false;      // Leading silence is behind us
+    bool m_flushed = false;
+    std::vector<Sample> m_pending;   // Audio not emitted yet, interleaved, from frame m_pendingOffset on
+    size_t m_pendingOffset = 0;      // Emitted frames at the front of m_pending, reused once they outnumber the rest
+    size_t m_pendingAudibleEnd = 0;  // Held frames up to and including the last audible one
+    uint64_t m_inputFrames = 0;
+    uint64_t m_outputFrames = 0;
+
+    void emit(size_t frames, std::vector<Sample>& output);
+};
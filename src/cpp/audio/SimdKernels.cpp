@@ -0,0 +1,626 @@
+#include "SimdKernels.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define M8_SIMD_X86 1
+#include <immintrin.h>
+// Compiled per function so the binary still runs on CPUs without the extension
+#define M8_TARGET(isa) __attribute__((target(isa)))
+#elif defined(__aarch64__)
+#define M8_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace {
+constexpr float kInt16Scale = 32767.0f;
+constexpr float kInt24Scale = 8388607.0f;
+
+// Vector sum-of-squares accumulators are flushed to double this often to bound float error
+constexpr size_t kSumBlock = 4096;
+
+// ---------------------------------------------------------------------------
+// Scalar reference
+// ---------------------------------------------------------------------------
+
+void downmixStereoScalar(const float* stereo, float* mono, size_t frames) {
+    for (size_t i = 0; i < frames; i++) {
+        mono[i] = (stereo[i * 2] + stereo[i * 2 + 1]) * 0.5f;
+    }
+}
+
+float peakScalar(const float* data, size_t count) {
+    float peak = 0.0f;
+    for (size_t i = 0; i < count; i++) {
+        peak = std::max(peak, std::fabs(data[i]));
+    }
+    return peak;
+}
+
+int32_t peakInt16Scalar(const int16_t* data, size_t count) {
+    int32_t peak = 0;
+    for (size_t i = 0; i < count; i++) {
+        peak = std::max(peak, std::abs(static_cast<int32_t>(data[i])));
+    }
+    return peak;
+}
+
+double sumSquaresScalar(const float* data, size_t count) {
+    double sum = 0.0;
+    for (size_t i = 0; i < count; i++) {
+        sum += static_cast<double>(data[i]) * data[i];
+    }
+    return sum;
+}
+
+void applyGainScalar(const float* input, float* output, size_t count, float gain) {
+    for (size_t i = 0; i < count; i++) {
+        output[i] = input[i] * gain;
+    }
+}
+
+void clampScalar(const float* input, float* output, size_t count, float low, float high) {
+    for (size_t i = 0; i < count; i++) {
+        output[i] = std::min(std::max(input[i], low), high);
+    }
+}
+
+void floatToInt16Scalar(const float* input, int16_t* output, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        float scaled = std::min(std::max(input[i] * kInt16Scale, -32768.0f), 32767.0f);
+        output[i] = static_cast<int16_t>(std::lrintf(scaled));
+    }
+}
+
+void floatToInt24Scalar(const float* input, int32_t* output, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        float scaled = std::min(std::max(input[i] * kInt24Scale, -8388608.0f), 8388607.0f);
+        output[i] = static_cast<int32_t>(std::lrintf(scaled));
+    }
+}
+
+void floatToInt16TpdfScalar(const float* input, int16_t* output, size_t count, uint32_t* rng) {
+    for (size_t i = 0; i < count; i++) {
+        float dither = SimdKernels::nextTpdf(rng[i % SimdKernels::DITHER_LANES]);
+        float scaled = std::min(std::max(input[i] * kInt16Scale + dither, -32768.0f), 32767.0f);
+        output[i] = static_cast<int16_t>(std::lrintf(scaled));
+    }
+}
+
+float dotProductScalar(const float* a, const float* b, size_t count) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < count; i++) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+const SimdKernels kScalar = {
+    SimdKernels::SCALAR, "scalar",
+    downmixStereoScalar, peakScalar, peakInt16Scalar, sumSquaresScalar, applyGainScalar, clampScalar,
+    floatToInt16Scalar, floatToInt24Scalar, floatToInt16TpdfScalar, dotProductScalar
+};
+
+#ifdef M8_SIMD_X86
+// ---------------------------------------------------------------------------
+// SSE4.1 (4 lanes)
+// ---------------------------------------------------------------------------
+
+M8_TARGET("sse4.1") float horizontalMax128(__m128 v) {
+    v = _mm_max_ps(v, _mm_movehl_ps(v, v));
+    v = _mm_max_ss(v, _mm_shuffle_ps(v, v, 1));
+    return _mm_cvtss_f32(v);
+}
+
+M8_TARGET("sse4.1") double horizontalSum128(__m128 v) {
+    v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+    v = _mm_add_ss(v, _mm_shuffle_ps(v, v, 1));
+    return _mm_cvtss_f32(v);
+}
+
+M8_TARGET("sse4.1") void downmixStereoSse41(const float* stereo, float* mono, size_t frames) {
+    const __m128 half = _mm_set1_ps(0.5f);
+    size_t i = 0;
+    for (; i + 4 <= frames; i += 4) {
+        __m128 a = _mm_loadu_ps(stereo + i * 2);      // L0 R0 L1 R1
+        __m128 b = _mm_loadu_ps(stereo + i * 2 + 4);  // L2 R2 L3 R3
+        __m128 left = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 right = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+        _mm_storeu_ps(mono + i, _mm_mul_ps(_mm_add_ps(left, right), half));
+    }
+    downmixStereoScalar(stereo + i * 2, mono + i, frames - i);
+}
+
+M8_TARGET("sse4.1") float peakSse41(const float* data, size_t count) {
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    __m128 peak = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        peak = _mm_max_ps(peak, _mm_and_ps(_mm_loadu_ps(data + i), absMask));
+    }
+    return std::max(horizontalMax128(peak), peakScalar(data + i, count - i));
+}
+
+// |x| as unsigned 16-bit lanes, so abs(-32768) = 0x8000 is still the largest
+M8_TARGET("sse4.1") int32_t horizontalMaxU16(__m128i v) {
+    // minpos finds the smallest lane; invert to find the largest
+    __m128i inverted = _mm_xor_si128(v, _mm_set1_epi16(-1));
+    return 0xFFFF - _mm_extract_epi16(_mm_minpos_epu16(inverted), 0);
+}
+
+M8_TARGET("sse4.1") int32_t peakInt16Sse41(const int16_t* data, size_t count) {
+    __m128i peak = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        peak = _mm_max_epu16(peak, _mm_abs_epi16(v));
+    }
+    return std::max(horizontalMaxU16(peak), peakInt16Scalar(data + i, count - i));
+}
+
+M8_TARGET("sse4.1") double sumSquaresSse41(const float* data, size_t count) {
+    double sum = 0.0;
+    size_t i = 0;
+    while (i + 4 <= count) {
+        size_t blockEnd = std::min(count - count % 4, i + kSumBlock);
+        __m128 acc = _mm_setzero_ps();
+        for (; i < blockEnd; i += 4) {
+            __m128 v = _mm_loadu_ps(data + i);
+            acc = _mm_add_ps(acc, _mm_mul_ps(v, v));
+        }
+        sum += horizontalSum128(acc);
+    }
+    return sum + sumSquaresScalar(data + i, count - i);
+}
+
+M8_TARGET("sse4.1") void applyGainSse41(const float* input, float* output, size_t count, float gain) {
+    const __m128 g = _mm_set1_ps(gain);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(output + i, _mm_mul_ps(_mm_loadu_ps(input + i), g));
+    }
+    applyGainScalar(input + i, output + i, count - i, gain);
+}
+
+M8_TARGET("sse4.1") void clampSse41(const float* input, float* output, size_t count, float low, float high) {
+    const __m128 lo = _mm_set1_ps(low);
+    const __m128 hi = _mm_set1_ps(high);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(output + i, _mm_min_ps(_mm_max_ps(_mm_loadu_ps(input + i), lo), hi));
+    }
+    clampScalar(input + i, output + i, count - i, low, high);
+}
+
+M8_TARGET("sse4.1") void floatToInt16Sse41(const float* input, int16_t* output, size_t count) {
+    const __m128 scale = _mm_set1_ps(kInt16Scale);
+    const __m128 lo = _mm_set1_ps(-32768.0f);
+    const __m128 hi = _mm_set1_ps(32767.0f);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128 a = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(input + i), scale), lo), hi);
+        __m128 b = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(input + i + 4), scale), lo), hi);
+        // cvtps rounds to nearest-even like lrintf
+        __m128i packed = _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), packed);
+    }
+    floatToInt16Scalar(input + i, output + i, count - i);
+}
+
+M8_TARGET("sse4.1") void floatToInt24Sse41(const float* input, int32_t* output, size_t count) {
+    const __m128 scale = _mm_set1_ps(kInt24Scale);
+    const __m128 lo = _mm_set1_ps(-8388608.0f);
+    const __m128 hi = _mm_set1_ps(8388607.0f);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 v = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(input + i), scale), lo), hi);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), _mm_cvtps_epi32(v));
+    }
+    floatToInt24Scalar(input + i, output + i, count - i);
+}
+
+// Four xorshift32 lanes, one step
+M8_TARGET("sse4.1") inline __m128i xorshift128(__m128i state) {
+    state = _mm_xor_si128(state, _mm_slli_epi32(state, 13));
+    state = _mm_xor_si128(state, _mm_srli_epi32(state, 17));
+    return _mm_xor_si128(state, _mm_slli_epi32(state, 5));
+}
+
+M8_TARGET("sse4.1") inline __m128 tpdf128(__m128i random) {
+    __m128i difference = _mm_sub_epi32(_mm_srli_epi32(random, 16), _mm_and_si128(random, _mm_set1_epi32(0xFFFF)));
+    return _mm_mul_ps(_mm_cvtepi32_ps(difference), _mm_set1_ps(1.0f / 65536.0f));
+}
+
+M8_TARGET("sse4.1") void floatToInt16TpdfSse41(const float* input, int16_t* output, size_t count, uint32_t* rng) {
+    const __m128 scale = _mm_set1_ps(kInt16Scale);
+    const __m128 lo = _mm_set1_ps(-32768.0f);
+    const __m128 hi = _mm_set1_ps(32767.0f);
+    __m128i lanesLo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rng));
+    __m128i lanesHi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rng + 4));
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        lanesLo = xorshift128(lanesLo);
+        lanesHi = xorshift128(lanesHi);
+        __m128 a = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(input + i), scale), tpdf128(lanesLo));
+        __m128 b = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(input + i + 4), scale), tpdf128(lanesHi));
+        a = _mm_min_ps(_mm_max_ps(a, lo), hi);
+        b = _mm_min_ps(_mm_max_ps(b, lo), hi);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b)));
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(rng), lanesLo);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(rng + 4), lanesHi);
+    // i is a multiple of DITHER_LANES, so the tail keeps the lane assignment
+    floatToInt16TpdfScalar(input + i, output + i, count - i, rng);
+}
+
+M8_TARGET("sse4.1") float dotProductSse41(const float* a, const float* b, size_t count) {
+    // Two accumulators hide the add latency
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+    }
+    return static_cast<float>(horizontalSum128(_mm_add_ps(acc0, acc1))) + dotProductScalar(a + i, b + i, count - i);
+}
+
+const SimdKernels kSse41 = {
+    SimdKernels::SSE41, "sse4.1",
+    downmixStereoSse41, peakSse41, peakInt16Sse41, sumSquaresSse41, applyGainSse41, clampSse41,
+    floatToInt16Sse41, floatToInt24Sse41, floatToInt16TpdfSse41, dotProductSse41
+};
+
+// ---------------------------------------------------------------------------
+// AVX2 (8 lanes)
+// ---------------------------------------------------------------------------
+
+// Restore element order after a per-128-bit-lane shuffle or pack
+M8_TARGET("avx2") inline __m256 crossLaneOrder(__m256 v) {
+    return _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(v), _MM_SHUFFLE(3, 1, 2, 0)));
+}
+
+M8_TARGET("avx2") void downmixStereoAvx2(const float* stereo, float* mono, size_t frames) {
+    const __m256 half = _mm256_set1_ps(0.5f);
+    size_t i = 0;
+    for (; i + 8 <= frames; i += 8) {
+        __m256 a = _mm256_loadu_ps(stereo + i * 2);
+        __m256 b = _mm256_loadu_ps(stereo + i * 2 + 8);
+        __m256 left = crossLaneOrder(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+        __m256 right = crossLaneOrder(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+        _mm256_storeu_ps(mono + i, _mm256_mul_ps(_mm256_add_ps(left, right), half));
+    }
+    downmixStereoSse41(stereo + i * 2, mono + i, frames - i);
+}
+
+M8_TARGET("avx2") float peakAvx2(const float* data, size_t count) {
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+    __m256 peak = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        peak = _mm256_max_ps(peak, _mm256_and_ps(_mm256_loadu_ps(data + i), absMask));
+    }
+    __m128 folded = _mm_max_ps(_mm256_castps256_ps128(peak), _mm256_extractf128_ps(peak, 1));
+    return std::max(horizontalMax128(folded), peakScalar(data + i, count - i));
+}
+
+M8_TARGET("avx2") int32_t peakInt16Avx2(const int16_t* data, size_t count) {
+    __m256i peak = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        peak = _mm256_max_epu16(peak, _mm256_abs_epi16(v));
+    }
+    __m128i folded = _mm_max_epu16(_mm256_castsi256_si128(peak), _mm256_extracti128_si256(peak, 1));
+    return std::max(horizontalMaxU16(folded), peakInt16Scalar(data + i, count - i));
+}
+
+M8_TARGET("avx2") double sumSquaresAvx2(const float* data, size_t count) {
+    double sum = 0.0;
+    size_t i = 0;
+    while (i + 8 <= count) {
+        size_t blockEnd = std::min(count - count % 8, i + kSumBlock);
+        __m256 acc = _mm256_setzero_ps();
+        for (; i < blockEnd; i += 8) {
+            __m256 v = _mm256_loadu_ps(data + i);
+            acc = _mm256_add_ps(acc, _mm256_mul_ps(v, v));
+        }
+        sum += horizontalSum128(_mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1)));
+    }
+    return sum + sumSquaresScalar(data + i, count - i);
+}
+
+M8_TARGET("avx2") void applyGainAvx2(const float* input, float* output, size_t count, float gain) {
+    const __m256 g = _mm256_set1_ps(gain);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_ps(output + i, _mm256_mul_ps(_mm256_loadu_ps(input + i), g));
+    }
+    applyGainScalar(input + i, output + i, count - i, gain);
+}
+
+M8_TARGET("avx2") void clampAvx2(const float* input, float* output, size_t count, float low, float high) {
+    const __m256 lo = _mm256_set1_ps(low);
+    const __m256 hi = _mm256_set1_ps(high);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_ps(output + i, _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(input + i), lo), hi));
+    }
+    clampScalar(input + i, output + i, count - i, low, high);
+}
+
+M8_TARGET("avx2") void floatToInt16Avx2(const float* input, int16_t* output, size_t count) {
+    const __m256 scale = _mm256_set1_ps(kInt16Scale);
+    const __m256 lo = _mm256_set1_ps(-32768.0f);
+    const __m256 hi = _mm256_set1_ps(32767.0f);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m256 a = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(input + i), scale), lo), hi);
+        __m256 b = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(input + i + 8), scale), lo), hi);
+        __m256i packed = _mm256_packs_epi32(_mm256_cvtps_epi32(a), _mm256_cvtps_epi32(b));
+        packed = _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i), packed);
+    }
+    floatToInt16Sse41(input + i, output + i, count - i);
+}
+
+M8_TARGET("avx2") void floatToInt24Avx2(const float* input, int32_t* output, size_t count) {
+    const __m256 scale = _mm256_set1_ps(kInt24Scale);
+    const __m256 lo = _mm256_set1_ps(-8388608.0f);
+    const __m256 hi = _mm256_set1_ps(8388607.0f);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 v = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(input + i), scale), lo), hi);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i), _mm256_cvtps_epi32(v));
+    }
+    floatToInt24Scalar(input + i, output + i, count - i);
+}
+
+M8_TARGET("avx2") inline __m256i xorshift256(__m256i state) {
+    state = _mm256_xor_si256(state, _mm256_slli_epi32(state, 13));
+    state = _mm256_xor_si256(state, _mm256_srli_epi32(state, 17));
+    return _mm256_xor_si256(state, _mm256_slli_epi32(state, 5));
+}
+
+M8_TARGET("avx2") inline __m256 tpdf256(__m256i random) {
+    __m256i difference = _mm256_sub_epi32(_mm256_srli_epi32(random, 16),
+                                          _mm256_and_si256(random, _mm256_set1_epi32(0xFFFF)));
+    return _mm256_mul_ps(_mm256_cvtepi32_ps(difference), _mm256_set1_ps(1.0f / 65536.0f));
+}
+
+M8_TARGET("avx2") void floatToInt16TpdfAvx2(const float* input, int16_t* output, size_t count, uint32_t* rng) {
+    const __m256 scale = _mm256_set1_ps(kInt16Scale);
+    const __m256 lo = _mm256_set1_ps(-32768.0f);
+    const __m256 hi = _mm256_set1_ps(32767.0f);
+    __m256i lanes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rng));
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        // Samples i..i+7 and i+8..i+15 take consecutive steps of the same eight lanes
+        __m256i first = xorshift256(lanes);
+        lanes = xorshift256(first);
+        __m256 a = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(input + i), scale), tpdf256(first));
+        __m256 b = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(input + i + 8), scale), tpdf256(lanes));
+        a = _mm256_min_ps(_mm256_max_ps(a, lo), hi);
+        b = _mm256_min_ps(_mm256_max_ps(b, lo), hi);
+        __m256i packed = _mm256_packs_epi32(_mm256_cvtps_epi32(a), _mm256_cvtps_epi32(b));
+        packed = _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i), packed);
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(rng), lanes);
+    floatToInt16TpdfSse41(input + i, output + i, count - i, rng);
+}
+
+M8_TARGET("avx2") float dotProductAvx2(const float* a, const float* b, size_t count) {
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+        acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8)));
+    }
+    __m256 acc = _mm256_add_ps(acc0, acc1);
+    __m128 folded = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    return static_cast<float>(horizontalSum128(folded)) + dotProductSse41(a + i, b + i, count - i);
+}
+
+const SimdKernels kAvx2 = {
+    SimdKernels::AVX2, "avx2",
+    downmixStereoAvx2, peakAvx2, peakInt16Avx2, sumSquaresAvx2, applyGainAvx2, clampAvx2,
+    floatToInt16Avx2, floatToInt24Avx2, floatToInt16TpdfAvx2, dotProductAvx2
+};
+#endif
+
+#ifdef M8_SIMD_NEON
+// ---------------------------------------------------------------------------
+// NEON (4 lanes, AArch64)
+// ---------------------------------------------------------------------------
+
+void downmixStereoNeon(const float* stereo, float* mono, size_t frames) {
+    const float32x4_t half = vdupq_n_f32(0.5f);
+    size_t i = 0;
+    for (; i + 4 <= frames; i += 4) {
+        float32x4x2_t lr = vld2q_f32(stereo + i * 2);  // Deinterleaves L and R
+        vst1q_f32(mono + i, vmulq_f32(vaddq_f32(lr.val[0], lr.val[1]), half));
+    }
+    downmixStereoScalar(stereo + i * 2, mono + i, frames - i);
+}
+
+float peakNeon(const float* data, size_t count) {
+    float32x4_t peak = vdupq_n_f32(0.0f);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        peak = vmaxq_f32(peak, vabsq_f32(vld1q_f32(data + i)));
+    }
+    return std::max(vmaxvq_f32(peak), peakScalar(data + i, count - i));
+}
+
+int32_t peakInt16Neon(const int16_t* data, size_t count) {
+    uint16x8_t peak = vdupq_n_u16(0);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        // Wrapping abs leaves -32768 as 0x8000, the largest unsigned lane
+        peak = vmaxq_u16(peak, vreinterpretq_u16_s16(vabsq_s16(vld1q_s16(data + i))));
+    }
+    return std::max(static_cast<int32_t>(vmaxvq_u16(peak)), peakInt16Scalar(data + i, count - i));
+}
+
+double sumSquaresNeon(const float* data, size_t count) {
+    double sum = 0.0;
+    size_t i = 0;
+    while (i + 4 <= count) {
+        size_t blockEnd = std::min(count - count % 4, i + kSumBlock);
+        float32x4_t acc = vdupq_n_f32(0.0f);
+        for (; i < blockEnd; i += 4) {
+            float32x4_t v = vld1q_f32(data + i);
+            acc = vfmaq_f32(acc, v, v);
+        }
+        sum += vaddvq_f32(acc);
+    }
+    return sum + sumSquaresScalar(data + i, count - i);
+}
+
+void applyGainNeon(const float* input, float* output, size_t count, float gain) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        vst1q_f32(output + i, vmulq_n_f32(vld1q_f32(input + i), gain));
+    }
+    applyGainScalar(input + i, output + i, count - i, gain);
+}
+
+void clampNeon(const float* input, float* output, size_t count, float low, float high) {
+    const float32x4_t lo = vdupq_n_f32(low);
+    const float32x4_t hi = vdupq_n_f32(high);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        vst1q_f32(output + i, vminq_f32(vmaxq_f32(vld1q_f32(input + i), lo), hi));
+    }
+    clampScalar(input + i, output + i, count - i, low, high);
+}
+
+void floatToInt16Neon(const float* input, int16_t* output, size_t count) {
+    const float32x4_t lo = vdupq_n_f32(-32768.0f);
+    const float32x4_t hi = vdupq_n_f32(32767.0f);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        float32x4_t a = vminq_f32(vmaxq_f32(vmulq_n_f32(vld1q_f32(input + i), kInt16Scale), lo), hi);
+        float32x4_t b = vminq_f32(vmaxq_f32(vmulq_n_f32(vld1q_f32(input + i + 4), kInt16Scale), lo), hi);
+        // vcvtn rounds to nearest-even like lrintf
+        int16x8_t packed = vcombine_s16(vqmovn_s32(vcvtnq_s32_f32(a)), vqmovn_s32(vcvtnq_s32_f32(b)));
+        vst1q_s16(output + i, packed);
+    }
+    floatToInt16Scalar(input + i, output + i, count - i);
+}
+
+void floatToInt24Neon(const float* input, int32_t* output, size_t count) {
+    const float32x4_t lo = vdupq_n_f32(-8388608.0f);
+    const float32x4_t hi = vdupq_n_f32(8388607.0f);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t v = vminq_f32(vmaxq_f32(vmulq_n_f32(vld1q_f32(input + i), kInt24Scale), lo), hi);
+        vst1q_s32(output + i, vcvtnq_s32_f32(v));
+    }
+    floatToInt24Scalar(input + i, output + i, count - i);
+}
+
+inline uint32x4_t xorshiftNeon(uint32x4_t state) {
+    state = veorq_u32(state, vshlq_n_u32(state, 13));
+    state = veorq_u32(state, vshrq_n_u32(state, 17));
+    return veorq_u32(state, vshlq_n_u32(state, 5));
+}
+
+inline float32x4_t tpdfNeon(uint32x4_t random) {
+    int32x4_t difference = vsubq_s32(vreinterpretq_s32_u32(vshrq_n_u32(random, 16)),
+                                     vreinterpretq_s32_u32(vandq_u32(random, vdupq_n_u32(0xFFFF))));
+    return vmulq_n_f32(vcvtq_f32_s32(difference), 1.0f / 65536.0f);
+}
+
+void floatToInt16TpdfNeon(const float* input, int16_t* output, size_t count, uint32_t* rng) {
+    const float32x4_t lo = vdupq_n_f32(-32768.0f);
+    const float32x4_t hi = vdupq_n_f32(32767.0f);
+    uint32x4_t lanesLo = vld1q_u32(rng);
+    uint32x4_t lanesHi = vld1q_u32(rng + 4);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        lanesLo = xorshiftNeon(lanesLo);
+        lanesHi = xorshiftNeon(lanesHi);
+        float32x4_t a = vaddq_f32(vmulq_n_f32(vld1q_f32(input + i), kInt16Scale), tpdfNeon(lanesLo));
+        float32x4_t b = vaddq_f32(vmulq_n_f32(vld1q_f32(input + i + 4), kInt16Scale), tpdfNeon(lanesHi));
+        a = vminq_f32(vmaxq_f32(a, lo), hi);
+        b = vminq_f32(vmaxq_f32(b, lo), hi);
+        vst1q_s16(output + i, vcombine_s16(vqmovn_s32(vcvtnq_s32_f32(a)), vqmovn_s32(vcvtnq_s32_f32(b))));
+    }
+    vst1q_u32(rng, lanesLo);
+    vst1q_u32(rng + 4, lanesHi);
+    floatToInt16TpdfScalar(input + i, output + i, count - i, rng);
+}
+
+float dotProductNeon(const float* a, const float* b, size_t count) {
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x4_t acc1 = vdupq_n_f32(0.0f);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        acc0 = vfmaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+        acc1 = vfmaq_f32(acc1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+    }
+    return vaddvq_f32(vaddq_f32(acc0, acc1)) + dotProductScalar(a + i, b + i, count - i);
+}
+
+const SimdKernels kNeon = {
+    SimdKernels::NEON, "neon",
+    downmixStereoNeon, peakNeon, peakInt16Neon, sumSquaresNeon, applyGainNeon, clampNeon,
+    floatToInt16Neon, floatToInt24Neon, floatToInt16TpdfNeon, dotProductNeon
+};
+#endif
+
+const SimdKernels& selectKernels() {
+    // Explicit override first, mainly for benchmarking and bisecting ISA-specific issues
+    if (const char* requested = std::getenv("M8_SIMD")) {
+        for (SimdKernels::Isa isa : SimdKernels::availableIsas()) {
+            const SimdKernels* kernels = SimdKernels::forIsa(isa);
+            if (std::strcmp(requested, kernels->name) == 0 ||
+                (isa == SimdKernels::SSE41 && std::strcmp(requested, "sse41") == 0)) {
+                return *kernels;
+            }
+        }
+    }
+
+    // availableIsas() is ordered from slowest to fastest
+    return *SimdKernels::forIsa(SimdKernels::availableIsas().back());
+}
+}
+
+const SimdKernels& SimdKernels::get() {
+    static const SimdKernels& selected = selectKernels();
+    return selected;
+}
+
+const SimdKernels* SimdKernels::forIsa(Isa isa) {
+    switch (isa) {
+        case SCALAR:
+            return &kScalar;
+#ifdef M8_SIMD_X86
+        case SSE41:
+            return __builtin_cpu_supports("sse4.1") ? &kSse41 : nullptr;
+        case AVX2:
+            return __builtin_cpu_supports("avx2") ? &kAvx2 : nullptr;
+#endif
+#ifdef M8_SIMD_NEON
+        case NEON:
+            return &kNeon;  // Baseline on AArch64
+#endif
+        default:
+            return nullptr;
+    }
+}
+
+std::vector<SimdKernels::Isa> SimdKernels::availableIsas() {
+    std::vector<Isa> isas;
+    for (Isa isa : {SCALAR, SSE41, AVX2, NEON}) {
+        if (forIsa(isa)) {
+            isas.push_back(isa);
+        }
+    }
+    return isas;
+}
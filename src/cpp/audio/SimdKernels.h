@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Portable vectorized sample kernels with runtime CPU dispatch.
+// Every ISA fills the same table; get() picks the best one the CPU supports
+// (override with M8_SIMD=scalar|sse41|avx2|neon). Conversions round to nearest
+// and clip like AudioProcessor::convertTo16Bit.
+struct SimdKernels {
+    enum Isa {
+        SCALAR = 0,
+        SSE41 = 1,
+        AVX2 = 2,
+        NEON = 3
+    };
+
+    Isa isa;
+    const char* name;
+
+    // Interleaved stereo -> mono, (L + R) / 2
+    void (*downmixStereo)(const float* stereo, float* mono, size_t frames);
+    // Largest absolute sample value
+    float (*peak)(const float* data, size_t count);
+    // Same for 16-bit PCM; 32768 for -32768
+    int32_t (*peakInt16)(const int16_t* data, size_t count);
+    // Sum of squares (accumulated in double) for RMS
+    double (*sumSquares)(const float* data, size_t count);
+    void (*applyGain)(const float* input, float* output, size_t count, float gain);
+    void (*clamp)(const float* input, float* output, size_t count, float low, float high);
+    void (*floatToInt16)(const float* input, int16_t* output, size_t count);
+    // 24-bit values, sign-extended into int32 (range -8388608..8388607)
+    void (*floatToInt24)(const float* input, int32_t* output, size_t count);
+    // floatToInt16 with +-1 LSB TPDF dither added before rounding. rng holds DITHER_LANES
+    // xorshift32 states; sample i of a call draws from lane i % DITHER_LANES, so every ISA
+    // produces the same dither sequence
+    void (*floatToInt16Tpdf)(const float* input, int16_t* output, size_t count, uint32_t* rng);
+    // Sum of a[i] * b[i], the FIR inner loop
+    float (*dotProduct)(const float* a, const float* b, size_t count);
+
+    static constexpr size_t DITHER_LANES = 8;
+
+    // One TPDF dither value in LSB units, (-1, 1), from a single xorshift32 step:
+    // the difference of the two 16-bit halves is triangular
+    static inline float nextTpdf(uint32_t& state) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return static_cast<float>(static_cast<int32_t>(state >> 16) - static_cast<int32_t>(state & 0xFFFF)) *
+               (1.0f / 65536.0f);
+    }
+
+    static const SimdKernels& get();
+    static const SimdKernels* forIsa(Isa isa);  // nullptr if not compiled in or not supported by this CPU
+    static std::vector<Isa> availableIsas();
+};
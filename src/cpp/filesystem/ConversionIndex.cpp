@@ -0,0 +1,253 @@
+#include "ConversionIndex.h"
+#include "Logger.h"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace {
+const char* kIndexHeader = "M8INDEX\t2";
+const char* kIndexHeaderV1 = "M8INDEX\t1";  // Before audioHash; still read
+
+// Paths may legally contain tabs and newlines; keep one entry per line
+std::string escapeField(const std::string& value) {
+    std::string escaped;
+    escaped.reserve(value.size());
+    for (char c : value) {
+        switch (c) {
+            case '\\': escaped += "\\\\"; break;
+            case '\t': escaped += "\\t"; break;
+            case '\n': escaped += "\\n"; break;
+            default: escaped += c; break;
+        }
+    }
+    return escaped;
+}
+
+std::string unescapeField(const std::string& value) {
+    std::string unescaped;
+    unescaped.reserve(value.size());
+    for (size_t i = 0; i < value.size(); i++) {
+        if (value[i] == '\\' && i + 1 < value.size()) {
+            char next = value[++i];
+            unescaped += next == 't' ? '\t' : next == 'n' ? '\n' : next;
+        } else {
+            unescaped += value[i];
+        }
+    }
+    return unescaped;
+}
+
+std::vector<std::string> splitFields(const std::string& line) {
+    std::vector<std::string> fields;
+    size_t start = 0;
+    for (;;) {
+        size_t tab = line.find('\t', start);
+        fields.push_back(line.substr(start, tab - start));
+        if (tab == std::string::npos) break;
+        start = tab + 1;
+    }
+    return fields;
+}
+
+inline uint64_t mix(uint64_t hash, uint64_t word) {
+    hash ^= word;
+    hash *= 0x9E3779B97F4A7C15ULL;
+    return hash ^ (hash >> 29);
+}
+}
+
+ConversionIndex::ConversionIndex() = default;
+
+ConversionIndex::~ConversionIndex() = default;
+
+bool ConversionIndex::load(const std::string& indexPath) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.clear();
+
+    std::ifstream file(indexPath);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    std::string line;
+    if (!std::getline(file, line) || (line != kIndexHeader && line != kIndexHeaderV1)) {
+        Logger::getInstance().warning("Ignoring unrecognized conversion index: " + indexPath);
+        return false;
+    }
+    const size_t fieldCount = line == kIndexHeader ? 7 : 6;
+
+    size_t malformed = 0;
+    while (std::getline(file, line)) {
+        auto fields = splitFields(line);
+        if (fields.size() != fieldCount) {
+            malformed++;
+            continue;
+        }
+
+        try {
+            Entry entry;
+            entry.sourcePath = unescapeField(fields[0]);
+            entry.size = std::stoull(fields[1]);
+            entry.modifiedTime = std::stoll(fields[2]);
+            entry.contentHash = std::stoull(fields[3], nullptr, 16);
+            entry.optionsKey = unescapeField(fields[4]);
+            entry.outputPath = unescapeField(fields[5]);
+            if (fieldCount > 6) {
+                entry.audioHash = std::stoull(fields[6], nullptr, 16);
+            }
+            m_entries[entry.sourcePath] = std::move(entry);
+        } catch (const std::exception&) {
+            malformed++;
+        }
+    }
+
+    if (malformed > 0) {
+        Logger::getInstance().warning("Skipped " + std::to_string(malformed) + " malformed conversion index entries");
+    }
+    Logger::getInstance().debug("Loaded conversion index: " + std::to_string(m_entries.size()) + " entries");
+    return true;
+}
+
+bool ConversionIndex::save(const std::string& indexPath) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Write to a temporary file and rename so an interrupted run never leaves a truncated index
+    std::string tempPath = indexPath + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::trunc);
+        if (!file.is_open()) {
+            Logger::getInstance().error("Failed to write conversion index: " + tempPath);
+            return false;
+        }
+
+        file << kIndexHeader << '\n';
+        char hash[17];
+        char audioHash[17];
+        for (const auto& pair : m_entries) {
+            const Entry& entry = pair.second;
+            std::snprintf(hash, sizeof(hash), "%016llx", static_cast<unsigned long long>(entry.contentHash));
+            std::snprintf(audioHash, sizeof(audioHash), "%016llx", static_cast<unsigned long long>(entry.audioHash));
+            file << escapeField(entry.sourcePath) << '\t' << entry.size << '\t' << entry.modifiedTime << '\t'
+                 << hash << '\t' << escapeField(entry.optionsKey) << '\t' << escapeField(entry.outputPath) << '\t'
+                 << audioHash << '\n';
+        }
+
+        if (!file.good()) {
+            Logger::getInstance().error("Failed to write conversion index: " + tempPath);
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, indexPath, error);
+    if (error) {
+        Logger::getInstance().error("Failed to replace conversion index " + indexPath + ": " + error.message());
+        return false;
+    }
+    return true;
+}
+
+bool ConversionIndex::isUpToDate(const std::string& sourcePath, uint64_t size, int64_t modifiedTime,
+                                 const std::string& optionsKey, const std::string& outputPath, bool verifyHash) {
+    uint64_t storedHash;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_entries.find(sourcePath);
+        if (it == m_entries.end()) return false;
+
+        const Entry& entry = it->second;
+        if (entry.size != size || entry.optionsKey != optionsKey || entry.outputPath != outputPath) return false;
+        if (entry.modifiedTime == modifiedTime) return true;
+        if (!verifyHash || entry.contentHash == 0) return false;
+        storedHash = entry.contentHash;
+    }
+
+    // Touched but possibly unchanged: hash outside the lock
+    if (hashFile(sourcePath) != storedHash) return false;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_entries.find(sourcePath);
+    if (it != m_entries.end()) {
+        it->second.modifiedTime = modifiedTime;
+    }
+    return true;
+}
+
+void ConversionIndex::update(const Entry& entry) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries[entry.sourcePath] = entry;
+}
+
+void ConversionIndex::remove(const std::string& sourcePath) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.erase(sourcePath);
+}
+
+std::vector<ConversionIndex::Entry> ConversionIndex::pruneMissing(const std::unordered_set<std::string>& seenSources) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<Entry> removed;
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (seenSources.count(it->first) == 0) {
+            removed.push_back(std::move(it->second));
+            it = m_entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return removed;
+}
+
+size_t ConversionIndex::size() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.size();
+}
+
+void ConversionIndex::clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.clear();
+}
+
+std::vector<ConversionIndex::Entry> ConversionIndex::entries() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<Entry> result;
+    result.reserve(m_entries.size());
+    for (const auto& [sourcePath, entry] : m_entries) {
+        result.push_back(entry);
+    }
+    return result;
+}
+
+uint64_t ConversionIndex::hashFile(const std::string& filepath) {
+    std::FILE* file = std::fopen(filepath.c_str(), "rb");
+    if (!file) {
+        return 0;
+    }
+
+    static constexpr size_t kBufferSize = 1 << 20;
+    thread_local std::vector<unsigned char> buffer(kBufferSize);
+
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    uint64_t length = 0;
+    size_t bytesRead;
+    while ((bytesRead = std::fread(buffer.data(), 1, kBufferSize, file)) > 0) {
+        size_t words = bytesRead / 8;
+        for (size_t i = 0; i < words; i++) {
+            uint64_t word;
+            std::memcpy(&word, buffer.data() + i * 8, 8);
+            hash = mix(hash, word);
+        }
+        // Only the final read can be short, so the tail is always at the end of the file
+        uint64_t tail = 0;
+        std::memcpy(&tail, buffer.data() + words * 8, bytesRead - words * 8);
+        if (bytesRead % 8 != 0) {
+            hash = mix(hash, tail);
+        }
+        length += bytesRead;
+    }
+    std::fclose(file);
+
+    hash = mix(hash, length);
+    return hash == 0 ? 1 : hash;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// On-disk record of what a previous run produced, so re-runs only touch changed samples.
+// Keyed by source path; an entry is current while size, mtime (or content hash), options
+// and output path all still match.
+class ConversionIndex {
+public:
+    struct Entry {
+        std::string sourcePath;
+        uint64_t size = 0;
+        int64_t modifiedTime = 0;
+        uint64_t contentHash = 0;  // 0 = not computed
+        std::string optionsKey;
+        std::string outputPath;
+        uint64_t audioHash = 0;    // Deduplication key of the source's audio (ConversionJob::audioHash), 0 = none
+    };
+
+    static constexpr const char* DEFAULT_FILENAME = ".m8index";
+
+    ConversionIndex();
+    ~ConversionIndex();
+
+    // Persistence (load starts empty on a missing or unreadable index)
+    bool load(const std::string& indexPath);
+    bool save(const std::string& indexPath) const;
+
+    // A match on size and mtime is enough; with verifyHash a touched-but-identical file
+    // also counts as current and its stored mtime is refreshed
+    bool isUpToDate(const std::string& sourcePath, uint64_t size, int64_t modifiedTime,
+                    const std::string& optionsKey, const std::string& outputPath, bool verifyHash = false);
+
+    void update(const Entry& entry);
+    void remove(const std::string& sourcePath);
+
+    // Drop entries whose source was not seen in this run and return them so outputs can be deleted
+    std::vector<Entry> pruneMissing(const std::unordered_set<std::string>& seenSources);
+
+    size_t size() const;
+    void clear();
+    // Snapshot of every entry
+    std::vector<Entry> entries() const;
+
+    // 64-bit content hash of a file (0 if it cannot be read)
+    static uint64_t hashFile(const std::string& filepath);
+
+private:
+    mutable std::mutex m_mutex;
+    std::unordered_map<std::string, Entry> m_entries;
+};
@@ -0,0 +1,227 @@
+#include "DirectoryWatcher.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <unordered_set>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+DirectoryWatcher::DirectoryWatcher() = default;
+
+DirectoryWatcher::~DirectoryWatcher() {
+#ifdef __linux__
+    if (m_inotifyFd >= 0) {
+        ::close(m_inotifyFd);
+    }
+    if (m_wakeFd >= 0) {
+        ::close(m_wakeFd);
+    }
+#endif
+}
+
+bool DirectoryWatcher::isSupported() {
+#ifdef __linux__
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool DirectoryWatcher::start(const std::string& root, const std::vector<std::string>& ignoreFolders) {
+    Logger& logger = Logger::getInstance();
+#ifdef __linux__
+    if (m_inotifyFd < 0) {
+        m_inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        m_wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (m_inotifyFd < 0 || m_wakeFd < 0) {
+            logger.error("Cannot watch for file changes: " + std::string(std::strerror(errno)));
+            return false;
+        }
+    }
+
+    m_ignoreFolders = ignoreFolders;
+    Changes unused;
+    watchTree(root, false, unused);
+    if (m_directories.empty()) {
+        logger.error("Cannot watch directory: " + root);
+        return false;
+    }
+    logger.debug("Watching " + std::to_string(m_directories.size()) + " folders under " + root);
+    return true;
+#else
+    (void)ignoreFolders;
+    logger.error("Cannot watch " + root + ": watch mode needs inotify, which is only available on Linux");
+    return false;
+#endif
+}
+
+void DirectoryWatcher::stop() {
+    m_stopped.store(true);
+#ifdef __linux__
+    if (m_wakeFd >= 0) {
+        uint64_t one = 1;
+        ssize_t written = ::write(m_wakeFd, &one, sizeof(one));  // Only write(): this may run in a signal handler
+        (void)written;
+    }
+#endif
+}
+
+bool DirectoryWatcher::isIgnored(const std::string& name) const {
+    return std::find(m_ignoreFolders.begin(), m_ignoreFolders.end(), name) != m_ignoreFolders.end();
+}
+
+void DirectoryWatcher::watchTree(const std::string& directory, bool report, Changes& changes) {
+#ifdef __linux__
+    int wd = inotify_add_watch(m_inotifyFd, directory.c_str(),
+                               IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE_SELF | IN_ONLYDIR);
+    if (wd < 0) {
+        std::string reason = errno == ENOSPC ? "watch limit reached (raise fs.inotify.max_user_watches)"
+                                             : std::string(std::strerror(errno));
+        Logger::getInstance().warning("Cannot watch " + directory + ": " + reason);
+        return;
+    }
+    m_directories[wd] = directory;
+    if (m_rootWd < 0) {
+        m_rootWd = wd;
+    }
+
+    // Files written before the watch existed have had their events already
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, ec)) {
+        std::filesystem::file_status status = entry.symlink_status(ec);
+        if (std::filesystem::is_directory(status)) {
+            if (!isIgnored(entry.path().filename().string())) {
+                watchTree(entry.path().string(), report, changes);
+            }
+        } else if (report && std::filesystem::is_regular_file(status)) {
+            changes.files.push_back(entry.path().string());
+        }
+    }
+#else
+    (void)directory;
+    (void)report;
+    (void)changes;
+#endif
+}
+
+int DirectoryWatcher::poll(int timeoutMs) {
+#ifdef __linux__
+    pollfd fds[2] = {{m_inotifyFd, POLLIN, 0}, {m_wakeFd, POLLIN, 0}};
+    int ready = ::poll(fds, 2, timeoutMs);
+    if (ready == 0) {
+        return 0;
+    }
+    return ready > 0 && !isStopped() && (fds[0].revents & POLLIN) ? 1 : -1;
+#else
+    (void)timeoutMs;
+    return -1;
+#endif
+}
+
+void DirectoryWatcher::readEvents(Changes& changes) {
+#ifdef __linux__
+    alignas(inotify_event) char buffer[64 * 1024];
+    for (;;) {
+        ssize_t length = ::read(m_inotifyFd, buffer, sizeof(buffer));
+        if (length <= 0) {
+            return;  // EAGAIN: drained
+        }
+
+        for (char* next = buffer; next < buffer + length;) {
+            const inotify_event* event = reinterpret_cast<const inotify_event*>(next);
+            next += sizeof(inotify_event) + event->len;
+
+            if (event->mask & IN_Q_OVERFLOW) {
+                changes.overflowed = true;
+                continue;
+            }
+            auto directory = m_directories.find(event->wd);
+            if (directory == m_directories.end()) {
+                continue;
+            }
+            if (event->mask & (IN_IGNORED | IN_DELETE_SELF)) {
+                if (event->wd == m_rootWd) {
+                    // Nothing more can arrive; waiting on would poll an empty tree forever
+                    Logger::getInstance().error("Stopped watching " + directory->second +
+                                                ": the folder was deleted or unmounted");
+                    m_lostRoot.store(true);
+                    stop();
+                }
+                // A folder moved within the tree keeps its watch: IN_MOVED_TO on the new parent renames it
+                m_directories.erase(directory);
+                continue;
+            }
+            if (event->len == 0) {
+                continue;
+            }
+
+            std::string path = directory->second + "/" + event->name;
+            if (event->mask & IN_ISDIR) {
+                if ((event->mask & (IN_CREATE | IN_MOVED_TO)) && !isIgnored(event->name)) {
+                    watchTree(path, true, changes);
+                }
+            } else if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) {
+                changes.files.push_back(path);
+            }
+        }
+    }
+#else
+    (void)changes;
+#endif
+}
+
+DirectoryWatcher::Changes DirectoryWatcher::waitForChanges(std::chrono::milliseconds debounce,
+                                                           std::chrono::milliseconds timeout,
+                                                           std::chrono::milliseconds maxBatch) {
+    using Clock = std::chrono::steady_clock;
+    auto millisUntil = [](Clock::time_point deadline) {
+        auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now()).count();
+        return static_cast<int>(std::max<int64_t>(0, left));
+    };
+
+    Changes changes;
+    if (m_inotifyFd < 0) {
+        return changes;
+    }
+
+    // The first change (an empty new folder does not count)
+    Clock::time_point deadline = Clock::now() + timeout;
+    while (changes.files.empty() && !changes.overflowed) {
+        if (isStopped() || Clock::now() >= deadline) {
+            return changes;
+        }
+        if (poll(millisUntil(deadline)) > 0) {
+            readEvents(changes);
+        }
+    }
+
+    // The rest of the burst: until it has been quiet for debounce
+    Clock::time_point batchEnd = Clock::now() + maxBatch;
+    while (!isStopped()) {
+        Clock::time_point quietUntil = std::min(Clock::now() + debounce, batchEnd);
+        int ready = poll(millisUntil(quietUntil));
+        if (ready == 0 || Clock::now() >= batchEnd) {
+            break;
+        }
+        if (ready > 0) {
+            readEvents(changes);
+        }
+    }
+    if (!isStopped()) {
+        readEvents(changes);
+    }
+
+    // A file closed several times in the burst is reported once
+    std::unordered_set<std::string> seen;
+    changes.files.erase(std::remove_if(changes.files.begin(), changes.files.end(),
+                                       [&seen](const std::string& file) { return !seen.insert(file).second; }),
+                        changes.files.end());
+    return changes;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Reports files that finished changing under a directory tree, for watch mode.
+//
+// Uses inotify (Linux only; elsewhere start() fails). Every folder in the tree
+// gets a watch, including folders created or moved in later, whose files are
+// reported at once since they may have been written before the watch existed.
+// A file counts as changed when it is closed after writing or moved in, so a
+// sample still being copied is never picked up half-written.
+//
+// waitForChanges() debounces: after the first event it keeps collecting until
+// the tree has been quiet for the debounce interval, so a pack being unpacked
+// arrives as one batch instead of a file at a time.
+//
+// If the root itself is deleted or unmounted the watcher stops, as if stop()
+// had been called, and lostRoot() says why.
+class DirectoryWatcher {
+public:
+    struct Changes {
+        std::vector<std::string> files;  // Each path once, in the order first seen
+        bool overflowed = false;         // The kernel dropped events: rescan the whole tree
+    };
+
+    DirectoryWatcher();
+    ~DirectoryWatcher();
+
+    DirectoryWatcher(const DirectoryWatcher&) = delete;
+    DirectoryWatcher& operator=(const DirectoryWatcher&) = delete;
+
+    // Watches root and every folder below it, except folders named in ignoreFolders
+    bool start(const std::string& root, const std::vector<std::string>& ignoreFolders = {});
+
+    // Blocks until something changes (or timeout passes, or stop() is called), then collects until
+    // nothing has changed for debounce, but never for longer than maxBatch after the first event
+    Changes waitForChanges(std::chrono::milliseconds debounce, std::chrono::milliseconds timeout,
+                           std::chrono::milliseconds maxBatch = std::chrono::milliseconds(1000));
+
+    // Wakes waitForChanges and makes it return immediately from then on; callable from any
+    // thread or a signal handler
+    void stop();
+    bool isStopped() const { return m_stopped.load(); }
+    // Stopped because the root folder was deleted or unmounted
+    bool lostRoot() const { return m_lostRoot.load(); }
+
+    size_t getWatchCount() const { return m_directories.size(); }
+
+    static bool isSupported();
+
+private:
+    int m_inotifyFd = -1;
+    int m_wakeFd = -1;
+    std::vector<std::string> m_ignoreFolders;
+    std::unordered_map<int, std::string> m_directories;  // Watch descriptor -> folder
+    int m_rootWd = -1;
+    std::atomic<bool> m_stopped{false};
+    std::atomic<bool> m_lostRoot{false};
+
+    // Watches directory and its subfolders; with report, the files already in them are added to changes
+    void watchTree(const std::string& directory, bool report, Changes& changes);
+    bool isIgnored(const std::string& name) const;
+    // Reads whatever events are queued into changes
+    void readEvents(Changes& changes);
+    // 1 when events are waiting, 0 when timeoutMs passed without any, -1 when woken or interrupted
+    int poll(int timeoutMs);
+};
@@ -2,6 +2,21 @@
 #include "Logger.h"
 #include <filesystem>
 #include <fstream>
+#include <cerrno>
+#include <cstring>
+
+#if defined(__APPLE__)
+#include <copyfile.h>
+#include <fcntl.h>
+#include <sys/clonefile.h>
+#include <unistd.h>
+#elif defined(__linux__)
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 FileOperations::FileOperations() {
     Logger::getInstance().debug("FileOperations initialized");
@@ -20,6 +35,96 @@ bool FileOperations::copyFile(const std::string& source, const std::string& dest
     }
 }
 
+bool FileOperations::cloneFile(const std::string& source, const std::string& destination) {
+    // A new file, never the old one truncated: the destination may be a hard link whose other
+    // names must keep their bytes (and clonefile refuses to replace an existing file)
+    std::error_code removeError;
+    std::filesystem::remove(destination, removeError);
+#if defined(__APPLE__)
+    if (::clonefile(source.c_str(), destination.c_str(), 0) == 0) {
+        return true;
+    }
+    if (::copyfile(source.c_str(), destination.c_str(), nullptr, COPYFILE_DATA) == 0) {
+        return true;
+    }
+    Logger::getInstance().error("Failed to copy file " + source + ": " + std::string(std::strerror(errno)));
+    return false;
+#elif defined(__linux__)
+    int in = ::open(source.c_str(), O_RDONLY | O_CLOEXEC);
+    if (in < 0) {
+        Logger::getInstance().error("Failed to open file " + source + ": " + std::string(std::strerror(errno)));
+        return false;
+    }
+    int out = ::open(destination.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (out < 0) {
+        Logger::getInstance().error("Failed to create file " + destination + ": " + std::string(std::strerror(errno)));
+        ::close(in);
+        return false;
+    }
+
+    bool success = ::ioctl(out, FICLONE, in) == 0;  // Shares extents on btrfs/XFS
+    if (!success) {
+        struct stat st;
+        success = ::fstat(in, &st) == 0;
+        off_t remaining = success ? st.st_size : 0;
+        while (success && remaining > 0) {
+            ssize_t copied = ::copy_file_range(in, nullptr, out, nullptr, static_cast<size_t>(remaining), 0);
+            if (copied < 0 && errno == EINTR) {
+                continue;
+            }
+            if (copied <= 0) {
+                success = false;
+                break;
+            }
+            remaining -= copied;
+        }
+        if (!success && (errno == ENOSYS || errno == EXDEV || errno == EINVAL || errno == EOPNOTSUPP)) {
+            // Kernel or filesystem without copy_file_range: plain read/write loop
+            success = ::lseek(in, 0, SEEK_SET) == 0 && ::ftruncate(out, 0) == 0 && ::lseek(out, 0, SEEK_SET) == 0;
+            char buffer[1 << 16];
+            while (success) {
+                ssize_t count = ::read(in, buffer, sizeof(buffer));
+                if (count < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (count <= 0) {
+                    success = count == 0;
+                    break;
+                }
+                for (ssize_t written = 0; written < count;) {
+                    ssize_t n = ::write(out, buffer + written, static_cast<size_t>(count - written));
+                    if (n < 0 && errno == EINTR) {
+                        continue;
+                    }
+                    if (n <= 0) {
+                        success = false;
+                        break;
+                    }
+                    written += n;
+                }
+            }
+        }
+        if (!success) {
+            Logger::getInstance().error("Failed to copy file " + source + ": " + std::string(std::strerror(errno)));
+        }
+    }
+
+    ::close(in);
+    if (::close(out) != 0) {
+        success = false;
+    }
+    return success;
+#else
+    std::error_code ec;
+    std::filesystem::copy_file(source, destination, std::filesystem::copy_options::overwrite_existing, ec);
+    if (ec) {
+        Logger::getInstance().error("Failed to copy file " + source + ": " + ec.message());
+        return false;
+    }
+    return true;
+#endif
+}
+
 bool FileOperations::moveFile(const std::string& source, const std::string& destination) {
     try {
         std::filesystem::rename(source, destination);
@@ -12,6 +12,12 @@ public:
     bool copyFile(const std::string& source, const std::string& destination);
     bool moveFile(const std::string& source, const std::string& destination);
     bool deleteFile(const std::string& filepath);
+
+    // Copies without going through userspace buffers where the OS allows it:
+    // clonefile/fcopyfile on macOS, FICLONE reflink or copy_file_range on Linux.
+    // Replaces the destination with a new file, so other hard links to it keep
+    // their contents. Thread-safe; errors go to the Logger.
+    static bool cloneFile(const std::string& source, const std::string& destination);
     
     // Directory operations
     bool createDirectory(const std::string& path);
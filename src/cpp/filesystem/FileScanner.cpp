@@ -1,7 +1,31 @@
 #include "FileScanner.h"
 #include "Logger.h"
+#include "StageProfiler.h"
+#include "TraceRecorder.h"
+#include "ThreadPool.h"
 #include <filesystem>
 #include <algorithm>
+#include <unordered_set>
+#include <sys/stat.h>
+
+struct FileScanner::WalkContext {
+    std::string rootDirectory;
+    std::unordered_set<std::string> ignoreFolders;  // Lowercased
+    ThreadPool* pool = nullptr;
+    std::mutex resultsMutex;
+    std::vector<AudioFile> results;
+};
+
+namespace {
+int64_t modifiedTimeOf(const struct stat& info) {
+#ifdef __APPLE__
+    const struct timespec& time = info.st_mtimespec;
+#else
+    const struct timespec& time = info.st_mtim;
+#endif
+    return static_cast<int64_t>(time.tv_sec) * 1000000000LL + time.tv_nsec;
+}
+}
 
 FileScanner::FileScanner() {
     Logger::getInstance().debug("FileScanner initialized");
@@ -15,9 +39,33 @@ std::vector<AudioFile> FileScanner::scanDirectory(const std::string& directory,
     m_totalFiles = 0;
     m_validFiles = 0;
     m_skippedFiles = 0;
+    m_rejectedFiles = 0;
     
     Logger::getInstance().info("Scanning directory: " + directory);
-    scanDirectoryRecursive(directory, ignoreFolders, results);
+
+    WalkContext context;
+    context.rootDirectory = directory;
+    for (const auto& ignoreFolder : ignoreFolders) {
+        std::string lowerIgnore = ignoreFolder;
+        std::transform(lowerIgnore.begin(), lowerIgnore.end(), lowerIgnore.begin(), ::tolower);
+        context.ignoreFolders.insert(lowerIgnore);
+    }
+
+    // Directory listing is I/O-bound, so use at least a few threads even on small machines
+    size_t threads = m_scanThreads > 0 ? m_scanThreads
+                                       : std::max<size_t>(4, std::thread::hardware_concurrency());
+    ThreadPool pool(threads, "scan");
+    context.pool = &pool;
+    pool.enqueue([this, &directory, &context] {
+        walkDirectory(directory, context);
+    });
+    pool.waitForAll();
+
+    // Walk order depends on thread timing; keep the result deterministic
+    results = std::move(context.results);
+    std::sort(results.begin(), results.end(), [](const AudioFile& a, const AudioFile& b) {
+        return a.filepath < b.filepath;
+    });
     
     Logger::getInstance().info("Scan complete: " + std::to_string(results.size()) + " files found");
     return results;
@@ -29,6 +77,14 @@ std::vector<AudioFile> FileScanner::scanFileList(const std::string& fileListPath
     return results;
 }
 
+void FileScanner::setScanThreads(size_t threads) {
+    m_scanThreads = threads;
+}
+
+void FileScanner::setProbeHeaders(bool probe) {
+    m_probeHeaders = probe;
+}
+
 void FileScanner::setProgressCallback(std::function<void(size_t, size_t)> callback) {
     m_progressCallback = callback;
 }
@@ -50,13 +106,17 @@ void FileScanner::setMinFileSize(size_t minSize) {
 }
 
 bool FileScanner::isValidAudioFile(const std::string& filepath) {
-    if (!checkFileExists(filepath)) return false;
-    if (!checkFilePermissions(filepath)) return false;
+    // One stat covers existence and type
+    struct stat info;
+    if (::stat(filepath.c_str(), &info) != 0 || !S_ISREG(info.st_mode)) return false;
     
-    std::string ext = filepath.substr(filepath.find_last_of('.'));
+    size_t dot = filepath.find_last_of('.');
+    if (dot == std::string::npos) return false;
+    std::string ext = filepath.substr(dot);
     std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+    if (!isSupportedExtension(ext)) return false;
     
-    return isSupportedExtension(ext);
+    return !m_probeHeaders || AudioProbe::probe(filepath).status != AudioProbe::INVALID;
 }
 
 bool FileScanner::isSupportedExtension(const std::string& extension) {
@@ -88,104 +148,161 @@ void FileScanner::cancel() {
     m_cancelled = true;
 }
 
-void FileScanner::scanDirectoryRecursive(const std::string& directory, 
-                                        const std::vector<std::string>& ignoreFolders,
-                                        std::vector<AudioFile>& results) {
-    try {
-        std::filesystem::recursive_directory_iterator iter(directory, 
-            std::filesystem::directory_options::skip_permission_denied);
-        
-        for (const auto& entry : iter) {
-            if (m_cancelled) break;
-            
-            try {
-                if (entry.is_directory()) {
-                    // Check if this directory should be ignored
-                    std::string dirname = entry.path().filename().string();
-                    if (shouldIgnoreDirectory(dirname, ignoreFolders)) {
-                        iter.disable_recursion_pending();
-                        Logger::getInstance().debug("Skipping ignored directory: " + dirname);
-                        continue;
-                    }
-                }
-                
-                if (entry.is_regular_file()) {
-                    std::string filepath = entry.path().string();
-                    std::string filename = entry.path().filename().string();
-                    
-                    m_totalFiles++;
-                    
-                    if (isValidAudioFile(filepath)) {
-                        AudioFile audioFile = createAudioFile(filepath, directory);
-                        if (isFileSizeValid(audioFile.fileSize)) {
-                            results.push_back(audioFile);
-                            m_validFiles++;
-                            
-                            if (m_fileCallback) {
-                                m_fileCallback(audioFile);
-                            }
-                        } else {
-                            m_skippedFiles++;
-                        }
-                    } else {
-                        m_skippedFiles++;
-                    }
-                    
-                    if (m_progressCallback) {
-                        m_progressCallback(m_validFiles, m_totalFiles);
-                    }
-                }
-            } catch (const std::filesystem::filesystem_error& e) {
-                // Skip individual files that cause errors (permission denied, symlinks, etc.)
-                Logger::getInstance().warning("Skipping file/dir due to error: " + std::string(e.what()));
+void FileScanner::walkDirectory(const std::string& directory, WalkContext& context) {
+    std::error_code error;
+    std::filesystem::directory_iterator iter(directory, std::filesystem::directory_options::skip_permission_denied, error);
+    if (error) {
+        if (directory == context.rootDirectory) {
+            Logger::getInstance().error("Error scanning directory: " + error.message());
+        } else {
+            Logger::getInstance().warning("Skipping directory due to error: " + directory + ": " + error.message());
+        }
+        return;
+    }
+
+    TraceRecorder::Span span("list", "scan", directory);
+    // Listing time only: probing and planning the files found are profiled as stages of their own
+    StageProfiler& profiler = StageProfiler::getInstance();
+    const uint64_t started = profiler.isEnabled() ? StageProfiler::now() : 0;
+    uint64_t profiledNanos = 0;
+
+    std::vector<AudioFile> found;
+    for (std::filesystem::directory_iterator end; iter != end; iter.increment(error)) {
+        if (error) {
+            Logger::getInstance().warning("Stopped reading directory " + directory + ": " + error.message());
+            break;
+        }
+        if (m_cancelled) break;
+
+        // The entry type comes from readdir (d_type), so files and directories need no stat here
+        const auto& entry = *iter;
+        std::error_code typeError;
+        if (entry.is_symlink(typeError)) {
+            // Linked files are picked up, linked directories are not followed
+            if (entry.is_regular_file(typeError)) {
+                addFile(entry.path().string(), context, found, profiledNanos);
+            }
+        } else if (entry.is_directory(typeError)) {
+            std::string dirname = entry.path().filename().string();
+            std::transform(dirname.begin(), dirname.end(), dirname.begin(), ::tolower);
+            if (context.ignoreFolders.count(dirname) > 0) {
+                Logger::getInstance().debug("Skipping ignored directory: " + entry.path().filename().string());
                 continue;
             }
+
+            // Fan subdirectories out across the pool; nested submits stay on this worker's deque
+            std::string subdirectory = entry.path().string();
+            context.pool->enqueue([this, subdirectory, &context] {
+                walkDirectory(subdirectory, context);
+            });
+        } else if (entry.is_regular_file(typeError)) {
+            addFile(entry.path().string(), context, found, profiledNanos);
         }
-    } catch (const std::exception& e) {
-        Logger::getInstance().error("Error scanning directory: " + std::string(e.what()));
+    }
+
+    if (!found.empty()) {
+        std::lock_guard<std::mutex> lock(context.resultsMutex);
+        context.results.insert(context.results.end(),
+                               std::make_move_iterator(found.begin()), std::make_move_iterator(found.end()));
+    }
+    if (started > 0) {
+        profiler.record(StageProfiler::SCAN, StageProfiler::now() - started - profiledNanos);
     }
 }
 
-bool FileScanner::shouldIgnoreDirectory(const std::string& dirname, const std::vector<std::string>& ignoreFolders) {
-    std::string lowerDirname = dirname;
-    std::transform(lowerDirname.begin(), lowerDirname.end(), lowerDirname.begin(), ::tolower);
-    
-    for (const auto& ignoreFolder : ignoreFolders) {
-        std::string lowerIgnore = ignoreFolder;
-        std::transform(lowerIgnore.begin(), lowerIgnore.end(), lowerIgnore.begin(), ::tolower);
-        
-        if (lowerDirname == lowerIgnore) {
-            return true;
+void FileScanner::addFile(const std::string& filepath, WalkContext& context, std::vector<AudioFile>& found,
+                          uint64_t& profiledNanos) {
+    m_totalFiles++;
+
+    AudioFile audioFile;
+    bool accepted = acceptFile(filepath, context.rootDirectory, audioFile, profiledNanos);
+    if (accepted) {
+        m_validFiles++;
+        if (m_fileCallback) {
+            StageProfiler::Timer timer(profiledNanos);
+            std::lock_guard<std::mutex> lock(m_callbackMutex);
+            m_fileCallback(audioFile);
         }
+        found.push_back(std::move(audioFile));
+    } else {
+        m_skippedFiles++;
+    }
+
+    if (m_progressCallback) {
+        std::lock_guard<std::mutex> lock(m_callbackMutex);
+        m_progressCallback(m_validFiles, m_totalFiles);
     }
-    
-    return false;
 }
 
-AudioFile FileScanner::createAudioFile(const std::string& filepath, const std::string& rootDirectory) {
+bool FileScanner::scanFile(const std::string& filepath, const std::string& rootDirectory, AudioFile& audioFile) {
+    uint64_t profiledNanos = 0;
+    return acceptFile(filepath, rootDirectory, audioFile, profiledNanos);
+}
+
+bool FileScanner::statFile(const std::string& filepath, uint64_t& size, int64_t& modifiedTime) {
+    struct stat info;
+    if (::stat(filepath.c_str(), &info) != 0 || !S_ISREG(info.st_mode)) {
+        return false;
+    }
+    size = static_cast<uint64_t>(info.st_size);
+    modifiedTime = modifiedTimeOf(info);
+    return true;
+}
+
+bool FileScanner::acceptFile(const std::string& filepath, const std::string& rootDirectory, AudioFile& audioFile,
+                             uint64_t& profiledNanos) {
+    // Reject by extension before touching the disk
+    size_t dot = filepath.find_last_of('.');
+    size_t slash = filepath.find_last_of('/');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+        return false;
+    }
+    std::string ext = filepath.substr(dot);
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+    if (!isSupportedExtension(ext)) {
+        return false;
+    }
+
+    // One stat gives existence, type, size and mtime
+    struct stat info;
+    if (::stat(filepath.c_str(), &info) != 0 || !S_ISREG(info.st_mode)) {
+        return false;
+    }
+    audioFile = createAudioFile(filepath, rootDirectory, static_cast<size_t>(info.st_size), modifiedTimeOf(info));
+    if (!isFileSizeValid(audioFile.fileSize)) {
+        return false;
+    }
+    StageProfiler::Timer timer(profiledNanos);
+    return probeFile(audioFile);
+}
+
+AudioFile FileScanner::createAudioFile(const std::string& filepath, const std::string& rootDirectory, size_t fileSize, int64_t modifiedTime) {
     AudioFile file;
     file.filepath = filepath;
     file.filename = filepath.substr(filepath.find_last_of('/') + 1);
     file.extension = filepath.substr(filepath.find_last_of('.'));
-    file.fileSize = getFileSize(filepath);
+    file.fileSize = fileSize;
+    file.modifiedTime = modifiedTime;
     file.packName = extractPackName(filepath, rootDirectory);
     file.isProcessed = false;
     
     return file;
 }
 
-bool FileScanner::checkFileExists(const std::string& filepath) {
-    return std::filesystem::exists(filepath);
-}
-
-bool FileScanner::checkFilePermissions(const std::string& filepath) {
-    return std::filesystem::is_regular_file(filepath);
-}
+bool FileScanner::probeFile(AudioFile& audioFile) {
+    if (!m_probeHeaders) {
+        return true;
+    }
 
-size_t FileScanner::getFileSize(const std::string& filepath) {
-    try {
-        return std::filesystem::file_size(filepath);
-    } catch (const std::exception&) {
-        return 0;
+    {
+        StageProfiler::Timer timer(StageProfiler::PROBE);
+        TraceRecorder::Span span("probe", "scan", audioFile.filepath, audioFile.fileSize);
+        audioFile.probe = AudioProbe::probe(audioFile.filepath);
+    }
+    if (audioFile.probe.status == AudioProbe::INVALID) {
+        m_rejectedFiles++;
+        Logger::getInstance().warning("Skipping unreadable audio file " + audioFile.filepath + ": " + audioFile.probe.error);
+        return false;
     }
+    return true;
 }
@@ -1,18 +1,23 @@
 #pragma once
 
+#include "AudioProbe.h"
 #include <string>
 #include <vector>
 #include <functional>
 #include <atomic>
+#include <cstdint>
+#include <mutex>
 
 struct AudioFile {
     std::string filepath;
     std::string filename;
     std::string extension;
     size_t fileSize;
+    int64_t modifiedTime = 0;  // Nanoseconds since the Unix epoch
     std::string packName;
     bool isProcessed = false;
     std::string error;
+    AudioProbe::Result probe;  // Header probe, filled when the scanner probes headers
 };
 
 class FileScanner {
@@ -23,8 +28,19 @@ public:
     // Scanning
     std::vector<AudioFile> scanDirectory(const std::string& directory, const std::vector<std::string>& ignoreFolders = {});
     std::vector<AudioFile> scanFileList(const std::string& fileListPath);
+    // One file, checked and probed as a scan would; false if a scan would have skipped it
+    bool scanFile(const std::string& filepath, const std::string& rootDirectory, AudioFile& audioFile);
+    // Size and modification time as a scan records them; false when filepath is not a regular file
+    static bool statFile(const std::string& filepath, uint64_t& size, int64_t& modifiedTime);
     
-    // Progress tracking
+    // Subdirectories are walked in parallel (0 = pick from hardware_concurrency)
+    void setScanThreads(size_t threads);
+
+    // Parse each candidate's header while scanning; corrupt or undecodable files are
+    // rejected here instead of failing later in the conversion pipeline
+    void setProbeHeaders(bool probe);
+
+    // Progress tracking (callbacks are serialized, but arrive from scanner threads as files are found)
     void setProgressCallback(std::function<void(size_t, size_t)> callback);
     void setFileCallback(std::function<void(const AudioFile&)> callback);
     
@@ -46,6 +62,7 @@ public:
     size_t getTotalFiles() const { return m_totalFiles; }
     size_t getValidFiles() const { return m_validFiles; }
     size_t getSkippedFiles() const { return m_skippedFiles; }
+    size_t getRejectedFiles() const { return m_rejectedFiles; }  // Failed the header probe
     
     // Control
     void cancel();
@@ -56,24 +73,31 @@ private:
     size_t m_maxFileSize = 0; // 0 = no limit
     size_t m_minFileSize = 0;
     
+    size_t m_scanThreads = 0;
+    bool m_probeHeaders = false;
+
     std::function<void(size_t, size_t)> m_progressCallback;
     std::function<void(const AudioFile&)> m_fileCallback;
+    std::mutex m_callbackMutex;
     
     std::atomic<bool> m_cancelled{false};
     std::atomic<size_t> m_totalFiles{0};
     std::atomic<size_t> m_validFiles{0};
     std::atomic<size_t> m_skippedFiles{0};
+    std::atomic<size_t> m_rejectedFiles{0};
     
     // Internal scanning
-    void scanDirectoryRecursive(const std::string& directory, 
-                               const std::vector<std::string>& ignoreFolders,
-                               std::vector<AudioFile>& results);
-    
-    bool shouldIgnoreDirectory(const std::string& dirname, const std::vector<std::string>& ignoreFolders);
-    AudioFile createAudioFile(const std::string& filepath, const std::string& rootDirectory);
+    struct WalkContext;
+    void walkDirectory(const std::string& directory, WalkContext& context);
+    // profiledNanos accumulates the time spent probing and in the file callback
+    void addFile(const std::string& filepath, WalkContext& context, std::vector<AudioFile>& found,
+                 uint64_t& profiledNanos);
+    // Extension, size and header checks; profiledNanos accumulates the time spent probing
+    bool acceptFile(const std::string& filepath, const std::string& rootDirectory, AudioFile& audioFile,
+                    uint64_t& profiledNanos);
+
+    AudioFile createAudioFile(const std::string& filepath, const std::string& rootDirectory, size_t fileSize, int64_t modifiedTime);
     
     // File validation
-    bool checkFileExists(const std::string& filepath);
-    bool checkFilePermissions(const std::string& filepath);
-    size_t getFileSize(const std::string& filepath);
+    bool probeFile(AudioFile& audioFile);
 };
@@ -0,0 +1,275 @@
+#include "JobPlan.h"
+#include "ContentHash.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <type_traits>
+
+namespace {
+const char kPlanMagic[8] = {'M', '8', 'P', 'L', 'A', 'N', 0, 2};  // Last byte is the format version
+
+class PlanWriter {
+public:
+    void put(uint64_t value, int bytes) {
+        for (int b = 0; b < bytes; b++) {
+            m_data += static_cast<char>((value >> (8 * b)) & 0xFF);
+        }
+    }
+    void putString(const std::string& value) {
+        put(value.size(), 4);
+        m_data += value;
+    }
+    void putRaw(const char* data, size_t size) { m_data.append(data, size); }
+    const std::string& data() const { return m_data; }
+
+private:
+    std::string m_data;
+};
+
+// Bounds-checked; after the first short read every get fails
+class PlanReader {
+public:
+    PlanReader(const char* data, size_t size) : m_data(data), m_size(size) {}
+
+    bool get(uint64_t& value, int bytes) {
+        if (m_size - m_pos < static_cast<size_t>(bytes)) {
+            m_pos = m_size;
+            m_ok = false;
+            return false;
+        }
+        value = 0;
+        for (int b = 0; b < bytes; b++) {
+            value |= static_cast<uint64_t>(static_cast<unsigned char>(m_data[m_pos++])) << (8 * b);
+        }
+        return true;
+    }
+    template <typename T>
+    bool getAs(T& value, int bytes) {
+        uint64_t raw = 0;
+        bool ok = get(raw, bytes);
+        // Sign-extend narrower fields so negative ints survive the round trip
+        if (bytes < 8 && (raw >> (8 * bytes - 1)) & 1 && std::is_signed<T>::value) {
+            raw |= ~0ULL << (8 * bytes);
+        }
+        value = static_cast<T>(raw);
+        return ok;
+    }
+    bool getString(std::string& value) {
+        uint64_t length = 0;
+        if (!get(length, 4) || m_size - m_pos < length) {
+            m_ok = false;
+            return false;
+        }
+        value.assign(m_data + m_pos, static_cast<size_t>(length));
+        m_pos += static_cast<size_t>(length);
+        return true;
+    }
+    bool ok() const { return m_ok; }
+    bool atEnd() const { return m_pos == m_size; }
+
+private:
+    const char* m_data;
+    size_t m_size;
+    size_t m_pos = 0;
+    bool m_ok = true;
+};
+
+enum JobFlags : uint8_t {
+    kBigEndian = 1,
+    kStereo = 2,
+    kPcm = 4,
+    kUpToDate = 8
+};
+
+// Job paths are joined to the roots the plan is executed with, so they must stay beneath them
+bool staysUnderRoot(const std::string& path) {
+    std::filesystem::path relative(path);
+    if (path.empty() || relative.has_root_path()) {
+        return false;
+    }
+    return std::none_of(relative.begin(), relative.end(),
+                        [](const std::filesystem::path& part) { return part == ".."; });
+}
+}
+
+bool JobPlan::save(const std::string& planPath) const {
+    PlanWriter writer;
+    writer.putRaw(kPlanMagic, sizeof(kPlanMagic));
+    writer.putString(sourceDir);
+    writer.putString(outputDir);
+    writer.putString(optionsKey);
+    writer.put(rejectedFiles, 8);
+    writer.put(jobs.size(), 8);
+    for (const Job& job : jobs) {
+        writer.putString(job.source);
+        writer.putString(job.output);
+        writer.put(job.size, 8);
+        writer.put(static_cast<uint64_t>(job.modifiedTime), 8);
+        writer.put(job.estimatedBytes, 8);
+        uint64_t costBits;
+        std::memcpy(&costBits, &job.cost, sizeof(costBits));
+        writer.put(costBits, 8);
+        writer.put(static_cast<uint64_t>(job.conversion), 1);
+
+        const AudioProbe::Result& probe = job.probe;
+        writer.put(static_cast<uint64_t>(probe.status), 1);
+        writer.put(static_cast<uint32_t>(probe.format), 4);
+        writer.put(static_cast<uint32_t>(probe.info.sampleRate), 4);
+        writer.put(static_cast<uint32_t>(probe.info.channels), 4);
+        writer.put(static_cast<uint32_t>(probe.info.bitDepth), 4);
+        writer.put(probe.info.frameCount, 8);
+        writer.put(probe.dataOffset, 8);
+        writer.put(probe.dataBytes, 8);
+        writer.put((probe.bigEndian ? kBigEndian : 0) | (probe.info.isStereo ? kStereo : 0) |
+                   (probe.info.isPCM ? kPcm : 0) | (job.upToDate ? kUpToDate : 0), 1);
+    }
+    writer.put(ContentHash::hash(writer.data().data(), writer.data().size()), 8);
+
+    // Same temporary-then-rename as the conversion index, so a plan is never half written
+    std::string tempPath = planPath + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        file.write(writer.data().data(), static_cast<std::streamsize>(writer.data().size()));
+        if (!file.good()) {
+            Logger::getInstance().error("Failed to write job plan: " + tempPath);
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, planPath, error);
+    if (error) {
+        Logger::getInstance().error("Failed to replace job plan " + planPath + ": " + error.message());
+        return false;
+    }
+    return true;
+}
+
+bool JobPlan::load(const std::string& planPath) {
+    *this = JobPlan();
+
+    std::ifstream file(planPath, std::ios::binary);
+    if (!file.is_open()) {
+        Logger::getInstance().error("Failed to open job plan: " + planPath);
+        return false;
+    }
+    std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    if (data.size() < sizeof(kPlanMagic) + 8 || std::memcmp(data.data(), kPlanMagic, sizeof(kPlanMagic)) != 0) {
+        Logger::getInstance().error("Not a job plan (or from another version): " + planPath);
+        return false;
+    }
+    size_t payload = data.size() - 8;
+    PlanReader checksum(data.data() + payload, 8);
+    uint64_t storedHash = 0;
+    checksum.get(storedHash, 8);
+    if (ContentHash::hash(data.data(), payload) != storedHash) {
+        Logger::getInstance().error("Job plan is corrupt: " + planPath);
+        return false;
+    }
+
+    PlanReader reader(data.data() + sizeof(kPlanMagic), payload - sizeof(kPlanMagic));
+    JobPlan plan;
+    uint64_t jobCount = 0;
+    reader.getString(plan.sourceDir);
+    reader.getString(plan.outputDir);
+    reader.getString(plan.optionsKey);
+    reader.getAs(plan.rejectedFiles, 8);
+    reader.get(jobCount, 8);
+
+    // Every job takes at least 87 bytes, so a bogus count cannot reserve much
+    plan.jobs.reserve(static_cast<size_t>(std::min<uint64_t>(jobCount, payload / 87)));
+    for (uint64_t i = 0; i < jobCount && reader.ok(); i++) {
+        Job job;
+        uint64_t costBits = 0;
+        uint64_t conversion = 0;
+        uint64_t status = 0;
+        uint64_t flags = 0;
+        reader.getString(job.source);
+        reader.getString(job.output);
+        reader.get(job.size, 8);
+        reader.getAs(job.modifiedTime, 8);
+        reader.get(job.estimatedBytes, 8);
+        reader.get(costBits, 8);
+        std::memcpy(&job.cost, &costBits, sizeof(job.cost));
+        reader.get(conversion, 1);
+
+        AudioProbe::Result& probe = job.probe;
+        reader.get(status, 1);
+        reader.getAs(probe.format, 4);
+        reader.getAs(probe.info.sampleRate, 4);
+        reader.getAs(probe.info.channels, 4);
+        reader.getAs(probe.info.bitDepth, 4);
+        reader.getAs(probe.info.frameCount, 8);
+        reader.get(probe.dataOffset, 8);
+        reader.get(probe.dataBytes, 8);
+        reader.get(flags, 1);
+
+        if (conversion > static_cast<uint64_t>(ConversionPipeline::FastPath::DUPLICATE) ||
+            status > AudioProbe::UNKNOWN) {
+            Logger::getInstance().error("Job plan is corrupt: " + planPath);
+            return false;
+        }
+        if (reader.ok() && (!staysUnderRoot(job.source) || !staysUnderRoot(job.output))) {
+            Logger::getInstance().error("Job plan " + planPath + " has a job outside its source or output folder: " +
+                                        job.source + " -> " + job.output);
+            return false;
+        }
+        job.conversion = static_cast<ConversionPipeline::FastPath>(conversion);
+        probe.status = static_cast<AudioProbe::Status>(status);
+        probe.bigEndian = (flags & kBigEndian) != 0;
+        probe.info.isStereo = (flags & kStereo) != 0;
+        probe.info.isPCM = (flags & kPcm) != 0;
+        job.upToDate = (flags & kUpToDate) != 0;
+        plan.jobs.push_back(std::move(job));
+    }
+
+    if (!reader.ok() || !reader.atEnd()) {
+        Logger::getInstance().error("Job plan is corrupt: " + planPath);
+        return false;
+    }
+    *this = std::move(plan);
+    return true;
+}
+
+std::string JobPlan::sourcePath(const Job& job) const {
+    return (std::filesystem::path(sourceDir) / job.source).string();
+}
+
+std::string JobPlan::outputPath(const Job& job) const {
+    return (std::filesystem::path(outputDir) / job.output).string();
+}
+
+std::string JobPlan::relativeTo(const std::string& path, const std::string& root) {
+    std::string prefix = root;
+    while (prefix.size() > 1 && prefix.back() == '/') {
+        prefix.pop_back();
+    }
+    if (path.size() > prefix.size() + 1 && path.compare(0, prefix.size(), prefix) == 0 && path[prefix.size()] == '/') {
+        return path.substr(prefix.size() + 1);
+    }
+    return path;
+}
+
+void JobPlan::sortLongestFirst() {
+    std::stable_sort(jobs.begin(), jobs.end(), [](const Job& a, const Job& b) {
+        return a.cost > b.cost;
+    });
+}
+
+size_t JobPlan::pendingJobs() const {
+    return static_cast<size_t>(std::count_if(jobs.begin(), jobs.end(), [](const Job& job) { return !job.upToDate; }));
+}
+
+uint64_t JobPlan::pendingBytes() const {
+    uint64_t bytes = 0;
+    for (const Job& job : jobs) {
+        if (!job.upToDate) {
+            bytes += job.estimatedBytes;
+        }
+    }
+    return bytes;
+}
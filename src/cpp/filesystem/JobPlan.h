@@ -0,0 +1,56 @@
+#pragma once
+
+#include "AudioProbe.h"
+#include "ConversionPipeline.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Everything M8SampleFormatter decided about a library before converting any of it:
+// which sources to convert, where each output goes and how it will be produced.
+//
+// Job paths are kept relative to the source and output roots, so a plan saved on
+// one machine can be executed on another that mounts the library (or the SD card)
+// somewhere else: load it and set the roots. The file is a compact little-endian
+// binary with a trailing ContentHash of its contents; a truncated or altered plan
+// fails to load instead of being half-executed.
+class JobPlan {
+public:
+    struct Job {
+        std::string source;  // Relative to sourceDir
+        std::string output;  // Relative to outputDir
+        uint64_t size = 0;
+        int64_t modifiedTime = 0;
+        AudioProbe::Result probe;  // Only status, info, format and the data location are kept
+        ConversionPipeline::FastPath conversion = ConversionPipeline::FastPath::NONE;
+        uint64_t estimatedBytes = 0;  // Output size
+        double cost = 0.0;            // Conversion time estimate (ConversionPipeline::estimateCost)
+        bool upToDate = false;        // The index says the output from a previous run is current
+    };
+
+    std::string sourceDir;
+    std::string outputDir;
+    std::string optionsKey;  // Options the plan was made for; executing with others is refused
+    size_t rejectedFiles = 0;
+    std::vector<Job> jobs;
+
+    static constexpr const char* DEFAULT_EXTENSION = ".m8plan";
+
+    bool save(const std::string& planPath) const;
+    // Replaces the whole plan; false (and an empty plan) on a missing, foreign or corrupt file, or one
+    // with a job path that is absolute or climbs out of its root through ".."
+    bool load(const std::string& planPath);
+
+    // Full paths of a job under the current roots
+    std::string sourcePath(const Job& job) const;
+    std::string outputPath(const Job& job) const;
+    // Inverse of the above for a path under root
+    static std::string relativeTo(const std::string& path, const std::string& root);
+
+    // Costliest job first (LPT order), so the longest conversions start before the pool drains
+    void sortLongestFirst();
+
+    // Jobs that will actually run, and the bytes they are estimated to write
+    size_t pendingJobs() const;
+    uint64_t pendingBytes() const;
+};
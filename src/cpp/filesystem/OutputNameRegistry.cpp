@@ -0,0 +1,148 @@
+#include "OutputNameRegistry.h"
+#include "ContentHash.h"
+#include "PathManager.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+
+namespace {
+std::string foldCase(const std::string& path) {
+    std::string folded = path;
+    for (char& c : folded) {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return folded;
+}
+
+// Four hex digits from the source path; later attempts draw new ones
+std::string suffixFor(const std::string& sourcePath, uint64_t attempt) {
+    uint64_t hash = ContentHash::combine(ContentHash::hash(sourcePath.data(), sourcePath.size()), attempt);
+    char suffix[5];
+    std::snprintf(suffix, sizeof(suffix), "%04x", static_cast<unsigned>(hash & 0xFFFF));
+    return suffix;
+}
+}
+
+std::string OutputNameRegistry::claim(const std::string& outputPath, const std::string& sourcePath, bool keep) {
+    bool isNew = false;
+    if (tryClaim(outputPath, sourcePath, keep, isNew)) {
+        return outputPath;
+    }
+
+    std::string claimed = claimSuffixed(outputPath, sourcePath, keep, isNew);
+    if (isNew) {
+        m_collisions++;  // Not again when the same source asks a second time
+        std::lock_guard<std::mutex> lock(m_contestsMutex);
+        m_contests.push_back({foldCase(outputPath), outputPath, sourcePath, claimed});
+    }
+    return claimed;
+}
+
+std::string OutputNameRegistry::claimSuffixed(const std::string& outputPath, const std::string& sourcePath, bool keep,
+                                              bool& isNew) {
+    for (uint64_t attempt = 1;; attempt++) {
+        std::string candidate = withSuffix(outputPath, suffixFor(sourcePath, attempt), PathManager::MAX_PATH_LENGTH);
+        if (tryClaim(candidate, sourcePath, keep, isNew)) {
+            return candidate;
+        }
+    }
+}
+
+std::vector<OutputNameRegistry::Handover> OutputNameRegistry::settle() {
+    std::vector<Contest> contests;
+    {
+        std::lock_guard<std::mutex> lock(m_contestsMutex);
+        contests.swap(m_contests);
+    }
+
+    // The smallest challenger of each path; only it can outrank the holder
+    std::unordered_map<std::string, const Contest*> challengers;
+    for (const Contest& contest : contests) {
+        const Contest*& best = challengers[contest.key];
+        if (!best || contest.source < best->source) {
+            best = &contest;
+        }
+    }
+
+    std::vector<Handover> handovers;
+    for (const auto& [key, challenger] : challengers) {
+        Owner holder;
+        {
+            Shard& shard = shardFor(key);
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto it = shard.owners.find(key);
+            if (it == shard.owners.end() || it->second.keep || !(challenger->source < it->second.source)) {
+                continue;
+            }
+            holder = it->second;
+            it->second = {challenger->source, challenger->wanted, false};
+        }
+        {
+            Shard& shard = shardFor(foldCase(challenger->given));
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.owners.erase(foldCase(challenger->given));
+        }
+
+        bool isNew = false;
+        std::string holderPath = claimSuffixed(holder.path, holder.source, false, isNew);
+        handovers.push_back({holder.path, holder.source, holderPath, challenger->source, challenger->given,
+                             challenger->wanted});
+    }
+
+    // Sorted, so the moves are logged the same way every run
+    std::sort(handovers.begin(), handovers.end(),
+              [](const Handover& a, const Handover& b) { return a.path < b.path; });
+    return handovers;
+}
+
+OutputNameRegistry::Shard& OutputNameRegistry::shardFor(const std::string& key) {
+    return m_shards[std::hash<std::string>()(key) % kShards];
+}
+
+bool OutputNameRegistry::tryClaim(const std::string& outputPath, const std::string& sourcePath, bool keep,
+                                  bool& isNew) {
+    std::string key = foldCase(outputPath);
+    Shard& shard = shardFor(key);
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto [it, inserted] = shard.owners.emplace(std::move(key), Owner{sourcePath, outputPath, keep});
+    isNew = inserted;
+    return inserted || it->second.source == sourcePath;
+}
+
+void OutputNameRegistry::clear() {
+    for (Shard& shard : m_shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.owners.clear();
+    }
+    m_collisions = 0;
+    std::lock_guard<std::mutex> lock(m_contestsMutex);
+    m_contests.clear();
+}
+
+size_t OutputNameRegistry::size() const {
+    size_t total = 0;
+    for (const Shard& shard : m_shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        total += shard.owners.size();
+    }
+    return total;
+}
+
+std::string OutputNameRegistry::withSuffix(const std::string& outputPath, const std::string& suffix,
+                                           size_t maxFilename) {
+    size_t lastSlash = outputPath.find_last_of("/\\");
+    size_t nameStart = lastSlash == std::string::npos ? 0 : lastSlash + 1;
+    size_t dotPos = outputPath.find_last_of('.');
+    if (dotPos == std::string::npos || dotPos < nameStart) {
+        dotPos = outputPath.size();
+    }
+
+    std::string stem = outputPath.substr(nameStart, dotPos - nameStart);
+    std::string extension = outputPath.substr(dotPos);
+    size_t reserved = suffix.size() + 1 + extension.size();
+    if (stem.size() + reserved > maxFilename) {
+        stem.resize(maxFilename > reserved ? maxFilename - reserved : 0);
+    }
+    return outputPath.substr(0, nameStart) + stem + "-" + suffix + extension;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Run-wide registry of output paths, so two sources that PathManager maps to the
+// same name (after flattening, abbreviation or truncation) never overwrite each
+// other from parallel workers.
+//
+// Paths are compared case-insensitively, as they will be on the M8's FAT/exFAT
+// card. The first source to claim a path holds it; a later one gets a suffix
+// derived from its own source path ("Kick-3f2a.wav"), so the name it ends up with
+// does not depend on how many other sources collided before it.
+//
+// Which source asks first depends on thread timing when claims come from a
+// streaming scan. settle() then hands each contested path to the
+// lexicographically smallest source that asked for it, the one that would have
+// claimed first in sorted order, so every run names its outputs the same way.
+class OutputNameRegistry {
+public:
+    // A contested path changing hands in settle()
+    struct Handover {
+        std::string path;        // The contested path, as the previous holder claimed it
+        std::string holder;      // Source that held it until now
+        std::string holderPath;  // Suffixed path the holder moves to
+        std::string winner;      // Smallest source that asked for it
+        std::string winnerPath;  // Suffixed path the winner was given when it asked
+        std::string winnerWants; // The path as the winner asked for it, which it now holds
+    };
+
+    // The path to write sourcePath to: outputPath itself, or a suffixed variant when
+    // another source holds it. Claiming again for the same source returns the same path.
+    // With keep, the path stays with this source in settle() (an output from an earlier run)
+    std::string claim(const std::string& outputPath, const std::string& sourcePath, bool keep = false);
+
+    // Reassigns every path contested since the last settle() to its smallest claimant, unless
+    // it was claimed with keep; returns what moved. Call once no claims are in flight
+    std::vector<Handover> settle();
+
+    void clear();
+
+    size_t size() const;
+    // Sources that had to be renamed
+    size_t getCollisions() const { return m_collisions.load(); }
+
+    // outputPath with "-suffix" before the extension, shortening the file name's stem
+    // so it stays within maxFilename characters
+    static std::string withSuffix(const std::string& outputPath, const std::string& suffix, size_t maxFilename);
+
+private:
+    struct Owner {
+        std::string source;
+        std::string path;   // As claimed, before case folding
+        bool keep = false;
+    };
+    struct Shard {
+        mutable std::mutex mutex;
+        std::unordered_map<std::string, Owner> owners;  // Lowercased path -> holder
+    };
+    // A source that asked for a held path and was given a suffixed one instead
+    struct Contest {
+        std::string key;
+        std::string wanted;
+        std::string source;
+        std::string given;
+    };
+    static constexpr size_t kShards = 16;
+    std::array<Shard, kShards> m_shards;
+    std::atomic<size_t> m_collisions{0};
+    std::mutex m_contestsMutex;
+    std::vector<Contest> m_contests;
+
+    Shard& shardFor(const std::string& key);
+    // Whether sourcePath now holds outputPath; isNew when this call took it
+    bool tryClaim(const std::string& outputPath, const std::string& sourcePath, bool keep, bool& isNew);
+    // The first free suffixed variant of outputPath for sourcePath
+    std::string claimSuffixed(const std::string& outputPath, const std::string& sourcePath, bool keep, bool& isNew);
+};
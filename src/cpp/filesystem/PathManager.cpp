@@ -1,40 +1,285 @@
 #include "PathManager.h"
+#include "PathRules.h"
 #include "../utils/Logger.h"
 #include <algorithm>
 #include <cctype>
+#include <string_view>
 #include <vector>
-#include <functional>
+
+namespace {
+using Words = std::vector<std::string_view>;
+
+// Per-thread buffers reused across calls, so steady-state naming does not allocate word lists
+struct Scratch {
+    Words words;
+    std::string normalized;
+};
+
+Scratch& scratch() {
+    thread_local Scratch buffers;
+    return buffers;
+}
+
+bool isAlnum(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) != 0;
+}
+
+// Hyphenated names keep alphanumerics, '#' (musical sharps like C#) and '.' (version numbers)
+bool isNameChar(char c) {
+    return isAlnum(c) || c == '#' || c == '.';
+}
+
+bool isWordSeparator(char c) {
+    return c == '_' || c == '-' || c == ' ';
+}
+
+// Words of the hyphenated form: runs of name characters, everything else separates
+void splitNameWords(std::string_view text, Words& words) {
+    words.clear();
+    size_t start = 0;
+    for (size_t i = 0; i <= text.size(); i++) {
+        if (i == text.size() || !isNameChar(text[i])) {
+            if (i > start) {
+                words.push_back(text.substr(start, i - start));
+            }
+            start = i + 1;
+        }
+    }
+}
+
+// Words between '_', '-' and ' ', with any other characters kept
+void splitSeparatedWords(std::string_view text, Words& words) {
+    words.clear();
+    size_t start = 0;
+    for (size_t i = 0; i <= text.size(); i++) {
+        if (i == text.size() || isWordSeparator(text[i])) {
+            if (i > start) {
+                words.push_back(text.substr(start, i - start));
+            }
+            start = i + 1;
+        }
+    }
+}
+
+std::string join(const Words& words, char separator) {
+    std::string result;
+    for (std::string_view word : words) {
+        if (!result.empty()) {
+            result += separator;
+        }
+        result += word;
+    }
+    return result;
+}
+
+// Lowercase alphanumerics of word, for case- and punctuation-insensitive matching
+std::string_view normalize(std::string_view word, std::string& buffer) {
+    buffer.clear();
+    for (char c : word) {
+        if (isAlnum(c)) {
+            buffer += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+    }
+    return buffer;
+}
+
+// Either contains the other (an empty word is contained in anything)
+bool overlaps(std::string_view a, std::string_view b) {
+    return a.find(b) != std::string_view::npos || b.find(a) != std::string_view::npos;
+}
+
+void removeFillers(Words& words) {
+    const PathRules& rules = PathRules::get();
+    words.erase(std::remove_if(words.begin(), words.end(),
+                               [&rules](std::string_view word) { return rules.isFillerWord(word); }),
+                words.end());
+}
+
+// Words that overlap a pack word, e.g. "ghosthack" in pack "Ghosthack Bundle" and file "GhosthackKick"
+void removePackWords(Words& words, const std::vector<std::string>& packWords, std::string& buffer) {
+    if (packWords.empty()) {
+        return;
+    }
+    words.erase(std::remove_if(words.begin(), words.end(),
+                               [&](std::string_view word) {
+                                   std::string_view normalized = normalize(word, buffer);
+                                   return std::any_of(packWords.begin(), packWords.end(),
+                                                      [normalized](const std::string& packWord) {
+                                                          return overlaps(normalized, packWord);
+                                                      });
+                               }),
+                words.end());
+}
+
+// Pack-specific acronym prefix: 2-4 capitals/digits followed by more words (ESE-, NRE-, HL-, DH4-)
+void removePackAcronym(Words& words) {
+    if (words.size() < 2 || words[0].size() < 2 || words[0].size() > 4) {
+        return;
+    }
+    for (char c : words[0]) {
+        if (!std::isupper(static_cast<unsigned char>(c)) && !std::isdigit(static_cast<unsigned char>(c))) {
+            return;
+        }
+    }
+    words.erase(words.begin());
+}
+
+// Words (3+ characters) of an output folder path, lowercased; see removeFolderWords
+std::vector<std::string> folderWordsOf(std::string_view folderPath) {
+    std::vector<std::string> folderWords;
+    std::string current;
+    for (char c : folderPath) {
+        if (c == '/' || c == '\\' || isWordSeparator(c)) {
+            if (current.size() > 2) {
+                folderWords.push_back(current);
+            }
+            current.clear();
+        } else if (isAlnum(c)) {
+            current += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+    }
+    if (current.size() > 2) {
+        folderWords.push_back(current);
+    }
+    return folderWords;
+}
+
+// Category words already named by a folder above the file
+void removeFolderWords(Words& words, const std::vector<std::string>& folderWords, std::string& buffer) {
+    if (folderWords.empty()) {
+        return;
+    }
+    words.erase(std::remove_if(words.begin(), words.end(),
+                               [&](std::string_view word) {
+                                   std::string_view normalized = normalize(word, buffer);
+                                   return std::any_of(folderWords.begin(), folderWords.end(),
+                                                      [normalized](const std::string& folderWord) {
+                                                          return overlaps(normalized, folderWord);
+                                                      });
+                               }),
+                words.end());
+}
+
+void removeRepeatedWords(Words& words) {
+    size_t kept = 0;
+    for (size_t i = 0; i < words.size(); i++) {
+        if (std::find(words.begin(), words.begin() + static_cast<std::ptrdiff_t>(kept), words[i]) ==
+            words.begin() + static_cast<std::ptrdiff_t>(kept)) {
+            words[kept++] = words[i];
+        }
+    }
+    words.resize(kept);
+}
+}
 
 std::string PathManager::shortenFilename(const std::string& filename) {
+    Words& words = scratch().words;
     std::string baseName = removeExtension(filename);
+
+    // Hyphenated (casing preserved), without filler words like "serum" and "wav"
+    splitNameWords(baseName, words);
+    removeFillers(words);
+
     // Always use .wav extension for output files
-    std::string extension = ".wav";
-    
-    // Convert to hyphenated format (preserves casing)
-    std::string shortened = toHyphenated(baseName);
-    
-    // Remove filler words like "serum" and "wav"
-    shortened = removeFillerWords(shortened);
-    
-    // Convert underscores back to hyphens after filler removal
-    std::replace(shortened.begin(), shortened.end(), '_', '-');
-    
-    return shortened + extension;
+    return join(words, '-') + ".wav";
 }
 
 std::string PathManager::generateOutputPath(const std::string& inputPath,
                                            const std::string& sourceRoot,
                                            const std::string& outputRoot) {
-    // Get the relative path from source root
+    std::shared_ptr<const OutputFolder> folder = outputFolder(inputPath, sourceRoot, outputRoot, false);
     std::filesystem::path input(inputPath);
+    return finishPath(folder->path, outputFilename(input.filename().string(), *folder));
+}
+
+std::string PathManager::generateFlattenedOutputPath(const std::string& inputPath,
+                                                     const std::string& sourceRoot,
+                                                     const std::string& outputRoot) {
+    std::shared_ptr<const OutputFolder> folder = outputFolder(inputPath, sourceRoot, outputRoot, true);
+    std::filesystem::path input(inputPath);
+    return finishPath(folder->path, outputFilename(input.filename().string(), *folder));
+}
+
+void PathManager::clearFolderCache() {
+    std::unique_lock<std::shared_mutex> lock(m_folderCacheMutex);
+    m_folderCache.clear();
+}
+
+std::shared_ptr<const PathManager::OutputFolder> PathManager::outputFolder(const std::string& inputPath,
+                                                                          const std::string& sourceRoot,
+                                                                          const std::string& outputRoot,
+                                                                          bool flatten) {
+    size_t lastSlash = inputPath.find_last_of('/');
+    std::string key;
+    key.reserve(sourceRoot.size() + outputRoot.size() + (lastSlash == std::string::npos ? 0 : lastSlash) + 3);
+    key += flatten ? 'F' : 'T';
+    key += sourceRoot;
+    key += '\0';
+    key += outputRoot;
+    key += '\0';
+    if (lastSlash != std::string::npos) {
+        key.append(inputPath, 0, lastSlash);
+    }
+
+    {
+        std::shared_lock<std::shared_mutex> lock(m_folderCacheMutex);
+        auto it = m_folderCache.find(key);
+        if (it != m_folderCache.end()) {
+            m_folderCacheHits++;
+            return it->second;
+        }
+    }
+
+    // Built outside the lock; if another thread got there first, its folder is kept
+    auto folder = std::make_shared<const OutputFolder>(buildOutputFolder(inputPath, sourceRoot, outputRoot, flatten));
+    m_folderCacheMisses++;
+    std::unique_lock<std::shared_mutex> lock(m_folderCacheMutex);
+    return m_folderCache.emplace(std::move(key), std::move(folder)).first->second;
+}
+
+PathManager::OutputFolder PathManager::buildOutputFolder(const std::string& inputPath, const std::string& sourceRoot,
+                                                         const std::string& outputRoot, bool flatten) {
     std::filesystem::path source(sourceRoot);
     std::filesystem::path output(outputRoot);
-    
-    // Get the source folder name and remove parentheses/brackets content
-    std::string sourceFolderName = source.filename().string();
-    
-    // Remove content in parentheses () and brackets []
-    std::string cleaned = "";
+
+    OutputFolder folder;
+    folder.pack = packName(source);
+    folder.path = output / folder.pack.folder;
+
+    if (flatten) {
+        // Flatten the folder structure into a single directory
+        std::string cleanedPath = cleanFolderName(flattenFolderStructure(inputPath, sourceRoot));
+        Scratch& buffers = scratch();
+        splitNameWords(cleanedPath, buffers.words);
+        removePackWords(buffers.words, folder.pack.words, buffers.normalized);
+        std::string dedupedPath = join(buffers.words, '-');
+        if (!dedupedPath.empty()) {
+            folder.path /= dedupedPath;
+        }
+    } else {
+        // Hyphenate each directory component below the source root and remove duplicates
+        std::filesystem::path input(inputPath);
+        std::filesystem::path relativePath = std::filesystem::relative(input.parent_path(), source);
+        for (const auto& component : relativePath) {
+            std::string dirName = component.string();
+            // Skip "." which represents the current directory
+            if (dirName != ".") {
+                std::string cleanedDir = cleanComponent(dirName, folder.pack);
+                if (!cleanedDir.empty()) {
+                    folder.path /= cleanedDir;
+                }
+            }
+        }
+    }
+
+    folder.folderWords = folderWordsOf(folder.path.string());
+    return folder;
+}
+
+PathManager::PackName PathManager::packName(const std::filesystem::path& sourceRoot) {
+    // Source folder name without content in parentheses () and brackets []
+    std::string sourceFolderName = sourceRoot.filename().string();
+    std::string cleaned;
     bool inParens = false;
     bool inBrackets = false;
     for (char c : sourceFolderName) {
@@ -50,116 +295,85 @@ std::string PathManager::generateOutputPath(const std::string& inputPath,
             cleaned += c;
         }
     }
-    
-    std::string topLevelFolder = toHyphenated(cleaned);
-    
-    // Remove filler words (WAV, SERUM, years, etc.) from top-level folder name
-    topLevelFolder = removeFillerWords(topLevelFolder);
-    // Convert underscores back to hyphens after filler removal
-    std::replace(topLevelFolder.begin(), topLevelFolder.end(), '_', '-');
-    
-    // Remove any trailing hyphens
-    while (!topLevelFolder.empty() && topLevelFolder.back() == '-') {
-        topLevelFolder.pop_back();
-    }
-    
-    // Extract pack name words for duplicate removal (use cleaned folder name)
-    std::vector<std::string> packWords = extractPackNameWords(topLevelFolder);
-    
-    // Start with output root + hyphenated source folder name
-    std::filesystem::path processedPath = output / topLevelFolder;
-    
-    // Calculate relative path from source root
-    std::filesystem::path relativePath = std::filesystem::relative(input.parent_path(), source);
-    
-    // Apply hyphenation to each directory component and remove duplicates
-    for (const auto& component : relativePath) {
-        std::string dirName = component.string();
-        // Skip "." which represents the current directory
-        if (dirName != ".") {
-            std::string hyphenatedDir = toHyphenated(dirName);
-            std::string dedupedDir = removeDuplicatesFromPath(hyphenatedDir, packWords);
-            // Remove common filler words like "serum" and "wav"
-            dedupedDir = removeFillerWords(dedupedDir);
-            // Convert underscores back to hyphens after filler removal
-            std::replace(dedupedDir.begin(), dedupedDir.end(), '_', '-');
-            if (!dedupedDir.empty()) {
-                processedPath /= dedupedDir;
+
+    // Hyphenated, without filler words (WAV, SERUM, years, etc.)
+    Words& words = scratch().words;
+    splitNameWords(cleaned, words);
+    removeFillers(words);
+
+    PackName pack;
+    pack.folder = join(words, '-');
+
+    // Matched without '#' and '.', which also split words here
+    std::string buffer;
+    size_t start = 0;
+    for (size_t i = 0; i <= pack.folder.size(); i++) {
+        if (i == pack.folder.size() || pack.folder[i] == '-' || pack.folder[i] == '.') {
+            std::string_view normalized = normalize(std::string_view(pack.folder).substr(start, i - start), buffer);
+            if (!normalized.empty()) {
+                pack.words.emplace_back(normalized);
             }
+            start = i + 1;
         }
     }
-    
-    // Shorten the filename and remove duplicates
-    std::string baseFilename = removeExtension(input.filename().string());
-    std::string hyphenatedFilename = toHyphenated(baseFilename);
-    std::string dedupedFilename = removeDuplicatesFromPath(hyphenatedFilename, packWords);
+    return pack;
+}
+
+std::string PathManager::cleanComponent(const std::string& name, const PackName& pack) {
+    Scratch& buffers = scratch();
+    splitNameWords(name, buffers.words);
+    removePackWords(buffers.words, pack.words, buffers.normalized);
     // Remove common filler words like "serum" and "wav"
-    dedupedFilename = removeFillerWords(dedupedFilename);
-    // Remove pack-specific acronyms (ESE-, NRE-, HL-, etc.)
-    dedupedFilename = removePackAcronyms(dedupedFilename);
-    // Remove redundant category words from parent folder
-    dedupedFilename = removeRedundantCategoryWords(dedupedFilename, processedPath.string());
-    // Convert underscores back to hyphens after filler removal
-    std::replace(dedupedFilename.begin(), dedupedFilename.end(), '_', '-');
-    std::string shortenedFilename = dedupedFilename + ".wav";
-    
-    // Construct full path
-    std::string fullPath = (processedPath / shortenedFilename).string();
-    
+    removeFillers(buffers.words);
+    return join(buffers.words, '-');
+}
+
+std::string PathManager::outputFilename(const std::string& filename, const OutputFolder& folder) {
+    Scratch& buffers = scratch();
+    std::string baseFilename = removeExtension(filename);
+    splitNameWords(baseFilename, buffers.words);
+    removePackWords(buffers.words, folder.pack.words, buffers.normalized);
+    // Remove common filler words like "serum" and "wav"
+    removeFillers(buffers.words);
+    removePackAcronym(buffers.words);
+    removeFolderWords(buffers.words, folder.folderWords, buffers.normalized);
+    return join(buffers.words, '-') + ".wav";
+}
+
+std::string PathManager::finishPath(const std::filesystem::path& folder, const std::string& filename) {
     // Always apply abbreviations (not just when over limit)
-    fullPath = abbreviateCommonWords(fullPath);
-    
+    std::string fullPath = PathRules::get().abbreviate((folder / filename).string());
+
     // Check path length and truncate if still too long
     if (!validatePathLength(fullPath)) {
         fullPath = truncateIfNeeded(fullPath, MAX_PATH_LENGTH);
     }
-    
     return fullPath;
 }
 
-std::string PathManager::toHyphenated(const std::string& str) {
-    std::string result;
-    bool lastWasHyphen = false;
-    
-    for (char c : str) {
-        // Convert separators (underscore, space, multiple hyphens) to single hyphen
-        if (c == '_' || c == ' ' || c == '-') {
-            if (!lastWasHyphen && !result.empty()) {
-                result += '-';
-                lastWasHyphen = true;
-            }
-            continue;
-        }
-        
-        // Handle alphanumeric characters - preserve original casing
-        if (std::isalnum(c)) {
-            result += c;
-            lastWasHyphen = false;
-        }
-        // Keep # (for musical sharps like C#, F#)
-        else if (c == '#') {
-            result += c;
-            lastWasHyphen = false;
-        }
-        // Keep dots and other characters that might be part of version numbers
-        else if (c == '.') {
-            result += c;
-            lastWasHyphen = false;
-        }
-        // Skip other special characters (parentheses, brackets, etc.)
-        // They effectively act as separators
-        else if (!lastWasHyphen && !result.empty()) {
-            result += '-';
-            lastWasHyphen = true;
-        }
-    }
-    
-    // Remove trailing hyphen if present
-    if (!result.empty() && result.back() == '-') {
-        result.pop_back();
-    }
-    
-    return result;
+std::string PathManager::cleanFolderName(const std::string& folderName) {
+    // Repeated words and filler words removed
+    Words& words = scratch().words;
+    splitSeparatedWords(folderName, words);
+    removeRepeatedWords(words);
+    removeFillers(words);
+    return join(words, '_');
+}
+
+std::string PathManager::removeDuplicateWords(const std::string& text) {
+    // Remove duplicates while preserving order
+    Words& words = scratch().words;
+    splitSeparatedWords(text, words);
+    removeRepeatedWords(words);
+    return join(words, '_');
+}
+
+std::string PathManager::removeFillerWords(const std::string& text) {
+    // Strike words (startswith matching like the Python version), see PathRules
+    Words& words = scratch().words;
+    splitSeparatedWords(text, words);
+    removeFillers(words);
+    return join(words, '_');
 }
 
 std::string PathManager::extractExtension(const std::string& filename) {
@@ -178,90 +392,6 @@ std::string PathManager::removeExtension(const std::string& filename) {
     return filename;
 }
 
-std::string PathManager::generateFlattenedOutputPath(const std::string& inputPath,
-                                                     const std::string& sourceRoot,
-                                                     const std::string& outputRoot) {
-    // Get the source folder name and remove parentheses/brackets content
-    std::filesystem::path source(sourceRoot);
-    std::string sourceFolderName = source.filename().string();
-    
-    // Remove content in parentheses () and brackets []
-    std::string cleaned = "";
-    bool inParens = false;
-    bool inBrackets = false;
-    for (char c : sourceFolderName) {
-        if (c == '(' || c == ')') {
-            inParens = (c == '(');
-            continue;
-        }
-        if (c == '[' || c == ']') {
-            inBrackets = (c == '[');
-            continue;
-        }
-        if (!inParens && !inBrackets) {
-            cleaned += c;
-        }
-    }
-    
-    std::string topLevelFolder = toHyphenated(cleaned);
-    
-    // Remove filler words (WAV, SERUM, years, etc.) from top-level folder name
-    topLevelFolder = removeFillerWords(topLevelFolder);
-    // Convert underscores back to hyphens after filler removal
-    std::replace(topLevelFolder.begin(), topLevelFolder.end(), '_', '-');
-    
-    // Remove any trailing hyphens
-    while (!topLevelFolder.empty() && topLevelFolder.back() == '-') {
-        topLevelFolder.pop_back();
-    }
-    
-    // Extract pack name words for duplicate removal (use cleaned folder name)
-    std::vector<std::string> packWords = extractPackNameWords(topLevelFolder);
-    
-    // Start with output root + hyphenated source folder name
-    std::filesystem::path output(outputRoot);
-    std::filesystem::path processedPath = output / topLevelFolder;
-    
-    // Flatten the folder structure
-    std::string flattenedPath = this->flattenFolderStructure(inputPath, sourceRoot);
-    std::string cleanedPath = this->cleanFolderName(flattenedPath);
-    std::string hyphenatedPath = toHyphenated(cleanedPath);
-    std::string dedupedPath = removeDuplicatesFromPath(hyphenatedPath, packWords);
-    
-    // Add the flattened path as a single directory
-    if (!dedupedPath.empty()) {
-        processedPath /= dedupedPath;
-    }
-    
-    // Shorten the filename and remove duplicates
-    std::filesystem::path input(inputPath);
-    std::string baseFilename = removeExtension(input.filename().string());
-    std::string hyphenatedFilename = toHyphenated(baseFilename);
-    std::string dedupedFilename = removeDuplicatesFromPath(hyphenatedFilename, packWords);
-    // Remove common filler words like "serum" and "wav"
-    dedupedFilename = removeFillerWords(dedupedFilename);
-    // Remove pack-specific acronyms (ESE-, NRE-, HL-, etc.)
-    dedupedFilename = removePackAcronyms(dedupedFilename);
-    // Remove redundant category words from parent folder
-    dedupedFilename = removeRedundantCategoryWords(dedupedFilename, processedPath.string());
-    // Convert underscores back to hyphens after filler removal
-    std::replace(dedupedFilename.begin(), dedupedFilename.end(), '_', '-');
-    std::string shortenedFilename = dedupedFilename + ".wav";
-    
-    // Construct full path
-    std::string fullPath = (processedPath / shortenedFilename).string();
-    
-    // Always apply abbreviations (not just when over limit)
-    fullPath = abbreviateCommonWords(fullPath);
-    
-    // Check path length and truncate if still too long
-    if (!validatePathLength(fullPath)) {
-        fullPath = truncateIfNeeded(fullPath, MAX_PATH_LENGTH);
-    }
-    
-    return fullPath;
-}
-
 std::string PathManager::flattenFolderStructure(const std::string& inputPath,
                                                 const std::string& sourceRoot) {
     std::filesystem::path input(inputPath);
@@ -289,363 +419,6 @@ std::string PathManager::flattenFolderStructure(const std::string& inputPath,
     return result;
 }
 
-std::string PathManager::cleanFolderName(const std::string& folderName) {
-    std::string cleaned = folderName;
-    
-    // Remove duplicate words
-    cleaned = removeDuplicateWords(cleaned);
-    
-    // Remove filler words
-    cleaned = removeFillerWords(cleaned);
-    
-    return cleaned;
-}
-
-std::string PathManager::removeDuplicateWords(const std::string& text) {
-    std::string result;
-    std::string currentWord;
-    std::vector<std::string> words;
-    
-    // Split into words
-    for (char c : text) {
-        if (c == '_' || c == '-' || c == ' ') {
-            if (!currentWord.empty()) {
-                words.push_back(currentWord);
-                currentWord.clear();
-            }
-        } else {
-            currentWord += c;
-        }
-    }
-    if (!currentWord.empty()) {
-        words.push_back(currentWord);
-    }
-    
-    // Remove duplicates while preserving order
-    std::vector<std::string> uniqueWords;
-    for (const auto& word : words) {
-        bool found = false;
-        for (const auto& uniqueWord : uniqueWords) {
-            if (word == uniqueWord) {
-                found = true;
-                break;
-            }
-        }
-        if (!found) {
-            uniqueWords.push_back(word);
-        }
-    }
-    
-    // Reconstruct the string
-    for (size_t i = 0; i < uniqueWords.size(); ++i) {
-        if (i > 0) {
-            result += "_";
-        }
-        result += uniqueWords[i];
-    }
-    
-    return result;
-}
-
-std::string PathManager::removeFillerWords(const std::string& text) {
-    // Strike words inspired by M8 Sample Organizer Python version
-    // Only remove truly redundant words, not meaningful musical terms
-    std::vector<std::string> strikeWords = {
-        "final", "sample", "label", "process", "edit", "pack", "wav", 
-        "construct", "cpa", "splice", "export", "processed", "master", 
-        "version", "v1", "v2", "v3", "v4", "v5", "new", "old", "backup", 
-        "copy", "original", "edited", "mix", "remix", "remastered", "mastered",
-        "serum",  // Added per user request
-        // Marketing/filler words
-        "essentials", "essential", "legends", "legend", "hero", "edition", 
-        "exclusive", "bundle", "ultimate", "collection", "series",
-        // Year numbers
-        "2020", "2021", "2022", "2023", "2024", "2025", "2026", "2027", "2028", "2029"
-    };
-    
-    std::string result;
-    std::string currentWord;
-    std::vector<std::string> words;
-    
-    // Split into words
-    for (char c : text) {
-        if (c == '_' || c == '-' || c == ' ') {
-            if (!currentWord.empty()) {
-                words.push_back(currentWord);
-                currentWord.clear();
-            }
-        } else {
-            currentWord += c;
-        }
-    }
-    if (!currentWord.empty()) {
-        words.push_back(currentWord);
-    }
-    
-    // Remove strike words (using startswith matching like Python version)
-    for (const auto& word : words) {
-        bool isStrikeWord = false;
-        std::string lowerWord = word;
-        std::transform(lowerWord.begin(), lowerWord.end(), lowerWord.begin(), ::tolower);
-        
-        for (const auto& strike : strikeWords) {
-            if (lowerWord.find(strike) == 0) {  // startswith matching
-                isStrikeWord = true;
-                break;
-            }
-        }
-        if (!isStrikeWord) {
-            if (!result.empty()) {
-                result += "_";
-            }
-            result += word;
-        }
-    }
-    
-    return result;
-}
-
-std::string PathManager::removePackAcronyms(const std::string& text) {
-    // Remove pack-specific acronyms (2-4 capital letters at the start)
-    // Examples: ESE-, NRE-, HL-, UE-, DH4-
-    if (text.empty()) {
-        return text;
-    }
-    
-    // Check if text starts with 2-4 capital letters followed by hyphen or underscore
-    size_t acronymLength = 0;
-    for (size_t i = 0; i < text.length() && i < 4; ++i) {
-        if (std::isupper(text[i]) || std::isdigit(text[i])) {
-            acronymLength++;
-        } else {
-            break;
-        }
-    }
-    
-    // If we found 2-4 capital letters/digits followed by hyphen or underscore, remove them
-    if (acronymLength >= 2 && acronymLength <= 4) {
-        if (text.length() > acronymLength && (text[acronymLength] == '-' || text[acronymLength] == '_')) {
-            return text.substr(acronymLength + 1);  // Skip acronym and separator
-        }
-    }
-    
-    return text;
-}
-
-std::string PathManager::removeRedundantCategoryWords(const std::string& filename, 
-                                                       const std::string& folderPath) {
-    // Extract words from folder path
-    std::vector<std::string> folderWords;
-    std::string currentWord;
-    
-    for (char c : folderPath) {
-        if (c == '/' || c == '\\' || c == '-' || c == '_' || c == ' ') {
-            if (!currentWord.empty() && currentWord.length() > 2) {  // Skip very short words
-                folderWords.push_back(currentWord);
-                currentWord.clear();
-            } else {
-                currentWord.clear();
-            }
-        } else if (std::isalnum(c)) {
-            currentWord += c;
-        }
-    }
-    if (!currentWord.empty() && currentWord.length() > 2) {
-        folderWords.push_back(currentWord);
-    }
-    
-    // Split filename into words
-    std::vector<std::string> filenameWords;
-    currentWord.clear();
-    
-    for (char c : filename) {
-        if (c == '-' || c == '_' || c == ' ') {
-            if (!currentWord.empty()) {
-                filenameWords.push_back(currentWord);
-                currentWord.clear();
-            }
-        } else {
-            currentWord += c;
-        }
-    }
-    if (!currentWord.empty()) {
-        filenameWords.push_back(currentWord);
-    }
-    
-    // Remove filename words that appear in folder path (case-insensitive)
-    std::vector<std::string> filteredWords;
-    for (const auto& fileWord : filenameWords) {
-        bool foundInFolder = false;
-        std::string normalizedFileWord = normalizeForComparison(fileWord);
-        
-        for (const auto& folderWord : folderWords) {
-            std::string normalizedFolderWord = normalizeForComparison(folderWord);
-            
-            // Check for exact match or substring match
-            if (normalizedFileWord == normalizedFolderWord ||
-                normalizedFileWord.find(normalizedFolderWord) != std::string::npos ||
-                normalizedFolderWord.find(normalizedFileWord) != std::string::npos) {
-                foundInFolder = true;
-                break;
-            }
-        }
-        
-        if (!foundInFolder) {
-            filteredWords.push_back(fileWord);
-        }
-    }
-    
-    // Reconstruct filename
-    std::string result;
-    for (size_t i = 0; i < filteredWords.size(); ++i) {
-        if (i > 0) {
-            result += "-";
-        }
-        result += filteredWords[i];
-    }
-    
-    return result;
-}
-
-// ============================================================================
-// New methods for fuzzy duplicate removal and path length management
-// ============================================================================
-
-std::vector<std::string> PathManager::extractPackNameWords(const std::string& packName) {
-    std::vector<std::string> words;
-    std::string currentWord;
-    
-    // Split on separators
-    for (char c : packName) {
-        if (c == '_' || c == '-' || c == ' ' || c == '.' || c == '\'') {
-            if (!currentWord.empty()) {
-                words.push_back(currentWord);
-                currentWord.clear();
-            }
-        } else if (std::isalnum(c) || c == '#') {
-            currentWord += c;
-        }
-    }
-    if (!currentWord.empty()) {
-        words.push_back(currentWord);
-    }
-    
-    return words;
-}
-
-std::string PathManager::normalizeForComparison(const std::string& text) {
-    std::string normalized;
-    
-    for (char c : text) {
-        if (std::isalnum(c)) {
-            normalized += std::tolower(c);
-        }
-        // Skip separators and special characters for matching
-    }
-    
-    return normalized;
-}
-
-std::string PathManager::removeDuplicatesFromPath(const std::string& text, 
-                                                   const std::vector<std::string>& packWords) {
-    if (packWords.empty() || text.empty()) {
-        return text;
-    }
-    
-    std::vector<std::string> words;
-    std::string currentWord;
-    
-    // Split text into words
-    for (char c : text) {
-        if (c == '-' || c == '_' || c == ' ') {
-            if (!currentWord.empty()) {
-                words.push_back(currentWord);
-                currentWord.clear();
-            }
-        } else {
-            currentWord += c;
-        }
-    }
-    if (!currentWord.empty()) {
-        words.push_back(currentWord);
-    }
-    
-    // Create normalized versions of pack words for comparison
-    std::vector<std::string> normalizedPackWords;
-    for (const auto& packWord : packWords) {
-        std::string normalized = normalizeForComparison(packWord);
-        if (!normalized.empty()) {
-            normalizedPackWords.push_back(normalized);
-        }
-    }
-    
-    // Remove words that match pack words (with substring matching)
-    std::vector<std::string> filteredWords;
-    for (size_t i = 0; i < words.size(); ++i) {
-        std::string normalizedWord = normalizeForComparison(words[i]);
-        bool isDuplicate = false;
-        
-        // Check for exact word matches
-        for (const auto& normalizedPackWord : normalizedPackWords) {
-            if (normalizedWord == normalizedPackWord) {
-                isDuplicate = true;
-                break;
-            }
-            
-            // Also check if the file word contains the pack word as a substring
-            // e.g., "ghosthack" in pack matches "ghosthack" in "ghosthackKick"
-            if (normalizedWord.find(normalizedPackWord) != std::string::npos) {
-                isDuplicate = true;
-                break;
-            }
-            
-            // Also check if pack word contains the file word as a substring
-            // e.g., "ghosthack" from "ghosthackBundle" matches standalone "ghosthack"
-            if (normalizedPackWord.find(normalizedWord) != std::string::npos) {
-                isDuplicate = true;
-                break;
-            }
-        }
-        
-        // Also check if concatenating consecutive single-letter words matches a pack word
-        // This handles cases like "K-S-H-M-R" matching "KSHMR"
-        if (!isDuplicate && words[i].length() == 1) {
-            std::string concatenated = normalizedWord;
-            size_t j = i + 1;
-            while (j < words.size() && words[j].length() == 1) {
-                concatenated += normalizeForComparison(words[j]);
-                j++;
-            }
-            
-            // Check if concatenated version matches any pack word
-            for (const auto& normalizedPackWord : normalizedPackWords) {
-                if (concatenated == normalizedPackWord) {
-                    // Mark all these single-letter words as duplicates
-                    isDuplicate = true;
-                    // Skip the remaining single letters in the outer loop
-                    i = j - 1;
-                    break;
-                }
-            }
-        }
-        
-        if (!isDuplicate) {
-            filteredWords.push_back(words[i]);
-        }
-    }
-    
-    // Reconstruct string with hyphens
-    std::string result;
-    for (size_t i = 0; i < filteredWords.size(); ++i) {
-        if (i > 0) {
-            result += "-";
-        }
-        result += filteredWords[i];
-    }
-    
-    return result;
-}
-
 bool PathManager::validatePathLength(const std::string& path) {
     // Get just the filename portion (from last slash to end)
     size_t lastSlash = path.find_last_of("/\\");
@@ -659,46 +432,6 @@ bool PathManager::validatePathLength(const std::string& path) {
     return filename.length() <= MAX_PATH_LENGTH;
 }
 
-std::string PathManager::abbreviateCommonWords(const std::string& text) {
-    std::string result = text;
-    
-    // Apply abbreviations from the dictionary
-    // We need to be careful to match whole words with hyphens as separators
-    for (const auto& [fullWord, abbrev] : m_abbreviations) {
-        std::string searchWord = fullWord;
-        
-        // Try different casing variations
-        std::vector<std::string> variations = {
-            fullWord,  // Original
-            fullWord,  // Keep as-is for mixed case
-        };
-        
-        for (const auto& variant : variations) {
-            // Replace with word boundaries (hyphens or path separators)
-            size_t pos = 0;
-            while ((pos = result.find(variant, pos)) != std::string::npos) {
-                // Check if it's a whole word (preceded and followed by hyphen, slash, or boundary)
-                bool validStart = (pos == 0 || result[pos-1] == '-' || 
-                                  result[pos-1] == '/' || result[pos-1] == '\\');
-                bool validEnd = (pos + variant.length() >= result.length() || 
-                                result[pos + variant.length()] == '-' ||
-                                result[pos + variant.length()] == '/' ||
-                                result[pos + variant.length()] == '\\' ||
-                                result[pos + variant.length()] == '.');
-                
-                if (validStart && validEnd) {
-                    result.replace(pos, variant.length(), abbrev);
-                    pos += abbrev.length();
-                } else {
-                    pos += variant.length();
-                }
-            }
-        }
-    }
-    
-    return result;
-}
-
 std::string PathManager::truncateIfNeeded(const std::string& path, size_t maxLength) {
     // Get the path components
     size_t lastSlash = path.find_last_of("/\\");
@@ -1,13 +1,28 @@
 #pragma once
 
-#include <string>
+#include <atomic>
 #include <filesystem>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
 #include <vector>
-#include <map>
 
+// Output naming for the M8: hyphenated names with pack, filler and acronym words
+// removed and common words abbreviated. Each name is split into string_view
+// words once and every rule filters that word list; the word lists themselves
+// are compiled once (see PathRules).
+//
+// Everything derived from a file's directory (the cleaned output folder, pack
+// words, the words of the folder path) is cached per (source root, output root,
+// directory), so for the hundreds of files in a pack folder only the file name
+// itself is processed. generate*OutputPath may be called from several threads.
 class PathManager {
 public:
     PathManager() = default;
+
+    PathManager(const PathManager&) = delete;
+    PathManager& operator=(const PathManager&) = delete;
     
     // Core functionality: shorten filename by converting separators to hyphens
     std::string shortenFilename(const std::string& filename);
@@ -31,58 +46,49 @@ public:
     
     // Path length management (M8's 128 character limit)
     static constexpr size_t MAX_PATH_LENGTH = 128;
+
+    // Directory cache lookups (a miss computes the folder once for every later file in it)
+    size_t getFolderCacheHits() const { return m_folderCacheHits.load(); }
+    size_t getFolderCacheMisses() const { return m_folderCacheMisses.load(); }
+    // For long-running processes whose source tree changes
+    void clearFolderCache();
     
 private:
-    // Convert underscores/spaces to hyphens while preserving casing
-    std::string toHyphenated(const std::string& str);
-    
-    // Fuzzy duplicate word removal
-    std::vector<std::string> extractPackNameWords(const std::string& packName);
-    std::string normalizeForComparison(const std::string& text);
-    std::string removeDuplicatesFromPath(const std::string& text, 
-                                         const std::vector<std::string>& packWords);
-    
-    // Remove acronyms and redundant category words
-    std::string removePackAcronyms(const std::string& text);
-    std::string removeRedundantCategoryWords(const std::string& filename, 
-                                             const std::string& folderPath);
-    
-    // Path length validation and abbreviation
+    // Cleaned top-level folder of a source root and its normalized words, which
+    // are stripped from every folder and file name below it
+    struct PackName {
+        std::string folder;
+        std::vector<std::string> words;  // Lowercase alphanumerics, never empty
+    };
+    PackName packName(const std::filesystem::path& sourceRoot);
+
+    // Where the files of one source directory go
+    struct OutputFolder {
+        std::filesystem::path path;
+        PackName pack;
+        std::vector<std::string> folderWords;  // Lowercase words (3+ chars) of path, see removeFolderWords
+    };
+    std::shared_ptr<const OutputFolder> outputFolder(const std::string& inputPath, const std::string& sourceRoot,
+                                                     const std::string& outputRoot, bool flatten);
+    OutputFolder buildOutputFolder(const std::string& inputPath, const std::string& sourceRoot,
+                                   const std::string& outputRoot, bool flatten);
+
+    // Hyphenated folder name with pack and filler words removed
+    std::string cleanComponent(const std::string& name, const PackName& pack);
+    // Output file name (always .wav) for a source file placed in folder
+    std::string outputFilename(const std::string& filename, const OutputFolder& folder);
+    // Joins, abbreviates and enforces the length limit
+    std::string finishPath(const std::filesystem::path& folder, const std::string& filename);
+
+    mutable std::shared_mutex m_folderCacheMutex;
+    std::unordered_map<std::string, std::shared_ptr<const OutputFolder>> m_folderCache;
+    std::atomic<size_t> m_folderCacheHits{0};
+    std::atomic<size_t> m_folderCacheMisses{0};
+
+    // Path length validation
     bool validatePathLength(const std::string& path);
-    std::string abbreviateCommonWords(const std::string& text);
     std::string truncateIfNeeded(const std::string& path, size_t maxLength);
     
-    // Abbreviation dictionary for common audio terms
-    const std::map<std::string, std::string> m_abbreviations = {
-        {"Drum", "Drm"},
-        {"Drums", "Drms"},
-        {"Vocal", "Vox"},
-        {"Vocals", "Vox"},
-        {"Percussion", "Perc"},
-        {"Synthesizer", "Synth"},
-        {"Bass", "Bs"},
-        {"Guitar", "Gtr"},
-        {"String", "Str"},
-        {"Strings", "Strs"},
-        {"Instrument", "Inst"},
-        {"One-Shot", "OS"},
-        {"One-Shots", "OS"},
-        {"OneShot", "OS"},
-        {"OneShots", "OS"},
-        {"Loop", "Lp"},
-        {"Loops", "Lps"},
-        {"Sample", "Smp"},
-        {"Samples", "Smps"},
-        {"Texture", "Txt"},
-        {"Textures", "Txts"},
-        {"Atmosphere", "Atm"},
-        {"Atmospheres", "Atms"},
-        {"Melody", "Mel"},
-        {"Melodies", "Mels"},
-        {"Chord", "Chd"},
-        {"Chords", "Chds"}
-    };
-    
     // Extract extension from filename
     std::string extractExtension(const std::string& filename);
     
@@ -0,0 +1,122 @@
+#include "PathRules.h"
+#include <cctype>
+
+namespace {
+// Strike words inspired by M8 Sample Organizer Python version.
+// Only truly redundant words, not meaningful musical terms
+const std::vector<std::string_view> kStrikeWords = {
+    "final", "sample", "label", "process", "edit", "pack", "wav",
+    "construct", "cpa", "splice", "export", "processed", "master",
+    "version", "v1", "v2", "v3", "v4", "v5", "new", "old", "backup",
+    "copy", "original", "edited", "mix", "remix", "remastered", "mastered",
+    "serum",  // Added per user request
+    // Marketing/filler words
+    "essentials", "essential", "legends", "legend", "hero", "edition",
+    "exclusive", "bundle", "ultimate", "collection", "series",
+    // Year numbers
+    "2020", "2021", "2022", "2023", "2024", "2025", "2026", "2027", "2028", "2029"
+};
+
+// Abbreviation dictionary for common audio terms
+const std::vector<std::string_view> kAbbreviationWords = {
+    "Drum", "Drums", "Vocal", "Vocals", "Percussion", "Synthesizer", "Bass", "Guitar",
+    "String", "Strings", "Instrument", "One-Shot", "One-Shots", "OneShot", "OneShots",
+    "Loop", "Loops", "Sample", "Samples", "Texture", "Textures", "Atmosphere", "Atmospheres",
+    "Melody", "Melodies", "Chord", "Chords"
+};
+const std::vector<std::string_view> kAbbreviations = {
+    "Drm", "Drms", "Vox", "Vox", "Perc", "Synth", "Bs", "Gtr",
+    "Str", "Strs", "Inst", "OS", "OS", "OS", "OS",
+    "Lp", "Lps", "Smp", "Smps", "Txt", "Txts", "Atm", "Atms",
+    "Mel", "Mels", "Chd", "Chds"
+};
+
+bool isPathSeparator(char c) {
+    return c == '/' || c == '\\';
+}
+}
+
+PathRules::Trie::Trie(const std::vector<std::string_view>& keys) {
+    for (std::string_view key : keys) {
+        for (char c : key) {
+            uint8_t& symbol = m_symbols[static_cast<unsigned char>(c)];
+            if (symbol == 0) {
+                symbol = static_cast<uint8_t>(++m_width);
+            }
+        }
+    }
+
+    m_edges.assign(m_width, 0);
+    m_values.assign(1, -1);
+    for (size_t index = 0; index < keys.size(); index++) {
+        size_t node = 0;
+        for (char c : keys[index]) {
+            uint16_t& child = m_edges[node * m_width + m_symbols[static_cast<unsigned char>(c)] - 1];
+            if (child == 0) {
+                child = static_cast<uint16_t>(m_values.size());
+                m_values.push_back(-1);
+                m_edges.resize(m_edges.size() + m_width, 0);
+            }
+            node = m_edges[node * m_width + m_symbols[static_cast<unsigned char>(c)] - 1];
+        }
+        m_values[node] = static_cast<int>(index);
+    }
+}
+
+PathRules::PathRules()
+    : m_fillers(kStrikeWords),
+      m_abbreviations(kAbbreviationWords) {
+}
+
+const PathRules& PathRules::get() {
+    static const PathRules rules;
+    return rules;
+}
+
+bool PathRules::isFillerWord(std::string_view word) const {
+    int node = 0;
+    for (char c : word) {
+        node = m_fillers.next(node, static_cast<unsigned char>(std::tolower(static_cast<unsigned char>(c))));
+        if (node < 0) {
+            return false;
+        }
+        if (m_fillers.value(node) >= 0) {
+            return true;  // A strike word is a prefix
+        }
+    }
+    return false;
+}
+
+std::string PathRules::abbreviate(std::string_view text) const {
+    std::string result;
+    result.reserve(text.size());
+
+    size_t pos = 0;
+    while (pos < text.size()) {
+        bool wordStart = pos == 0 || text[pos - 1] == '-' || isPathSeparator(text[pos - 1]);
+        if (wordStart) {
+            // Keys that are prefixes of each other ("Loop", "Loops") differ in their
+            // next character, so at most one of them ends on a word boundary
+            int matched = -1;
+            size_t matchedLength = 0;
+            int node = 0;
+            for (size_t i = pos; i < text.size() && node >= 0; i++) {
+                node = m_abbreviations.next(node, static_cast<unsigned char>(text[i]));
+                if (node >= 0 && m_abbreviations.value(node) >= 0) {
+                    size_t end = i + 1;
+                    if (end == text.size() || text[end] == '-' || text[end] == '.' || isPathSeparator(text[end])) {
+                        matched = m_abbreviations.value(node);
+                        matchedLength = end - pos;
+                    }
+                }
+            }
+            if (matched >= 0) {
+                result += kAbbreviations[static_cast<size_t>(matched)];
+                pos += matchedLength;
+                continue;
+            }
+        }
+        result += text[pos++];
+    }
+    return result;
+}
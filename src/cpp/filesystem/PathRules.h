@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// The word lists behind PathManager's naming rules, compiled once into tries.
+// Checking a word is a single walk over its characters instead of a scan of
+// the whole list, and nothing is allocated per lookup.
+class PathRules {
+public:
+    static const PathRules& get();
+
+    // Filler word: its lowercase form starts with one of the strike words
+    bool isFillerWord(std::string_view word) const;
+
+    // Replaces whole words of the abbreviation dictionary (case-sensitive). A word
+    // starts at the beginning of text or after '-', '/' or '\', and ends at the end
+    // of text or before one of those or '.'
+    std::string abbreviate(std::string_view text) const;
+
+private:
+    // Byte trie over the characters its keys use; node 0 is the root
+    class Trie {
+    public:
+        explicit Trie(const std::vector<std::string_view>& keys);
+
+        // Child along c, or -1
+        int next(int node, unsigned char c) const {
+            int symbol = m_symbols[c];
+            if (symbol == 0) {
+                return -1;
+            }
+            int child = m_edges[static_cast<size_t>(node) * m_width + static_cast<size_t>(symbol - 1)];
+            return child == 0 ? -1 : child;
+        }
+        // Index of the key ending at node, or -1
+        int value(int node) const { return m_values[static_cast<size_t>(node)]; }
+
+    private:
+        uint8_t m_symbols[256] = {};  // Byte -> 1-based column, 0 = never in a key
+        size_t m_width = 0;
+        std::vector<uint16_t> m_edges;  // Node-major, 0 = no child (the root is never a child)
+        std::vector<int> m_values;
+    };
+
+    PathRules();
+
+    Trie m_fillers;
+    Trie m_abbreviations;
+};
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "TraceRecorder.h"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+// Fixed-capacity blocking FIFO connecting two pipeline stages.
+// push() blocks while the queue is full, which applies backpressure to the
+// producing stage; pop() blocks while it is empty. Time spent blocked on either
+// side is summed over all waiting threads so a run can report which stage was
+// the bottleneck.
+template<class T>
+class BoundedQueue {
+public:
+    struct Stats {
+        size_t capacity = 0;
+        size_t maxDepth = 0;
+        size_t pushed = 0;
+        double producerStallSeconds = 0.0;  // Producers waiting for space
+        double consumerStallSeconds = 0.0;  // Consumers waiting for items
+    };
+
+    explicit BoundedQueue(size_t capacity) : m_capacity(capacity > 0 ? capacity : 1) {}
+
+    // Returns false if the queue was closed before the item could be added
+    bool push(T item) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (!m_closed && m_items.size() >= m_capacity) {
+            auto start = std::chrono::steady_clock::now();
+            TraceRecorder::Span span("queue full", "wait");
+            m_notFull.wait(lock, [this] { return m_closed || m_items.size() < m_capacity; });
+            m_producerStall += std::chrono::steady_clock::now() - start;
+        }
+        if (m_closed) {
+            return false;
+        }
+
+        m_items.push_back(std::move(item));
+        m_pushed++;
+        if (m_items.size() > m_maxDepth) {
+            m_maxDepth = m_items.size();
+        }
+        lock.unlock();
+
+        m_notEmpty.notify_one();
+        return true;
+    }
+
+    // Returns false once the queue is closed and fully drained
+    bool pop(T& item) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (!m_closed && m_items.empty()) {
+            auto start = std::chrono::steady_clock::now();
+            TraceRecorder::Span span("queue empty", "wait");
+            m_notEmpty.wait(lock, [this] { return m_closed || !m_items.empty(); });
+            m_consumerStall += std::chrono::steady_clock::now() - start;
+        }
+        if (m_items.empty()) {
+            return false;
+        }
+
+        item = std::move(m_items.front());
+        m_items.pop_front();
+        lock.unlock();
+
+        m_notFull.notify_one();
+        return true;
+    }
+
+    // Wakes every blocked producer and consumer; remaining items can still be popped
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_closed = true;
+        }
+        m_notFull.notify_all();
+        m_notEmpty.notify_all();
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_items.size();
+    }
+
+    Stats getStats() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Stats stats;
+        stats.capacity = m_capacity;
+        stats.maxDepth = m_maxDepth;
+        stats.pushed = m_pushed;
+        stats.producerStallSeconds = std::chrono::duration<double>(m_producerStall).count();
+        stats.consumerStallSeconds = std::chrono::duration<double>(m_consumerStall).count();
+        return stats;
+    }
+
+private:
+    const size_t m_capacity;
+    std::deque<T> m_items;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_notFull;
+    std::condition_variable m_notEmpty;
+    bool m_closed = false;
+
+    size_t m_maxDepth = 0;
+    size_t m_pushed = 0;
+    std::chrono::steady_clock::duration m_producerStall{0};
+    std::chrono::steady_clock::duration m_consumerStall{0};
+};
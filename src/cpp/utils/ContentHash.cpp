@@ -0,0 +1,63 @@
+#include "ContentHash.h"
+#include <cstring>
+
+namespace {
+constexpr uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+
+inline uint64_t rotl(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+inline uint64_t mixRound(uint64_t acc, uint64_t word) {
+    acc += word * kPrime2;
+    return rotl(acc, 31) * kPrime1;
+}
+
+inline uint64_t load64(const unsigned char* p) {
+    uint64_t word;
+    std::memcpy(&word, p, sizeof(word));
+    return word;
+}
+
+inline uint64_t avalanche(uint64_t hash) {
+    hash ^= hash >> 33;
+    hash *= kPrime2;
+    hash ^= hash >> 29;
+    hash *= kPrime1;
+    return hash ^ (hash >> 32);
+}
+}
+
+uint64_t ContentHash::hash(const void* data, size_t size, uint64_t seed) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    const unsigned char* end = p + size;
+
+    uint64_t lanes[4] = {seed + kPrime1 + kPrime2, seed + kPrime2, seed, seed - kPrime1};
+    while (end - p >= 32) {
+        lanes[0] = mixRound(lanes[0], load64(p));
+        lanes[1] = mixRound(lanes[1], load64(p + 8));
+        lanes[2] = mixRound(lanes[2], load64(p + 16));
+        lanes[3] = mixRound(lanes[3], load64(p + 24));
+        p += 32;
+    }
+
+    uint64_t hash = rotl(lanes[0], 1) + rotl(lanes[1], 7) + rotl(lanes[2], 12) + rotl(lanes[3], 18);
+    while (end - p >= 8) {
+        hash = combine(hash, load64(p));
+        p += 8;
+    }
+    if (p < end) {
+        uint64_t tail = 0;
+        std::memcpy(&tail, p, static_cast<size_t>(end - p));
+        hash = combine(hash, tail);
+    }
+
+    hash = avalanche(combine(hash, size));
+    return hash == 0 ? 1 : hash;
+}
+
+uint64_t ContentHash::combine(uint64_t hash, uint64_t value) {
+    hash ^= mixRound(0, value);
+    return rotl(hash, 27) * kPrime1 + kPrime2;
+}
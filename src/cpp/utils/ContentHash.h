@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Fast non-cryptographic 64-bit hash for spotting identical content.
+// Four independent lanes over 32-byte stripes keep the multiply units busy,
+// so hashing a mapped file runs at memory bandwidth. Never returns 0.
+class ContentHash {
+public:
+    static uint64_t hash(const void* data, size_t size, uint64_t seed = 0);
+    // Folds another value (a length, a format code) into a hash
+    static uint64_t combine(uint64_t hash, uint64_t value);
+};
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <string>
+
+// The little JSON the run reports need; values are written with plain stream output
+class Json {
+public:
+    // value as a quoted JSON string, escaped
+    static std::string quote(const std::string& value);
+};
@@ -1,23 +1,87 @@
 #include "Logger.h"
+#include "TraceRecorder.h"
 #include <iostream>
-#include <sstream>
-#include <iomanip>
-#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
 
 Logger& Logger::getInstance() {
     static Logger instance;
     return instance;
 }
 
+Logger::~Logger() {
+    disableAsync();
+}
+
 void Logger::setLevel(Level level) {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    m_level = level;
+    m_level.store(level, std::memory_order_relaxed);
 }
 
 void Logger::setLogFile(const std::string& filename) {
     std::lock_guard<std::mutex> lock(m_mutex);
     m_logFile = filename;
-    m_fileStream = std::make_unique<std::ofstream>(filename, std::ios::app);
+    if (filename.empty()) {
+        m_fileStream.reset();
+    } else {
+        m_fileStream = std::make_unique<std::ofstream>(filename, std::ios::app);
+    }
+}
+
+void Logger::setConsoleOutput(bool enabled) {
+    m_console.store(enabled, std::memory_order_relaxed);
+}
+
+void Logger::enableAsync(size_t capacity, OverflowPolicy policy) {
+    disableAsync();
+
+    // Round up to a power of two so slot lookup is a mask
+    size_t size = 2;
+    while (size < capacity) {
+        size <<= 1;
+    }
+
+    m_ring.reset(new Record[size]);
+    m_ringMask = size - 1;
+    for (size_t i = 0; i < size; i++) {
+        m_ring[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    m_policy = policy;
+    m_enqueuePos.store(0, std::memory_order_relaxed);
+    m_writtenPos.store(0, std::memory_order_relaxed);
+    m_dequeuePos = 0;
+    m_sinkStop.store(false, std::memory_order_relaxed);
+
+    m_sink = std::thread(&Logger::sinkLoop, this);
+    m_async.store(true, std::memory_order_release);
+}
+
+void Logger::disableAsync() {
+    if (!m_sink.joinable()) return;
+
+    // The sink drains everything already claimed before it exits
+    m_async.store(false, std::memory_order_release);
+    m_sinkStop.store(true, std::memory_order_release);
+    wakeSink();
+    m_sink.join();
+}
+
+void Logger::flush() {
+    if (isAsync()) {
+        size_t target = m_enqueuePos.load(std::memory_order_acquire);
+        wakeSink();
+        std::unique_lock<std::mutex> lock(m_sinkMutex);
+        m_flushCondition.wait(lock, [this, target] {
+            return m_writtenPos.load(std::memory_order_acquire) >= target;
+        });
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::cout.flush();
+    if (m_fileStream && m_fileStream->is_open()) {
+        m_fileStream->flush();
+    }
 }
 
 void Logger::debug(const std::string& message) {
@@ -37,23 +101,163 @@ void Logger::error(const std::string& message) {
 }
 
 void Logger::log(Level level, const std::string& message) {
-    if (level < m_level) return;
-    
+    if (level < m_level.load(std::memory_order_relaxed)) return;
+
+    if (m_async.load(std::memory_order_acquire)) {
+        if (!tryEnqueue(level, message)) {
+            if (m_policy != BLOCK) {
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            // Ring is full: make sure the sink is running and let it catch up
+            TraceRecorder::Span span("log full", "wait");
+            do {
+                wakeSink();
+                std::this_thread::yield();
+            } while (!tryEnqueue(level, message));
+        }
+        if (m_sinkWaiting.load(std::memory_order_seq_cst)) {
+            wakeSink();
+        }
+        return;
+    }
+
+    TraceRecorder::Span span("log", "logger");
     std::lock_guard<std::mutex> lock(m_mutex);
-    
-    std::stringstream ss;
-    ss << getTimestamp() << " [" << levelToString(level) << "] " << message << std::endl;
-    
+
+    Batch batch;
+    appendLine(batch, level, std::chrono::system_clock::now(), message);
+    writeBatch(batch);
+}
+
+bool Logger::tryEnqueue(Level level, const std::string& message) {
+    size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+    Record* record;
+    for (;;) {
+        record = &m_ring[pos & m_ringMask];
+        size_t sequence = record->sequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+        if (diff == 0) {
+            if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;  // Full: the sink has not released this slot yet
+        } else {
+            pos = m_enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    // The slot's string keeps its capacity between uses, so this rarely allocates
+    record->level = level;
+    record->time = std::chrono::system_clock::now();
+    record->message.assign(message);
+    record->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+void Logger::wakeSink() {
+    std::lock_guard<std::mutex> lock(m_sinkMutex);
+    m_sinkCondition.notify_one();
+}
+
+void Logger::sinkLoop() {
+    TraceRecorder::getInstance().setThreadName("log");
+    Batch batch;
+    for (;;) {
+        size_t written;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            batch.clear();
+            written = drainBatch(batch);
+
+            size_t dropped = m_dropped.load(std::memory_order_relaxed);
+            if (m_policy == COUNT && dropped != m_reportedDrops) {
+                appendLine(batch, WARNING, std::chrono::system_clock::now(),
+                           "Logger dropped " + std::to_string(dropped - m_reportedDrops) + " messages (queue full)");
+                m_reportedDrops = dropped;
+            }
+            if (!batch.empty()) {
+                TraceRecorder::Span span("log write", "logger");
+                writeBatch(batch);
+            }
+        }
+
+        if (written > 0) {
+            m_writtenPos.store(m_dequeuePos, std::memory_order_release);
+            {
+                std::lock_guard<std::mutex> lock(m_sinkMutex);
+            }
+            m_flushCondition.notify_all();
+            continue;
+        }
+
+        if (m_sinkStop.load(std::memory_order_acquire)) {
+            // A producer may have claimed a slot but not filled it yet
+            if (m_dequeuePos == m_enqueuePos.load(std::memory_order_acquire)) break;
+            std::this_thread::yield();
+            continue;
+        }
+
+        // Producers only pay for a notify when the sink is actually parked
+        std::unique_lock<std::mutex> lock(m_sinkMutex);
+        m_sinkWaiting.store(true, std::memory_order_seq_cst);
+        Record& next = m_ring[m_dequeuePos & m_ringMask];
+        if (next.sequence.load(std::memory_order_acquire) != m_dequeuePos + 1 &&
+            !m_sinkStop.load(std::memory_order_acquire)) {
+            m_sinkCondition.wait_for(lock, std::chrono::milliseconds(50));
+        }
+        m_sinkWaiting.store(false, std::memory_order_relaxed);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_sinkMutex);
+    }
+    m_flushCondition.notify_all();
+}
+
+size_t Logger::drainBatch(Batch& batch) {
+    size_t count = 0;
+    for (;;) {
+        Record& record = m_ring[m_dequeuePos & m_ringMask];
+        if (record.sequence.load(std::memory_order_acquire) != m_dequeuePos + 1) break;
+
+        appendLine(batch, record.level, record.time, record.message);
+        record.sequence.store(m_dequeuePos + m_ringMask + 1, std::memory_order_release);
+        m_dequeuePos++;
+        count++;
+    }
+    return count;
+}
+
+void Logger::appendLine(Batch& batch, Level level, std::chrono::system_clock::time_point time, const std::string& message) {
+    std::string line = getTimestamp(time);
+    line += " [";
+    line += levelToString(level);
+    line += "] ";
+    line += message;
+    line += '\n';
+
+    if (m_console.load(std::memory_order_relaxed)) {
+        (level >= WARNING ? batch.err : batch.out) += line;
+    }
+    if (m_fileStream && m_fileStream->is_open()) {
+        batch.file += line;
+    }
+}
+
+void Logger::writeBatch(const Batch& batch) {
     // Output to console
-    if (level >= WARNING) {
-        std::cerr << ss.str();
-    } else {
-        std::cout << ss.str();
+    if (!batch.err.empty()) {
+        std::cerr << batch.err;
+    }
+    if (!batch.out.empty()) {
+        std::cout << batch.out << std::flush;
     }
-    
+
     // Output to file if set
-    if (m_fileStream && m_fileStream->is_open()) {
-        *m_fileStream << ss.str();
+    if (!batch.file.empty()) {
+        *m_fileStream << batch.file;
         m_fileStream->flush();
     }
 }
@@ -68,15 +272,22 @@ std::string Logger::levelToString(Level level) {
     }
 }
 
-std::string Logger::getTimestamp() {
-    auto now = std::chrono::system_clock::now();
-    auto time_t = std::chrono::system_clock::to_time_t(now);
+std::string Logger::getTimestamp(std::chrono::system_clock::time_point time) {
+    auto time_t = std::chrono::system_clock::to_time_t(time);
     auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-        now.time_since_epoch()) % 1000;
-    
-    std::stringstream ss;
-    ss << std::put_time(std::localtime(&time_t), "%Y-%m-%d %H:%M:%S");
-    ss << '.' << std::setfill('0') << std::setw(3) << ms.count();
-    
-    return ss.str();
+        time.time_since_epoch()) % 1000;
+
+    // localtime_r and strftime are only needed once per second
+    if (time_t != m_cachedSecond) {
+        std::tm local;
+        localtime_r(&time_t, &local);
+        char buffer[32];
+        std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &local);
+        m_cachedTimestamp = buffer;
+        m_cachedSecond = time_t;
+    }
+
+    char millis[8];
+    std::snprintf(millis, sizeof(millis), ".%03d", static_cast<int>(ms.count()));
+    return m_cachedTimestamp + millis;
 }
@@ -4,6 +4,11 @@
 #include <fstream>
 #include <mutex>
 #include <memory>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <thread>
+#include <vector>
 
 class Logger {
 public:
@@ -14,29 +19,95 @@ public:
         ERROR = 3
     };
 
+    // What a producer does when the async ring buffer is full
+    enum OverflowPolicy {
+        BLOCK = 0,  // Wait for the sink to free a slot (never loses messages)
+        DROP = 1,   // Discard the message silently
+        COUNT = 2   // Discard the message and have the sink report how many were lost
+    };
+
+    static constexpr size_t DEFAULT_ASYNC_CAPACITY = 8192;
+
     static Logger& getInstance();
-    
+
     void setLevel(Level level);
     void setLogFile(const std::string& filename);
-    
+    void setConsoleOutput(bool enabled);
+
+    // Hand messages to a background sink thread through a lock-free MPSC ring buffer.
+    // Switch modes before worker threads start logging.
+    void enableAsync(size_t capacity = DEFAULT_ASYNC_CAPACITY, OverflowPolicy policy = BLOCK);
+    void disableAsync();
+    bool isAsync() const { return m_async.load(std::memory_order_acquire); }
+
+    // Block until every message logged so far has been written out
+    void flush();
+    size_t getDroppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+
     void debug(const std::string& message);
     void info(const std::string& message);
     void warning(const std::string& message);
     void error(const std::string& message);
-    
+
     void log(Level level, const std::string& message);
 
 private:
     Logger() = default;
-    ~Logger() = default;
+    ~Logger();
     Logger(const Logger&) = delete;
     Logger& operator=(const Logger&) = delete;
-    
-    Level m_level = INFO;
+
+    struct Record {
+        std::atomic<size_t> sequence{0};
+        Level level = INFO;
+        std::chrono::system_clock::time_point time;
+        std::string message;
+    };
+
+    std::atomic<Level> m_level{INFO};
+    std::atomic<bool> m_console{true};
     std::string m_logFile;
     std::mutex m_mutex;
     std::unique_ptr<std::ofstream> m_fileStream;
-    
+
+    // Async mode: producers claim slots with a CAS on m_enqueuePos, the sink is the only consumer
+    std::atomic<bool> m_async{false};
+    OverflowPolicy m_policy = BLOCK;
+    std::unique_ptr<Record[]> m_ring;
+    size_t m_ringMask = 0;
+    alignas(64) std::atomic<size_t> m_enqueuePos{0};
+    alignas(64) std::atomic<size_t> m_writtenPos{0};
+    size_t m_dequeuePos = 0;  // Owned by the sink thread
+    std::atomic<size_t> m_dropped{0};
+    size_t m_reportedDrops = 0;
+
+    std::thread m_sink;
+    std::atomic<bool> m_sinkStop{false};
+    std::atomic<bool> m_sinkWaiting{false};
+    std::mutex m_sinkMutex;
+    std::condition_variable m_sinkCondition;
+    std::condition_variable m_flushCondition;
+
+    // Timestamp cache: only the millisecond suffix changes within a second
+    std::time_t m_cachedSecond = -1;
+    std::string m_cachedTimestamp;
+
+    // Formatted lines waiting to be written in one go
+    struct Batch {
+        std::string out;
+        std::string err;
+        std::string file;
+        void clear() { out.clear(); err.clear(); file.clear(); }
+        bool empty() const { return out.empty() && err.empty() && file.empty(); }
+    };
+
+    bool tryEnqueue(Level level, const std::string& message);
+    void wakeSink();
+    void sinkLoop();
+    size_t drainBatch(Batch& batch);
+    void appendLine(Batch& batch, Level level, std::chrono::system_clock::time_point time, const std::string& message);
+    void writeBatch(const Batch& batch);
+
     std::string levelToString(Level level);
-    std::string getTimestamp();
+    std::string getTimestamp(std::chrono::system_clock::time_point time);
 };
@@ -0,0 +1,238 @@
+#include "StageProfiler.h"
+#include <algorithm>
+#include <chrono>
+
+namespace {
+// The calling thread's histograms, given back for reuse when the thread exits
+struct LocalBlock {
+    std::atomic<bool>* inUse = nullptr;
+    void* block = nullptr;
+
+    ~LocalBlock() {
+        if (inUse) {
+            inUse->store(false, std::memory_order_release);
+        }
+    }
+};
+thread_local LocalBlock t_block;
+
+// Owner-only update: no other thread writes these, so a read-modify-write is not needed
+void add(std::atomic<uint64_t>& counter, uint64_t value) {
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+int floorLog2(uint64_t value) {
+    int exponent = 0;
+    while (value >>= 1) {
+        exponent++;
+    }
+    return exponent;
+}
+}
+
+StageProfiler::Timer::Timer(uint64_t& totalNanos)
+    : m_total(&totalNanos),
+      m_active(StageProfiler::getInstance().isEnabled()) {
+    if (m_active) {
+        m_start = now();
+    }
+}
+
+StageProfiler::Timer::Timer(Stage stage)
+    : m_stage(stage),
+      m_active(StageProfiler::getInstance().isEnabled()) {
+    if (m_active) {
+        m_start = now();
+    }
+}
+
+StageProfiler::Timer::~Timer() {
+    if (!m_active) {
+        return;
+    }
+    uint64_t elapsed = now() - m_start;
+    if (m_total) {
+        *m_total += elapsed;
+    } else {
+        StageProfiler::getInstance().record(m_stage, elapsed);
+    }
+}
+
+StageProfiler& StageProfiler::getInstance() {
+    // Never destroyed: threads still running during static destruction (the logger's sink)
+    // hand their buffer back when they exit
+    static StageProfiler* instance = new StageProfiler();
+    return *instance;
+}
+
+StageProfiler::Histograms::Histograms() {
+    clear();
+}
+
+void StageProfiler::Histograms::clear() {
+    for (PerStage& stage : stages) {
+        stage.count.store(0, std::memory_order_relaxed);
+        stage.total.store(0, std::memory_order_relaxed);
+        stage.max.store(0, std::memory_order_relaxed);
+        for (auto& bucket : stage.buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+void StageProfiler::reset() {
+    std::lock_guard<std::mutex> lock(m_blocksMutex);
+    for (auto& block : m_blocks) {
+        block->clear();
+    }
+}
+
+StageProfiler::Histograms& StageProfiler::local() {
+    if (t_block.block) {
+        return *static_cast<Histograms*>(t_block.block);
+    }
+
+    // First sample on this thread: take over the block of a thread that has exited, or add one
+    std::lock_guard<std::mutex> lock(m_blocksMutex);
+    Histograms* claimed = nullptr;
+    for (auto& block : m_blocks) {
+        bool expected = false;
+        if (block->inUse.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            claimed = block.get();
+            break;
+        }
+    }
+    if (!claimed) {
+        m_blocks.push_back(std::make_unique<Histograms>());
+        claimed = m_blocks.back().get();
+        claimed->inUse.store(true, std::memory_order_relaxed);
+    }
+    t_block.inUse = &claimed->inUse;
+    t_block.block = claimed;
+    return *claimed;
+}
+
+void StageProfiler::record(Stage stage, uint64_t nanos) {
+    if (!isEnabled() || stage >= STAGE_COUNT) {
+        return;
+    }
+    Histograms::PerStage& histogram = local().stages[stage];
+    add(histogram.count, 1);
+    add(histogram.total, nanos);
+    add(histogram.buckets[bucketOf(nanos)], 1);
+    if (nanos > histogram.max.load(std::memory_order_relaxed)) {
+        histogram.max.store(nanos, std::memory_order_relaxed);
+    }
+}
+
+std::vector<StageProfiler::Summary> StageProfiler::summarize() const {
+    std::vector<Summary> summaries;
+    std::vector<uint64_t> buckets(BUCKET_COUNT);
+
+    std::lock_guard<std::mutex> lock(m_blocksMutex);
+    for (int stage = 0; stage < STAGE_COUNT; stage++) {
+        Summary summary;
+        summary.stage = static_cast<Stage>(stage);
+        std::fill(buckets.begin(), buckets.end(), 0);
+        for (const auto& block : m_blocks) {
+            const Histograms::PerStage& histogram = block->stages[stage];
+            summary.count += histogram.count.load(std::memory_order_relaxed);
+            summary.totalNanos += histogram.total.load(std::memory_order_relaxed);
+            summary.maxNanos = std::max(summary.maxNanos, histogram.max.load(std::memory_order_relaxed));
+            for (size_t bucket = 0; bucket < BUCKET_COUNT; bucket++) {
+                buckets[bucket] += histogram.buckets[bucket].load(std::memory_order_relaxed);
+            }
+        }
+        if (summary.count == 0) {
+            continue;
+        }
+
+        // Smallest bucket holding the rank-th sample, reported by its upper bound (never above the max)
+        auto percentile = [&](double fraction) {
+            uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(fraction * summary.count + 0.999999));
+            uint64_t seen = 0;
+            for (size_t bucket = 0; bucket < BUCKET_COUNT; bucket++) {
+                seen += buckets[bucket];
+                if (seen >= rank) {
+                    return bucket == BUCKET_COUNT - 1 ? summary.maxNanos
+                                                      : std::min(bucketUpperBound(bucket), summary.maxNanos);
+                }
+            }
+            return summary.maxNanos;
+        };
+        summary.p50Nanos = percentile(0.50);
+        summary.p95Nanos = percentile(0.95);
+        summary.p99Nanos = percentile(0.99);
+        summaries.push_back(summary);
+    }
+    return summaries;
+}
+
+const char* StageProfiler::stageName(Stage stage) {
+    switch (stage) {
+        case SCAN:
+            return "scan";
+        case PROBE:
+            return "probe";
+        case PATH:
+            return "path";
+        case DECODE:
+            return "decode";
+        case TRANSFORM:
+            return "transform";
+        case ENCODE:
+            return "encode";
+        case CLOSE:
+            return "close";
+        case MKDIR:
+            return "mkdir";
+        case COPY:
+            return "copy";
+        case ACCELERATE:
+            return "accelerate";
+        default:
+            return "unknown";
+    }
+}
+
+const char* StageProfiler::stageKind(Stage stage) {
+    switch (stage) {
+        case PATH:
+        case TRANSFORM:
+        case ACCELERATE:
+            return "cpu";
+        case DECODE:
+        case ENCODE:
+            return "mixed";  // Codec work on top of the reads and writes
+        default:
+            return "io";
+    }
+}
+
+uint64_t StageProfiler::now() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+size_t StageProfiler::bucketOf(uint64_t nanos) {
+    constexpr uint64_t subBuckets = uint64_t(1) << SUB_BUCKET_BITS;
+    if (nanos < subBuckets) {
+        return static_cast<size_t>(nanos);  // Exact below the first power of two with sub-buckets
+    }
+    int exponent = floorLog2(nanos);
+    if (exponent > MAX_EXPONENT) {
+        return BUCKET_COUNT - 1;
+    }
+    uint64_t sub = (nanos >> (exponent - SUB_BUCKET_BITS)) - subBuckets;
+    return static_cast<size_t>((exponent - SUB_BUCKET_BITS + 1) * subBuckets + sub);
+}
+
+uint64_t StageProfiler::bucketUpperBound(size_t bucket) {
+    constexpr size_t subBuckets = size_t(1) << SUB_BUCKET_BITS;
+    if (bucket < subBuckets) {
+        return bucket;
+    }
+    int shift = static_cast<int>(bucket / subBuckets) - 1;
+    uint64_t lower = static_cast<uint64_t>(subBuckets + bucket % subBuckets) << shift;
+    return lower + (uint64_t(1) << shift) - 1;
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Where the time of a run goes, per file and per stage. Each thread records into
+// its own histograms (no locks, no shared cache lines), which summarize() merges
+// into count, total and p50/p95/p99/max per stage. Buckets are log-linear, 16 per
+// power of two, so percentiles are within about 6% of the exact value.
+//
+// Off by default; while off, timers do not even read the clock.
+class StageProfiler {
+public:
+    enum Stage {
+        SCAN = 0,    // Listing one directory (stat included, probing and planning excluded)
+        PROBE,       // Parsing one file's header during the scan
+        PATH,        // Naming one output
+        DECODE,      // Opening and reading one source
+        TRANSFORM,   // Trimming, resampling and requantizing one file
+        ENCODE,      // Creating and writing one output
+        CLOSE,       // Flushing and closing one output
+        MKDIR,       // Creating one output's directory
+        COPY,        // Cloning one already M8-ready source
+        ACCELERATE,  // One AppleSiliconProcessor call
+        STAGE_COUNT
+    };
+
+    struct Summary {
+        Stage stage = SCAN;
+        uint64_t count = 0;
+        uint64_t totalNanos = 0;
+        uint64_t p50Nanos = 0;
+        uint64_t p95Nanos = 0;
+        uint64_t p99Nanos = 0;
+        uint64_t maxNanos = 0;
+    };
+
+    // Adds the time until it is destroyed to a running total, or records it as one sample of a stage
+    class Timer {
+    public:
+        explicit Timer(uint64_t& totalNanos);
+        explicit Timer(Stage stage);
+        ~Timer();
+
+        Timer(const Timer&) = delete;
+        Timer& operator=(const Timer&) = delete;
+
+    private:
+        uint64_t* m_total = nullptr;
+        Stage m_stage = STAGE_COUNT;
+        uint64_t m_start = 0;
+        bool m_active = false;
+    };
+
+    static StageProfiler& getInstance();
+
+    void setEnabled(bool enabled) { m_enabled.store(enabled, std::memory_order_relaxed); }
+    bool isEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+    // Forgets every sample; only while no thread is recording
+    void reset();
+
+    // One sample for stage (ignored while disabled)
+    void record(Stage stage, uint64_t nanos);
+
+    // Stages with at least one sample, in Stage order
+    std::vector<Summary> summarize() const;
+
+    static const char* stageName(Stage stage);
+    // "io", "cpu" or "mixed": what a stage mostly waits on
+    static const char* stageKind(Stage stage);
+
+    // Monotonic nanoseconds
+    static uint64_t now();
+
+    // Bucket math, exposed for tests: every value in a bucket maps back to the same upper bound
+    static size_t bucketOf(uint64_t nanos);
+    static uint64_t bucketUpperBound(size_t bucket);
+
+    static constexpr int SUB_BUCKET_BITS = 4;
+    static constexpr int MAX_EXPONENT = 42;  // About 73 minutes; longer samples share the last bucket
+    static constexpr size_t BUCKET_COUNT = (size_t(1) << SUB_BUCKET_BITS) * (MAX_EXPONENT - SUB_BUCKET_BITS + 2);
+
+private:
+    StageProfiler() = default;
+    StageProfiler(const StageProfiler&) = delete;
+    StageProfiler& operator=(const StageProfiler&) = delete;
+
+    // One thread's samples. Written only by the owning thread (relaxed load + store, no RMW);
+    // a block outlives its thread and is handed to the next new thread, keeping its samples
+    struct Histograms {
+        struct PerStage {
+            std::atomic<uint64_t> count{0};
+            std::atomic<uint64_t> total{0};
+            std::atomic<uint64_t> max{0};
+            std::atomic<uint64_t> buckets[BUCKET_COUNT];
+        };
+        std::atomic<bool> inUse{false};
+        PerStage stages[STAGE_COUNT];
+
+        Histograms();
+        void clear();
+    };
+
+    Histograms& local();
+
+    std::atomic<bool> m_enabled{false};
+    mutable std::mutex m_blocksMutex;
+    std::vector<std::unique_ptr<Histograms>> m_blocks;
+};
@@ -1,9 +1,36 @@
 #include "ThreadPool.h"
+#include "TraceRecorder.h"
 #include <algorithm>
+#include <functional>
+
+namespace {
+// Identifies the pool and queue owned by the calling thread, if it is a worker
+thread_local const ThreadPool* t_currentPool = nullptr;
+thread_local size_t t_workerIndex = 0;
+
+// Attempts to find work before a worker goes to sleep
+constexpr int kSpinAttempts = 64;
+
+// Cheap per-thread xorshift generator for picking steal victims
+size_t nextRandom() {
+    thread_local uint64_t state = std::hash<std::thread::id>{}(std::this_thread::get_id()) | 1;
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return static_cast<size_t>(state);
+}
+}
+
+ThreadPool::ThreadPool(size_t numThreads, std::string name)
+    : m_name(std::move(name)), m_stop(false), m_activeThreads(0) {
+    numThreads = std::max<size_t>(numThreads, 1);
+
+    for (size_t i = 0; i < numThreads; ++i) {
+        m_queues.push_back(std::make_unique<WorkerQueue>());
+    }
 
-ThreadPool::ThreadPool(size_t numThreads) : m_stop(false), m_activeThreads(0) {
     for (size_t i = 0; i < numThreads; ++i) {
-        m_workers.emplace_back([this] { worker(); });
+        m_workers.emplace_back([this, i] { worker(i); });
     }
 }
 
@@ -11,21 +38,21 @@ ThreadPool::~ThreadPool() {
     shutdown();
 }
 
-// Template implementation moved to header file
+// Template implementation in header file
 
 void ThreadPool::waitForAll() {
-    std::unique_lock<std::mutex> lock(m_queueMutex);
-    m_condition.wait(lock, [this] { return m_tasks.empty() && m_activeThreads == 0; });
+    std::unique_lock<std::mutex> lock(m_idleMutex);
+    m_idleCondition.wait(lock, [this] { return m_pendingTasks.load() == 0 && m_activeThreads.load() == 0; });
 }
 
 void ThreadPool::shutdown() {
     {
-        std::unique_lock<std::mutex> lock(m_queueMutex);
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
         m_stop = true;
     }
-    
+
     m_condition.notify_all();
-    
+
     for (std::thread &worker : m_workers) {
         if (worker.joinable()) {
             worker.join();
@@ -33,37 +60,155 @@ void ThreadPool::shutdown() {
     }
 }
 
-size_t ThreadPool::getQueueSize() const {
-    std::lock_guard<std::mutex> lock(const_cast<std::mutex&>(m_queueMutex));
-    return m_tasks.size();
+void ThreadPool::submit(PoolTask* task) {
+    // Counted before it becomes visible so waitForAll never sees a false idle state
+    m_pendingTasks.fetch_add(1);
+
+    if (t_currentPool == this) {
+        // Nested submission from one of our workers: keep it local
+        m_queues[t_workerIndex]->deque.push(task);
+    } else {
+        auto& inbox = m_queues[m_nextQueue.fetch_add(1, std::memory_order_relaxed) % m_queues.size()]->inbox;
+        PoolTask* head = inbox.load(std::memory_order_relaxed);
+        do {
+            task->next = head;
+        } while (!inbox.compare_exchange_weak(head, task, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    wakeWorker();
 }
 
-void ThreadPool::worker() {
-    while (true) {
-        std::function<void()> task;
-        
+void ThreadPool::submitPrioritized(PoolTask* task, double priority) {
+    m_pendingTasks.fetch_add(1);
+
+    {
+        std::lock_guard<std::mutex> lock(m_priorityMutex);
+        m_priorityQueue.push({priority, m_prioritySequence++, task});
+        m_prioritizedTasks.fetch_add(1, std::memory_order_release);
+    }
+
+    wakeWorker();
+}
+
+void ThreadPool::wakeWorker() {
+    // Only touch the mutex when a worker is actually asleep
+    if (m_sleepingWorkers.load() > 0) {
         {
-            std::unique_lock<std::mutex> lock(m_queueMutex);
-            m_condition.wait(lock, [this] { return m_stop || !m_tasks.empty(); });
-            
-            if (m_stop && m_tasks.empty()) {
-                return;
-            }
-            
-            task = std::move(m_tasks.front());
-            m_tasks.pop();
-            m_activeThreads++;
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
         }
-        
-        task();
-        
+        m_condition.notify_one();
+    }
+}
+
+PoolTask* ThreadPool::popPrioritized() {
+    if (m_prioritizedTasks.load(std::memory_order_acquire) == 0) {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(m_priorityMutex);
+    if (m_priorityQueue.empty()) {
+        return nullptr;
+    }
+    PoolTask* task = m_priorityQueue.top().task;
+    m_priorityQueue.pop();
+    m_prioritizedTasks.fetch_sub(1, std::memory_order_relaxed);
+    return task;
+}
+
+PoolTask* ThreadPool::findTask(size_t index) {
+    WorkerQueue& own = *m_queues[index];
+
+    if (PoolTask* task = popPrioritized()) {
+        return task;
+    }
+    if (PoolTask* task = own.deque.pop()) {
+        return task;
+    }
+    if (PoolTask* task = drainInbox(own.inbox, index)) {
+        return task;
+    }
+
+    // Steal from a random victim, falling through the rest in order
+    size_t count = m_queues.size();
+    size_t start = nextRandom() % count;
+    for (size_t i = 0; i < count; ++i) {
+        size_t victim = (start + i) % count;
+        if (victim == index) {
+            continue;
+        }
+        if (PoolTask* task = m_queues[victim]->deque.steal()) {
+            return task;
+        }
+        if (PoolTask* task = drainInbox(m_queues[victim]->inbox, index)) {
+            return task;
+        }
+    }
+
+    return nullptr;
+}
+
+PoolTask* ThreadPool::drainInbox(std::atomic<PoolTask*>& inbox, size_t index) {
+    PoolTask* list = inbox.exchange(nullptr, std::memory_order_acquire);
+    if (!list) {
+        return nullptr;
+    }
+
+    // The inbox is newest-first. Push everything but the oldest task onto our
+    // deque newest-first, so subsequent pops keep submission (FIFO) order,
+    // and run the oldest one right away.
+    WorkStealingDeque& deque = m_queues[index]->deque;
+    while (list->next) {
+        PoolTask* next = list->next;
+        list->next = nullptr;
+        deque.push(list);
+        list = next;
+    }
+
+    return list;
+}
+
+void ThreadPool::runTask(PoolTask* task) {
+    m_activeThreads++;
+    m_pendingTasks--;
+
+    {
+        TraceRecorder::Span span("task", "pool");
+        task->function();
+    }
+    delete task;
+
+    if (m_activeThreads.fetch_sub(1) == 1 && m_pendingTasks.load() == 0) {
         {
-            std::lock_guard<std::mutex> lock(m_queueMutex);
-            m_activeThreads--;
+            std::lock_guard<std::mutex> lock(m_idleMutex);
         }
-        
-        m_condition.notify_all();
+        m_idleCondition.notify_all();
     }
 }
 
-// Template instantiation will be handled by the compiler
+void ThreadPool::worker(size_t index) {
+    t_currentPool = this;
+    t_workerIndex = index;
+    TraceRecorder::getInstance().setThreadName(m_name + " " + std::to_string(index));
+
+    while (true) {
+        PoolTask* task = findTask(index);
+        for (int spin = 0; !task && spin < kSpinAttempts; ++spin) {
+            std::this_thread::yield();
+            task = findTask(index);
+        }
+
+        if (task) {
+            runTask(task);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        if (m_stop && m_pendingTasks.load() == 0) {
+            return;
+        }
+
+        m_sleepingWorkers++;
+        m_condition.wait(lock, [this] { return m_stop || m_pendingTasks.load() > 0; });
+        m_sleepingWorkers--;
+    }
+}
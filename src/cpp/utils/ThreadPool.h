@@ -1,58 +1,122 @@
 #pragma once
 
+#include "WorkStealingDeque.h"
 #include <vector>
-#include <queue>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
 #include <functional>
 #include <future>
 #include <atomic>
+#include <memory>
+#include <queue>
+#include <stdexcept>
+#include <string>
 
+// Work-stealing thread pool.
+// Every worker owns a deque; tasks submitted from outside the pool land in a
+// per-worker lock-free inbox, tasks submitted from a worker go straight onto its
+// own deque, and idle workers steal from random victims. Sleeping workers are
+// woken one at a time, only when there is someone asleep to wake.
 class ThreadPool {
 public:
-    explicit ThreadPool(size_t numThreads = std::thread::hardware_concurrency());
+    // name labels the workers in traces ("read" gives "read 0", "read 1", ...)
+    explicit ThreadPool(size_t numThreads = std::thread::hardware_concurrency(), std::string name = "pool");
     ~ThreadPool();
-    
+
     template<class F, class... Args>
-    auto enqueue(F&& f, Args&&... args) 
+    auto enqueue(F&& f, Args&&... args)
         -> std::future<typename std::invoke_result_t<F, Args...>> {
-        
+
         using return_type = typename std::invoke_result_t<F, Args...>;
-        
+
         auto task = std::make_shared<std::packaged_task<return_type()>>(
             std::bind(std::forward<F>(f), std::forward<Args>(args)...)
         );
-        
+
         std::future<return_type> result = task->get_future();
-        
-        {
-            std::unique_lock<std::mutex> lock(m_queueMutex);
-            
-            if (m_stop) {
-                throw std::runtime_error("enqueue on stopped ThreadPool");
-            }
-            
-            m_tasks.emplace([task]() { (*task)(); });
+
+        if (m_stop) {
+            throw std::runtime_error("enqueue on stopped ThreadPool");
         }
-        
-        m_condition.notify_one();
+
+        submit(new PoolTask{[task]() { (*task)(); }});
         return result;
     }
-    
+
+    // Runs ahead of every task of lower priority that has not started yet; equal
+    // priorities run in submission order
+    template<class F, class... Args>
+    auto enqueuePrioritized(double priority, F&& f, Args&&... args)
+        -> std::future<typename std::invoke_result_t<F, Args...>> {
+
+        using return_type = typename std::invoke_result_t<F, Args...>;
+
+        auto task = std::make_shared<std::packaged_task<return_type()>>(
+            std::bind(std::forward<F>(f), std::forward<Args>(args)...)
+        );
+
+        std::future<return_type> result = task->get_future();
+
+        if (m_stop) {
+            throw std::runtime_error("enqueue on stopped ThreadPool");
+        }
+
+        submitPrioritized(new PoolTask{[task]() { (*task)(); }}, priority);
+        return result;
+    }
+
     void waitForAll();
     void shutdown();
-    
+
+    size_t getThreadCount() const { return m_workers.size(); }
     size_t getActiveThreads() const { return m_activeThreads.load(); }
-    size_t getQueueSize() const;
+    size_t getQueueSize() const { return m_pendingTasks.load(); }
 
 private:
+    struct WorkerQueue {
+        WorkStealingDeque deque;
+        std::atomic<PoolTask*> inbox{nullptr};  // Lock-free LIFO stack of external submissions
+    };
+
+    struct PrioritizedTask {
+        double priority;
+        uint64_t sequence;
+        PoolTask* task;
+
+        // Max-heap on priority, FIFO among equals
+        bool operator<(const PrioritizedTask& other) const {
+            return priority != other.priority ? priority < other.priority : sequence > other.sequence;
+        }
+    };
+
+    std::string m_name;
     std::vector<std::thread> m_workers;
-    std::queue<std::function<void()>> m_tasks;
-    std::mutex m_queueMutex;
+    std::vector<std::unique_ptr<WorkerQueue>> m_queues;
+
+    std::mutex m_priorityMutex;
+    std::priority_queue<PrioritizedTask> m_priorityQueue;
+    uint64_t m_prioritySequence = 0;
+    std::atomic<size_t> m_prioritizedTasks{0};  // Lets workers skip the mutex while the queue is empty
+    std::atomic<size_t> m_nextQueue{0};
+
+    std::mutex m_sleepMutex;
     std::condition_variable m_condition;
+    std::atomic<size_t> m_sleepingWorkers{0};
+
+    std::mutex m_idleMutex;
+    std::condition_variable m_idleCondition;
+
     std::atomic<bool> m_stop;
     std::atomic<size_t> m_activeThreads;
-    
-    void worker();
+    std::atomic<size_t> m_pendingTasks{0};
+
+    void submit(PoolTask* task);
+    void submitPrioritized(PoolTask* task, double priority);
+    void wakeWorker();
+    PoolTask* popPrioritized();
+    PoolTask* findTask(size_t index);
+    PoolTask* drainInbox(std::atomic<PoolTask*>& inbox, size_t index);
+    void runTask(PoolTask* task);
+    void worker(size_t index);
 };
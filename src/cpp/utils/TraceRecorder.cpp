@@ -0,0 +1,245 @@
+#include "TraceRecorder.h"
+#include "Json.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <unistd.h>
+
+namespace {
+// The calling thread's buffer, given back for reuse when the thread exits
+struct LocalBuffer {
+    std::atomic<bool>* inUse = nullptr;
+    void* buffer = nullptr;
+    std::string threadName;  // Kept for when the buffer is created
+
+    ~LocalBuffer() {
+        if (inUse) {
+            inUse->store(false, std::memory_order_release);
+        }
+    }
+};
+thread_local LocalBuffer t_buffer;
+
+// Nanoseconds as microseconds with three decimals, the trace format's time unit
+std::string micros(uint64_t nanos) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%llu.%03llu", static_cast<unsigned long long>(nanos / 1000),
+                  static_cast<unsigned long long>(nanos % 1000));
+    return text;
+}
+}
+
+TraceRecorder::Span::Span(const char* name, const char* category)
+    : m_name(name),
+      m_category(category),
+      m_active(TraceRecorder::getInstance().isEnabled()) {
+    if (m_active) {
+        m_start = now();
+    }
+}
+
+TraceRecorder::Span::Span(const char* name, const char* category, const std::string& file, uint64_t bytes)
+    : m_name(name),
+      m_category(category),
+      m_file(&file),
+      m_bytes(bytes),
+      m_active(TraceRecorder::getInstance().isEnabled()) {
+    if (m_active) {
+        m_start = now();
+    }
+}
+
+TraceRecorder::Span::~Span() {
+    if (!m_active) {
+        return;
+    }
+    uint64_t end = now();
+    static const std::string noFile;
+    TraceRecorder::getInstance().record(m_name, m_category, m_start, end - m_start, m_file ? *m_file : noFile, m_bytes);
+}
+
+TraceRecorder::ThreadBuffer::~ThreadBuffer() {
+    for (auto& segment : segments) {
+        delete segment.load(std::memory_order_relaxed);
+    }
+}
+
+TraceRecorder& TraceRecorder::getInstance() {
+    // Never destroyed: threads still running during static destruction (the logger's sink)
+    // hand their buffer back when they exit
+    static TraceRecorder* instance = new TraceRecorder();
+    return *instance;
+}
+
+void TraceRecorder::reset() {
+    std::lock_guard<std::mutex> lock(m_buffersMutex);
+    m_origin.store(now(), std::memory_order_relaxed);
+    for (auto& buffer : m_buffers) {
+        buffer->begin.store(buffer->count.load(std::memory_order_acquire), std::memory_order_relaxed);
+        buffer->dropped.store(0, std::memory_order_relaxed);
+    }
+}
+
+TraceRecorder::ThreadBuffer& TraceRecorder::local() {
+    if (t_buffer.buffer) {
+        return *static_cast<ThreadBuffer*>(t_buffer.buffer);
+    }
+
+    // First event on this thread: take over an emptied buffer of a thread that has exited, or add one
+    std::lock_guard<std::mutex> lock(m_buffersMutex);
+    ThreadBuffer* claimed = nullptr;
+    for (auto& buffer : m_buffers) {
+        if (buffer->begin.load(std::memory_order_relaxed) != buffer->count.load(std::memory_order_relaxed)) {
+            continue;  // Still holds events of the current trace
+        }
+        bool expected = false;
+        if (buffer->inUse.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            claimed = buffer.get();
+            break;
+        }
+    }
+    if (!claimed) {
+        m_buffers.push_back(std::make_unique<ThreadBuffer>());
+        claimed = m_buffers.back().get();
+        claimed->inUse.store(true, std::memory_order_relaxed);
+    }
+    // A new track: readers are locked out, so the old events can be overwritten from the start
+    claimed->threadId = m_nextThreadId++;
+    claimed->threadName = t_buffer.threadName;
+    claimed->begin.store(0, std::memory_order_relaxed);
+    claimed->count.store(0, std::memory_order_relaxed);
+    claimed->dropped.store(0, std::memory_order_relaxed);
+
+    t_buffer.inUse = &claimed->inUse;
+    t_buffer.buffer = claimed;
+    return *claimed;
+}
+
+void TraceRecorder::setThreadName(const std::string& name) {
+    t_buffer.threadName = name;
+    if (t_buffer.buffer) {
+        std::lock_guard<std::mutex> lock(m_buffersMutex);
+        static_cast<ThreadBuffer*>(t_buffer.buffer)->threadName = name;
+    }
+}
+
+void TraceRecorder::record(const char* name, const char* category, uint64_t startNanos, uint64_t durationNanos,
+                           const std::string& file, uint64_t bytes) {
+    if (!isEnabled()) {
+        return;
+    }
+    ThreadBuffer& buffer = local();
+
+    size_t index = buffer.count.load(std::memory_order_relaxed);
+    if (index > 0 && index == buffer.begin.load(std::memory_order_relaxed)) {
+        // A long-lived thread after reset(): start over at the first segment (once per trace)
+        std::lock_guard<std::mutex> lock(m_buffersMutex);
+        if (buffer.begin.load(std::memory_order_relaxed) == index) {
+            buffer.begin.store(0, std::memory_order_relaxed);
+            buffer.count.store(0, std::memory_order_relaxed);
+            index = 0;
+        }
+    }
+
+    size_t segmentIndex = index / SEGMENT_EVENTS;
+    if (segmentIndex >= MAX_SEGMENTS) {
+        buffer.dropped.store(buffer.dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return;
+    }
+    Segment* segment = buffer.segments[segmentIndex].load(std::memory_order_relaxed);
+    if (!segment) {
+        segment = new Segment();
+        buffer.segments[segmentIndex].store(segment, std::memory_order_release);
+    }
+
+    Event& event = segment->events[index % SEGMENT_EVENTS];
+    event.name = name;
+    event.category = category;
+    event.start = startNanos;
+    event.duration = durationNanos;
+    event.bytes = bytes;
+    event.file.assign(file);
+    buffer.count.store(index + 1, std::memory_order_release);
+}
+
+size_t TraceRecorder::getEventCount() const {
+    std::lock_guard<std::mutex> lock(m_buffersMutex);
+    size_t events = 0;
+    for (const auto& buffer : m_buffers) {
+        size_t begin = buffer->begin.load(std::memory_order_relaxed);
+        size_t count = buffer->count.load(std::memory_order_acquire);
+        events += count > begin ? count - begin : 0;
+    }
+    return events;
+}
+
+size_t TraceRecorder::getDroppedCount() const {
+    std::lock_guard<std::mutex> lock(m_buffersMutex);
+    size_t dropped = 0;
+    for (const auto& buffer : m_buffers) {
+        dropped += buffer->dropped.load(std::memory_order_relaxed);
+    }
+    return dropped;
+}
+
+bool TraceRecorder::write(const std::string& path) const {
+    std::ofstream trace(path);
+    if (!trace.is_open()) {
+        return false;
+    }
+
+    const long pid = static_cast<long>(::getpid());
+    std::lock_guard<std::mutex> lock(m_buffersMutex);
+    const uint64_t origin = m_origin.load(std::memory_order_relaxed);
+    size_t dropped = 0;
+    bool first = true;
+    auto separator = [&first]() {
+        const char* text = first ? "\n" : ",\n";
+        first = false;
+        return text;
+    };
+
+    trace << "{\"traceEvents\": [";
+    for (const auto& buffer : m_buffers) {
+        size_t begin = buffer->begin.load(std::memory_order_relaxed);
+        size_t count = buffer->count.load(std::memory_order_acquire);
+        dropped += buffer->dropped.load(std::memory_order_relaxed);
+        if (count <= begin) {
+            continue;
+        }
+
+        std::string threadName = buffer->threadName.empty() ? "thread " + std::to_string(buffer->threadId)
+                                                             : buffer->threadName;
+        trace << separator() << "{\"ph\": \"M\", \"name\": \"thread_name\", \"pid\": " << pid
+              << ", \"tid\": " << buffer->threadId << ", \"args\": {\"name\": " << Json::quote(threadName) << "}}";
+
+        for (size_t index = begin; index < count; index++) {
+            const Segment* segment = buffer->segments[index / SEGMENT_EVENTS].load(std::memory_order_acquire);
+            const Event& event = segment->events[index % SEGMENT_EVENTS];
+            trace << separator() << "{\"ph\": \"X\", \"name\": \"" << event.name << "\", \"cat\": \"" << event.category
+                  << "\", \"pid\": " << pid << ", \"tid\": " << buffer->threadId
+                  << ", \"ts\": " << micros(event.start > origin ? event.start - origin : 0)
+                  << ", \"dur\": " << micros(event.duration);
+            if (!event.file.empty() || event.bytes > 0) {
+                trace << ", \"args\": {";
+                if (!event.file.empty()) {
+                    trace << "\"file\": " << Json::quote(event.file) << (event.bytes > 0 ? ", " : "");
+                }
+                if (event.bytes > 0) {
+                    trace << "\"bytes\": " << event.bytes;
+                }
+                trace << "}";
+            }
+            trace << "}";
+        }
+    }
+    trace << "\n], \"displayTimeUnit\": \"ms\", \"otherData\": {\"droppedEvents\": " << dropped << "}}\n";
+
+    return trace.good();
+}
+
+uint64_t TraceRecorder::now() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Timeline of what every thread was doing, written as Chrome Trace Event JSON
+// (open it in ui.perfetto.dev or chrome://tracing). Each event is a span with a
+// name, a category, and optionally the file it worked on and its byte count.
+//
+// Every thread appends to its own segmented buffer; an event is published with
+// a single release store, so recording takes no lock and the trace can be
+// written while threads are still running. Buffers of exited threads are
+// reused after the next reset(). Off by default; a disabled Span does nothing.
+class TraceRecorder {
+public:
+    // Names and categories must be string literals (only the pointer is kept)
+    class Span {
+    public:
+        Span(const char* name, const char* category);
+        Span(const char* name, const char* category, const std::string& file, uint64_t bytes = 0);
+        ~Span();
+
+        Span(const Span&) = delete;
+        Span& operator=(const Span&) = delete;
+
+        void setBytes(uint64_t bytes) { m_bytes = bytes; }
+
+    private:
+        const char* m_name;
+        const char* m_category;
+        const std::string* m_file = nullptr;
+        uint64_t m_bytes = 0;
+        uint64_t m_start = 0;
+        bool m_active = false;
+    };
+
+    static constexpr size_t SEGMENT_EVENTS = 4096;
+    static constexpr size_t MAX_SEGMENTS = 256;  // Events per thread beyond this are dropped (and counted)
+
+    static TraceRecorder& getInstance();
+
+    void setEnabled(bool enabled) { m_enabled.store(enabled, std::memory_order_relaxed); }
+    bool isEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+    // Starts a new trace: earlier events are no longer written, timestamps count from here
+    void reset();
+
+    // Track name for the calling thread, e.g. "read 2"; cheap, and kept until the thread records
+    void setThreadName(const std::string& name);
+
+    // One span that started at startNanos (TraceRecorder::now) and took durationNanos
+    void record(const char* name, const char* category, uint64_t startNanos, uint64_t durationNanos,
+                const std::string& file = std::string(), uint64_t bytes = 0);
+
+    size_t getEventCount() const;
+    size_t getDroppedCount() const;
+
+    // Everything recorded since reset(); false if the file could not be written
+    bool write(const std::string& path) const;
+
+    // Monotonic nanoseconds (the same clock as StageProfiler::now)
+    static uint64_t now();
+
+private:
+    TraceRecorder() = default;
+    TraceRecorder(const TraceRecorder&) = delete;
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+    struct Event {
+        const char* name = nullptr;
+        const char* category = nullptr;
+        uint64_t start = 0;
+        uint64_t duration = 0;
+        uint64_t bytes = 0;
+        std::string file;
+    };
+
+    struct Segment {
+        Event events[SEGMENT_EVENTS];
+    };
+
+    // Events are appended by the owning thread only; [begin, count) belong to the current trace.
+    // begin changes only under m_buffersMutex
+    struct ThreadBuffer {
+        std::atomic<bool> inUse{false};
+        uint32_t threadId = 0;
+        std::string threadName;  // Guarded by m_buffersMutex
+        std::atomic<Segment*> segments[MAX_SEGMENTS] = {};
+        std::atomic<size_t> begin{0};
+        std::atomic<size_t> count{0};
+        std::atomic<size_t> dropped{0};
+
+        ThreadBuffer() = default;
+        ~ThreadBuffer();
+    };
+
+    ThreadBuffer& local();
+
+    std::atomic<bool> m_enabled{false};
+    std::atomic<uint64_t> m_origin{0};
+    mutable std::mutex m_buffersMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> m_buffers;
+    uint32_t m_nextThreadId = 1;
+};
@@ -0,0 +1,102 @@
+#include "WorkStealingDeque.h"
+
+WorkStealingDeque::Buffer::Buffer(int64_t capacity)
+    : capacity(capacity), mask(capacity - 1), slots(new std::atomic<PoolTask*>[capacity]) {
+}
+
+WorkStealingDeque::WorkStealingDeque(int64_t initialCapacity) {
+    // Capacity must be a power of two so indices can be masked
+    int64_t capacity = 1;
+    while (capacity < initialCapacity) {
+        capacity <<= 1;
+    }
+
+    m_buffers.push_back(std::make_unique<Buffer>(capacity));
+    m_buffer.store(m_buffers.back().get(), std::memory_order_relaxed);
+}
+
+WorkStealingDeque::~WorkStealingDeque() {
+    // Release any tasks that were never run
+    while (PoolTask* task = steal()) {
+        delete task;
+    }
+}
+
+void WorkStealingDeque::push(PoolTask* task) {
+    int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+    int64_t top = m_top.load(std::memory_order_acquire);
+    Buffer* buffer = m_buffer.load(std::memory_order_relaxed);
+
+    if (bottom - top > buffer->capacity - 1) {
+        buffer = grow(buffer, top, bottom);
+    }
+
+    buffer->put(bottom, task);
+    std::atomic_thread_fence(std::memory_order_release);
+    m_bottom.store(bottom + 1, std::memory_order_relaxed);
+}
+
+PoolTask* WorkStealingDeque::pop() {
+    int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+    Buffer* buffer = m_buffer.load(std::memory_order_relaxed);
+    m_bottom.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t top = m_top.load(std::memory_order_relaxed);
+
+    if (top > bottom) {
+        // Deque was already empty
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    PoolTask* task = buffer->get(bottom);
+    if (top == bottom) {
+        // Last element: race against thieves for it
+        if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            task = nullptr;
+        }
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+
+    return task;
+}
+
+PoolTask* WorkStealingDeque::steal() {
+    int64_t top = m_top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t bottom = m_bottom.load(std::memory_order_acquire);
+
+    if (top >= bottom) {
+        return nullptr;
+    }
+
+    Buffer* buffer = m_buffer.load(std::memory_order_acquire);
+    PoolTask* task = buffer->get(top);
+    if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        return nullptr;
+    }
+
+    return task;
+}
+
+bool WorkStealingDeque::empty() const {
+    return size() == 0;
+}
+
+size_t WorkStealingDeque::size() const {
+    int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+    int64_t top = m_top.load(std::memory_order_relaxed);
+    return bottom > top ? static_cast<size_t>(bottom - top) : 0;
+}
+
+WorkStealingDeque::Buffer* WorkStealingDeque::grow(Buffer* buffer, int64_t top, int64_t bottom) {
+    auto grown = std::make_unique<Buffer>(buffer->capacity * 2);
+    for (int64_t i = top; i < bottom; ++i) {
+        grown->put(i, buffer->get(i));
+    }
+
+    Buffer* result = grown.get();
+    m_buffers.push_back(std::move(grown));
+    m_buffer.store(result, std::memory_order_release);
+    return result;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+// Unit of work scheduled by ThreadPool
+struct PoolTask {
+    std::function<void()> function;
+    PoolTask* next = nullptr;  // Link used while the task sits in a submission inbox
+};
+
+// Chase-Lev work-stealing deque.
+// The owning worker pushes and pops at the bottom; any other thread may steal
+// from the top. Neither side takes a lock. Grown buffers are retired rather than
+// freed so that a concurrent thief never reads released memory.
+class WorkStealingDeque {
+public:
+    explicit WorkStealingDeque(int64_t initialCapacity = 256);
+    ~WorkStealingDeque();
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    // Owner thread only
+    void push(PoolTask* task);
+    PoolTask* pop();
+
+    // Any thread; returns nullptr when empty or when losing a race with another thief
+    PoolTask* steal();
+
+    bool empty() const;
+    size_t size() const;
+
+private:
+    struct Buffer {
+        explicit Buffer(int64_t capacity);
+
+        int64_t capacity;
+        int64_t mask;
+        std::unique_ptr<std::atomic<PoolTask*>[]> slots;
+
+        PoolTask* get(int64_t index) const { return slots[index & mask].load(std::memory_order_relaxed); }
+        void put(int64_t index, PoolTask* task) { slots[index & mask].store(task, std::memory_order_relaxed); }
+    };
+
+    std::atomic<int64_t> m_top{0};
+    std::atomic<int64_t> m_bottom{0};
+    std::atomic<Buffer*> m_buffer;
+    std::vector<std::unique_ptr<Buffer>> m_buffers;  // Owner-only; keeps retired buffers alive
+
+    Buffer* grow(Buffer* buffer, int64_t top, int64_t bottom);
+};
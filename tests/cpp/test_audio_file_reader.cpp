@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+#include "AudioFileReader.h"
+#include <sndfile.h>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+class AudioFileReaderTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        testDir = std::filesystem::temp_directory_path() / "m8_reader_test";
+        std::filesystem::remove_all(testDir);
+        std::filesystem::create_directories(testDir);
+    }
+
+    void TearDown() override {
+        if (std::filesystem::exists(testDir)) {
+            std::filesystem::remove_all(testDir);
+        }
+    }
+
+    // Full-scale sweep across both channels, so every byte of each sample matters
+    std::string createAudioFile(const std::string& name, int format, int channels, sf_count_t frames) {
+        std::string path = (testDir / name).string();
+        SF_INFO info;
+        info.samplerate = 44100;
+        info.channels = channels;
+        info.format = format;
+        SNDFILE* file = sf_open(path.c_str(), SFM_WRITE, &info);
+        std::vector<float> samples(frames * channels);
+        for (size_t i = 0; i < samples.size(); i++) {
+            samples[i] = 0.999f * std::sin(0.0137f * static_cast<float>(i) * static_cast<float>(i % 7 + 1));
+        }
+        sf_writef_float(file, samples.data(), frames);
+        sf_close(file);
+        return path;
+    }
+
+    template <typename T, typename ReadReader, typename ReadSndfile>
+    void expectSameSamples(const std::string& path, ReadReader readReader, ReadSndfile readSndfile) {
+        SF_INFO expectedInfo;
+        SNDFILE* file = sf_open(path.c_str(), SFM_READ, &expectedInfo);
+        ASSERT_NE(file, nullptr);
+
+        AudioFileReader reader;
+        ASSERT_TRUE(reader.open(path));
+        EXPECT_EQ(reader.getInfo().format, expectedInfo.format);
+        EXPECT_EQ(reader.getInfo().channels, expectedInfo.channels);
+        EXPECT_EQ(reader.getInfo().samplerate, expectedInfo.samplerate);
+        EXPECT_EQ(reader.getInfo().frames, expectedInfo.frames);
+
+        // Odd block size so reads straddle the end of the data
+        const sf_count_t block = 777;
+        std::vector<T> expected(block * expectedInfo.channels);
+        std::vector<T> actual(block * expectedInfo.channels);
+        sf_count_t total = 0;
+        while (true) {
+            sf_count_t want = readSndfile(file, expected.data(), block);
+            sf_count_t got = readReader(reader, actual.data(), block);
+            ASSERT_EQ(got, want);
+            for (sf_count_t i = 0; i < got * expectedInfo.channels; i++) {
+                ASSERT_EQ(actual[i], expected[i]) << "sample " << total * expectedInfo.channels + i;
+            }
+            total += got;
+            if (got == 0) {
+                break;
+            }
+        }
+        EXPECT_EQ(total, expectedInfo.frames);
+        sf_close(file);
+    }
+
+    void expectSameFloats(const std::string& path) {
+        expectSameSamples<float>(path,
+            [](AudioFileReader& reader, float* out, sf_count_t frames) { return reader.readFloat(out, frames); },
+            [](SNDFILE* file, float* out, sf_count_t frames) { return sf_readf_float(file, out, frames); });
+    }
+
+    std::filesystem::path testDir;
+};
+
+TEST_F(AudioFileReaderTest, DirectDecodeMatchesLibsndfile) {
+    struct Case { const char* name; int format; int channels; };
+    const Case cases[] = {
+        {"pcm16.wav", SF_FORMAT_WAV | SF_FORMAT_PCM_16, 2},
+        {"pcm24.wav", SF_FORMAT_WAV | SF_FORMAT_PCM_24, 2},
+        {"pcm32.wav", SF_FORMAT_WAV | SF_FORMAT_PCM_32, 1},
+        {"float.wav", SF_FORMAT_WAV | SF_FORMAT_FLOAT, 2},
+        {"pcm16.aiff", SF_FORMAT_AIFF | SF_FORMAT_PCM_16, 2},
+        {"pcm24.aiff", SF_FORMAT_AIFF | SF_FORMAT_PCM_24, 1},
+    };
+
+    for (const Case& c : cases) {
+        SCOPED_TRACE(c.name);
+        std::string path = createAudioFile(c.name, c.format, c.channels, 5000);
+        {
+            AudioFileReader reader;
+            ASSERT_TRUE(reader.open(path));
+            EXPECT_TRUE(reader.isMapped());
+            EXPECT_TRUE(reader.isDirect());
+        }
+        expectSameFloats(path);
+    }
+}
+
+TEST_F(AudioFileReaderTest, SixteenBitSamplesAreReadVerbatim) {
+    for (int format : {SF_FORMAT_WAV | SF_FORMAT_PCM_16, SF_FORMAT_AIFF | SF_FORMAT_PCM_16}) {
+        std::string path = createAudioFile(format == (SF_FORMAT_WAV | SF_FORMAT_PCM_16) ? "s.wav" : "s.aiff", format, 2, 3000);
+        expectSameSamples<short>(path,
+            [](AudioFileReader& reader, short* out, sf_count_t frames) { return reader.readShort(out, frames); },
+            [](SNDFILE* file, short* out, sf_count_t frames) { return sf_readf_short(file, out, frames); });
+    }
+}
+
+TEST_F(AudioFileReaderTest, OtherFormatsGoThroughVirtualIo) {
+    // 8-bit is left to libsndfile, reading from the mapping
+    std::string path = createAudioFile("u8.wav", SF_FORMAT_WAV | SF_FORMAT_PCM_U8, 1, 2000);
+    {
+        AudioFileReader reader;
+        ASSERT_TRUE(reader.open(path));
+        EXPECT_TRUE(reader.isMapped());
+        EXPECT_FALSE(reader.isDirect());
+    }
+    expectSameFloats(path);
+}
+
+TEST_F(AudioFileReaderTest, BufferedModeAndFailures) {
+    std::string path = createAudioFile("buffered.wav", SF_FORMAT_WAV | SF_FORMAT_PCM_24, 2, 100);
+    AudioFileReader reader;
+    ASSERT_TRUE(reader.open(path, false));
+    EXPECT_FALSE(reader.isMapped());
+    std::vector<float> samples(200 * 2);
+    EXPECT_EQ(reader.readFloat(samples.data(), 200), 100);
+
+    EXPECT_FALSE(reader.open((testDir / "missing.wav").string()));
+    std::ofstream(testDir / "empty.wav").close();
+    EXPECT_FALSE(reader.open((testDir / "empty.wav").string()));
+    std::ofstream(testDir / "text.wav") << "not audio";
+    EXPECT_FALSE(reader.open((testDir / "text.wav").string()));
+    EXPECT_EQ(reader.readFloat(samples.data(), 10), 0);
+}
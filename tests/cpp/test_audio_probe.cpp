@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+#include "AudioProbe.h"
+#include "FileScanner.h"
+#include <sndfile.h>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+class AudioProbeTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        testDir = std::filesystem::temp_directory_path() / "m8_probe_test";
+        std::filesystem::remove_all(testDir);
+        std::filesystem::create_directories(testDir);
+    }
+
+    void TearDown() override {
+        if (std::filesystem::exists(testDir)) {
+            std::filesystem::remove_all(testDir);
+        }
+    }
+
+    std::string createAudioFile(const std::string& name, int format, int rate, int channels, sf_count_t frames) {
+        std::string path = (testDir / name).string();
+        SF_INFO info;
+        info.samplerate = rate;
+        info.channels = channels;
+        info.format = format;
+        SNDFILE* file = sf_open(path.c_str(), SFM_WRITE, &info);
+        std::vector<float> samples(frames * channels, 0.25f);
+        sf_writef_float(file, samples.data(), frames);
+        sf_close(file);
+        return path;
+    }
+
+    std::string writeBytes(const std::string& name, const std::vector<unsigned char>& bytes) {
+        std::string path = (testDir / name).string();
+        std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+        return path;
+    }
+
+    static void put(std::vector<unsigned char>& out, const char* tag) { out.insert(out.end(), tag, tag + 4); }
+    static void putLe(std::vector<unsigned char>& out, uint32_t value, int bytes) {
+        for (int i = 0; i < bytes; i++) out.push_back(static_cast<unsigned char>(value >> (8 * i)));
+    }
+
+    std::filesystem::path testDir;
+};
+
+TEST_F(AudioProbeTest, MatchesLibsndfile) {
+    struct Case { const char* name; int format; int rate; int channels; };
+    const Case cases[] = {
+        {"pcm16.wav", SF_FORMAT_WAV | SF_FORMAT_PCM_16, 44100, 2},
+        {"pcm24.wav", SF_FORMAT_WAV | SF_FORMAT_PCM_24, 96000, 1},
+        {"float.wav", SF_FORMAT_WAV | SF_FORMAT_FLOAT, 48000, 2},
+        {"pcm16.aiff", SF_FORMAT_AIFF | SF_FORMAT_PCM_16, 22050, 1},
+        {"pcm24.aif", SF_FORMAT_AIFF | SF_FORMAT_PCM_24, 88200, 2},
+    };
+
+    for (const Case& c : cases) {
+        SCOPED_TRACE(c.name);
+        std::string path = createAudioFile(c.name, c.format, c.rate, c.channels, 1234);
+
+        SF_INFO expected;
+        SNDFILE* file = sf_open(path.c_str(), SFM_READ, &expected);
+        ASSERT_NE(file, nullptr);
+        sf_close(file);
+
+        AudioProbe::Result result = AudioProbe::probe(path);
+        ASSERT_EQ(result.status, AudioProbe::VALID) << result.error;
+        EXPECT_EQ(result.format, expected.format);
+        EXPECT_EQ(result.info.sampleRate, expected.samplerate);
+        EXPECT_EQ(result.info.channels, expected.channels);
+        EXPECT_EQ(static_cast<sf_count_t>(result.info.frameCount), expected.frames);
+    }
+}
+
+TEST_F(AudioProbeTest, FindsFormatChunkBehindLargeMetadata) {
+    // 16-bit stereo WAV with 10 KB of metadata before "fmt ", beyond the first read
+    std::vector<unsigned char> bytes;
+    put(bytes, "RIFF");
+    putLe(bytes, 0, 4);
+    put(bytes, "WAVE");
+    put(bytes, "JUNK");
+    putLe(bytes, 10001, 4);
+    bytes.resize(bytes.size() + 10002, 0);  // Odd size plus pad byte
+    put(bytes, "fmt ");
+    putLe(bytes, 16, 4);
+    putLe(bytes, 1, 2);
+    putLe(bytes, 2, 2);
+    putLe(bytes, 48000, 4);
+    putLe(bytes, 48000 * 4, 4);
+    putLe(bytes, 4, 2);
+    putLe(bytes, 16, 2);
+    put(bytes, "data");
+    putLe(bytes, 400, 4);
+    bytes.resize(bytes.size() + 400, 0);
+
+    AudioProbe::Result result = AudioProbe::probe(writeBytes("tagged.wav", bytes));
+    ASSERT_EQ(result.status, AudioProbe::VALID) << result.error;
+    EXPECT_EQ(result.format, SF_FORMAT_WAV | SF_FORMAT_PCM_16);
+    EXPECT_EQ(result.info.sampleRate, 48000);
+    EXPECT_EQ(result.info.frameCount, 100u);
+
+    // Without a descriptor for the second read the same header cannot be resolved
+    EXPECT_EQ(AudioProbe::probeBuffer(bytes.data(), AudioProbe::HEADER_BYTES, bytes.size()).status, AudioProbe::INVALID);
+}
+
+TEST_F(AudioProbeTest, ParsesFlacStreamInfo) {
+    std::vector<unsigned char> bytes = {'f', 'L', 'a', 'C', 0x80, 0x00, 0x00, 0x22};
+    unsigned char streamInfo[34] = {};
+    // 44100 Hz (0x0AC44), 2 channels, 24 bits, 1000000 samples
+    streamInfo[10] = 0x0A;
+    streamInfo[11] = 0xC4;
+    streamInfo[12] = 0x40 | (1 << 1) | ((23 >> 4) & 1);
+    streamInfo[13] = static_cast<unsigned char>((23 & 0x0F) << 4);
+    streamInfo[14] = 0x00;
+    streamInfo[15] = 0x0F;
+    streamInfo[16] = 0x42;
+    streamInfo[17] = 0x40;
+    bytes.insert(bytes.end(), streamInfo, streamInfo + sizeof(streamInfo));
+
+    AudioProbe::Result result = AudioProbe::probeBuffer(bytes.data(), bytes.size(), bytes.size());
+    ASSERT_EQ(result.status, AudioProbe::VALID) << result.error;
+    EXPECT_EQ(result.format, SF_FORMAT_FLAC | SF_FORMAT_PCM_24);
+    EXPECT_EQ(result.info.sampleRate, 44100);
+    EXPECT_EQ(result.info.channels, 2);
+    EXPECT_EQ(result.info.frameCount, 1000000u);
+}
+
+TEST_F(AudioProbeTest, ClassifiesCorruptAndForeignFiles) {
+    auto probeBytes = [](const std::string& text) {
+        return AudioProbe::probeBuffer(reinterpret_cast<const unsigned char*>(text.data()), text.size(), text.size()).status;
+    };
+    EXPECT_EQ(probeBytes("This is not audio at all"), AudioProbe::INVALID);
+    EXPECT_EQ(probeBytes("RIFF"), AudioProbe::INVALID);
+    EXPECT_EQ(probeBytes(std::string("RIFF\0\0\0\0AVI LIST", 16)), AudioProbe::INVALID);
+    EXPECT_EQ(probeBytes(std::string("RIFF\x04\0\0\0WAVE", 12)), AudioProbe::INVALID);  // No chunks
+    EXPECT_EQ(probeBytes(std::string("OggS\0\x02\0\0\0\0\0\0", 12)), AudioProbe::UNKNOWN);
+    EXPECT_EQ(probeBytes(std::string("\xFF\xFB\x90\x64\0\0\0\0\0\0\0\0", 12)), AudioProbe::UNKNOWN);
+    EXPECT_EQ(AudioProbe::probe((testDir / "missing.wav").string()).status, AudioProbe::INVALID);
+}
+
+TEST_F(AudioProbeTest, ScannerRejectsCorruptFiles) {
+    createAudioFile("good.wav", SF_FORMAT_WAV | SF_FORMAT_PCM_24, 48000, 2, 100);
+    std::ofstream(testDir / "bad.wav") << "not audio";
+
+    FileScanner scanner;
+    scanner.setProbeHeaders(true);
+    auto files = scanner.scanDirectory(testDir.string());
+    ASSERT_EQ(files.size(), 1u);
+    EXPECT_EQ(files[0].filename, "good.wav");
+    EXPECT_EQ(files[0].probe.status, AudioProbe::VALID);
+    EXPECT_EQ(files[0].probe.info.bitDepth, 24);
+    EXPECT_EQ(scanner.getRejectedFiles(), 1u);
+    EXPECT_FALSE(scanner.isValidAudioFile((testDir / "bad.wav").string()));
+
+    // Without probing both are handed on
+    scanner.setProbeHeaders(false);
+    EXPECT_EQ(scanner.scanDirectory(testDir.string()).size(), 2u);
+    EXPECT_EQ(scanner.getRejectedFiles(), 0u);
+}
@@ -4,6 +4,7 @@
 #include <vector>
 #include <fstream>
 #include <cmath>
+#include <sndfile.h>
 
 // Helper functions for creating test files
 void createTestWavFile(const std::string& filename) {
@@ -171,6 +172,102 @@ TEST_F(AudioProcessorTest, ConvertBitDepth) {
     
     EXPECT_TRUE(result);
     EXPECT_EQ(outputData.size(), inputData.size());
+    for (float sample : outputData) {
+        float steps = sample * 32767.0f;
+        EXPECT_FLOAT_EQ(steps, std::round(steps));  // On the 16-bit grid
+        EXPECT_NEAR(sample, 0.5f, 1.5f / 32767.0f);
+    }
+}
+
+// Quantization error of a 997 Hz sine (about -30 dBFS) in LSB units
+static std::vector<double> requantizationError(AudioProcessor& processor, AudioProcessor::DitherMode mode) {
+    const size_t frames = 1 << 16;
+    std::vector<float> sine(frames);
+    for (size_t i = 0; i < frames; i++) {
+        sine[i] = 0.03f * static_cast<float>(std::sin(2.0 * M_PI * 997.0 * i / 44100.0));
+    }
+
+    // Two blocks, as the pipeline would hand them over
+    std::vector<short> pcm(frames);
+    AudioProcessor::DitherState state(42);
+    processor.requantizeTo16Bit(sine.data(), pcm.data(), frames / 2, 1, mode, state);
+    processor.requantizeTo16Bit(sine.data() + frames / 2, pcm.data() + frames / 2, frames / 2, 1, mode, state);
+
+    std::vector<double> error(frames);
+    for (size_t i = 0; i < frames; i++) {
+        error[i] = pcm[i] - static_cast<double>(sine[i]) * 32767.0;
+    }
+    return error;
+}
+
+static double meanSquare(const std::vector<double>& values) {
+    double sum = 0.0;
+    for (double value : values) {
+        sum += value * value;
+    }
+    return sum / values.size();
+}
+
+TEST_F(AudioProcessorTest, TpdfDitherNoiseFloor) {
+    auto plain = requantizationError(*processor, AudioProcessor::DitherMode::NONE);
+    auto tpdf = requantizationError(*processor, AudioProcessor::DitherMode::TPDF);
+
+    // Rounding alone gives 1/12 LSB^2; TPDF adds 1/6 for a total of 1/4
+    EXPECT_NEAR(meanSquare(plain), 1.0 / 12.0, 0.01);
+    EXPECT_NEAR(meanSquare(tpdf), 0.25, 0.015);
+
+    // Dithered error has no DC offset and does not correlate with the signal
+    double mean = 0.0, correlation = 0.0, signalPower = 0.0;
+    for (size_t i = 0; i < tpdf.size(); i++) {
+        double signal = std::sin(2.0 * M_PI * 997.0 * i / 44100.0);
+        mean += tpdf[i];
+        correlation += tpdf[i] * signal;
+        signalPower += signal * signal;
+    }
+    EXPECT_NEAR(mean / tpdf.size(), 0.0, 0.01);
+    EXPECT_NEAR(correlation / std::sqrt(signalPower * meanSquare(tpdf) * tpdf.size()), 0.0, 0.02);
+}
+
+TEST_F(AudioProcessorTest, NoiseShapingMovesNoiseUpward) {
+    auto tpdf = requantizationError(*processor, AudioProcessor::DitherMode::TPDF);
+    auto shaped = requantizationError(*processor, AudioProcessor::DitherMode::SHAPED);
+
+    // Moving average over 8 samples keeps roughly the band below 5 kHz
+    auto lowBand = [](const std::vector<double>& error) {
+        std::vector<double> filtered(error.size() - 8);
+        for (size_t i = 0; i < filtered.size(); i++) {
+            double sum = 0.0;
+            for (size_t k = 0; k < 8; k++) {
+                sum += error[i + k];
+            }
+            filtered[i] = sum / 8.0;
+        }
+        return meanSquare(filtered);
+    };
+
+    EXPECT_GT(meanSquare(shaped), meanSquare(tpdf));  // More noise overall...
+    EXPECT_LT(lowBand(shaped), lowBand(tpdf) * 0.5);  // ...but well below it where hearing is sensitive
+
+    // Interleaved stereo through convertBitDepth: each channel is shaped on its own, so neither
+    // gets the other's error fed back and folded down into its low band
+    const size_t frames = tpdf.size();
+    std::vector<float> stereo(frames * 2);
+    for (size_t i = 0; i < frames; i++) {
+        stereo[i * 2] = 0.03f * static_cast<float>(std::sin(2.0 * M_PI * 997.0 * i / 44100.0));
+        stereo[i * 2 + 1] = 0.02f * static_cast<float>(std::sin(2.0 * M_PI * 440.0 * i / 44100.0));
+    }
+    std::vector<float> requantized;
+    ASSERT_TRUE(processor->convertBitDepth(stereo, requantized, 16, AudioProcessor::DitherMode::SHAPED, 2));
+    ASSERT_EQ(requantized.size(), stereo.size());
+    for (size_t ch = 0; ch < 2; ch++) {
+        std::vector<double> error(frames);
+        for (size_t i = 0; i < frames; i++) {
+            error[i] = (static_cast<double>(requantized[i * 2 + ch]) - stereo[i * 2 + ch]) * 32767.0;
+        }
+        EXPECT_LT(lowBand(error), lowBand(tpdf) * 0.5) << "channel " << ch;
+    }
+    EXPECT_FALSE(processor->convertBitDepth(std::vector<float>(3, 0.0f), requantized, 16,
+                                            AudioProcessor::DitherMode::SHAPED, 2));
 }
 
 TEST_F(AudioProcessorTest, ConvertToMono) {
@@ -0,0 +1,35 @@
+#include <gtest/gtest.h>
+#include "ContentHash.h"
+#include <set>
+#include <vector>
+
+TEST(ContentHashTest, DependsOnEveryByteAndLength) {
+    std::vector<unsigned char> data(1000);
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = static_cast<unsigned char>(i * 7);
+    }
+    const uint64_t base = ContentHash::hash(data.data(), data.size());
+    EXPECT_EQ(ContentHash::hash(data.data(), data.size()), base);
+
+    // One flipped bit anywhere (stripes, 8-byte words and the tail) changes the hash
+    std::set<uint64_t> hashes = {base};
+    for (size_t i : {size_t(0), size_t(31), size_t(500), size_t(991), size_t(999)}) {
+        data[i] ^= 1;
+        hashes.insert(ContentHash::hash(data.data(), data.size()));
+        data[i] ^= 1;
+    }
+    EXPECT_EQ(hashes.size(), 6u);
+
+    // Zero padding is not the same content
+    std::vector<unsigned char> zeros(64, 0);
+    EXPECT_NE(ContentHash::hash(zeros.data(), 32), ContentHash::hash(zeros.data(), 64));
+    EXPECT_NE(ContentHash::hash(zeros.data(), 0), 0u);
+    EXPECT_NE(ContentHash::hash(data.data(), data.size(), 1), base);
+}
+
+TEST(ContentHashTest, CombineIsOrderSensitive) {
+    uint64_t hash = ContentHash::hash("pcm", 3);
+    EXPECT_NE(ContentHash::combine(ContentHash::combine(hash, 2), 44100),
+              ContentHash::combine(ContentHash::combine(hash, 44100), 2));
+    EXPECT_NE(ContentHash::combine(hash, 1), hash);
+}
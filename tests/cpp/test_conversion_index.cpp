@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+#include "ConversionIndex.h"
+#include "M8SampleFormatter.h"
+#include <sndfile.h>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+class ConversionIndexTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        testDir = std::filesystem::temp_directory_path() / "m8_index_test";
+        std::filesystem::remove_all(testDir);
+        std::filesystem::create_directories(testDir / "source" / "Pack");
+    }
+
+    void TearDown() override {
+        if (std::filesystem::exists(testDir)) {
+            std::filesystem::remove_all(testDir);
+        }
+    }
+
+    std::string createWavFile(const std::string& name, float value) {
+        std::string path = (testDir / "source" / "Pack" / name).string();
+        SF_INFO info;
+        info.samplerate = 44100;
+        info.channels = 1;
+        info.format = SF_FORMAT_WAV | SF_FORMAT_PCM_24;
+
+        SNDFILE* file = sf_open(path.c_str(), SFM_WRITE, &info);
+        std::vector<float> samples(1000, value);
+        sf_writef_float(file, samples.data(), samples.size());
+        sf_close(file);
+        return path;
+    }
+
+    void touch(const std::string& path) {
+        auto time = std::filesystem::last_write_time(path);
+        std::filesystem::last_write_time(path, time + std::chrono::seconds(5));
+    }
+
+    M8SampleFormatter::ProcessingStats run(M8SampleFormatter::ProcessingOptions options = {}) {
+        M8SampleFormatter formatter;
+        formatter.processDirectory((testDir / "source").string(), (testDir / "output").string(), options);
+        return formatter.getStats();
+    }
+
+    std::filesystem::path testDir;
+};
+
+TEST_F(ConversionIndexTest, SaveAndLoadRoundTrip) {
+    ConversionIndex index;
+    ConversionIndex::Entry entry;
+    entry.sourcePath = "/samples/odd\tname\nwith\\escapes.wav";
+    entry.size = 1234;
+    entry.modifiedTime = -42;
+    entry.contentHash = 0xDEADBEEFCAFEF00DULL;
+    entry.optionsKey = "bitdepth=16;flatten=0";
+    entry.outputPath = "/out/odd name.wav";
+    entry.audioHash = 0x0123456789ABCDEFULL;
+    index.update(entry);
+
+    std::string indexPath = (testDir / "index").string();
+    ASSERT_TRUE(index.save(indexPath));
+
+    ConversionIndex loaded;
+    ASSERT_TRUE(loaded.load(indexPath));
+    EXPECT_EQ(loaded.size(), 1u);
+    EXPECT_EQ(loaded.entries()[0].audioHash, entry.audioHash);
+    EXPECT_TRUE(loaded.isUpToDate(entry.sourcePath, 1234, -42, entry.optionsKey, entry.outputPath));
+    EXPECT_FALSE(loaded.isUpToDate(entry.sourcePath, 1235, -42, entry.optionsKey, entry.outputPath));
+    EXPECT_FALSE(loaded.isUpToDate(entry.sourcePath, 1234, -41, entry.optionsKey, entry.outputPath));
+    EXPECT_FALSE(loaded.isUpToDate(entry.sourcePath, 1234, -42, "bitdepth=16;flatten=1", entry.outputPath));
+    EXPECT_FALSE(loaded.isUpToDate(entry.sourcePath, 1234, -42, entry.optionsKey, "/out/other.wav"));
+}
+
+TEST_F(ConversionIndexTest, LoadRejectsUnknownFormat) {
+    std::string indexPath = (testDir / "index").string();
+    std::ofstream(indexPath) << "something else\n";
+
+    ConversionIndex index;
+    EXPECT_FALSE(index.load(indexPath));
+    EXPECT_FALSE(index.load((testDir / "missing").string()));
+    EXPECT_EQ(index.size(), 0u);
+}
+
+TEST_F(ConversionIndexTest, HashDetectsTouchedButIdenticalFiles) {
+    std::string path = createWavFile("kick.wav", 0.25f);
+    uint64_t size = std::filesystem::file_size(path);
+
+    ConversionIndex index;
+    ConversionIndex::Entry entry;
+    entry.sourcePath = path;
+    entry.size = size;
+    entry.modifiedTime = 1;
+    entry.contentHash = ConversionIndex::hashFile(path);
+    entry.outputPath = "out.wav";
+    index.update(entry);
+
+    EXPECT_NE(entry.contentHash, 0u);
+    EXPECT_FALSE(index.isUpToDate(path, size, 2, "", "out.wav", false));
+    EXPECT_TRUE(index.isUpToDate(path, size, 2, "", "out.wav", true));
+    // The refreshed mtime makes the next lookup a plain metadata match
+    EXPECT_TRUE(index.isUpToDate(path, size, 2, "", "out.wav", false));
+
+    createWavFile("kick.wav", 0.5f);
+    EXPECT_FALSE(index.isUpToDate(path, size, 3, "", "out.wav", true));
+}
+
+TEST_F(ConversionIndexTest, RerunSkipsUnchangedFiles) {
+    createWavFile("kick.wav", 0.25f);
+    std::string snare = createWavFile("snare.wav", 0.5f);
+
+    auto first = run();
+    EXPECT_EQ(first.processedFiles, 2u);
+    EXPECT_EQ(first.skippedFiles, 0u);
+    EXPECT_TRUE(std::filesystem::exists(testDir / "output" / ConversionIndex::DEFAULT_FILENAME));
+
+    auto second = run();
+    EXPECT_EQ(second.processedFiles, 0u);
+    EXPECT_EQ(second.skippedFiles, 2u);
+
+    // A modified source is converted again, the other one stays skipped
+    createWavFile("snare.wav", -0.5f);
+    touch(snare);
+    auto third = run();
+    EXPECT_EQ(third.processedFiles, 1u);
+    EXPECT_EQ(third.skippedFiles, 1u);
+
+    // Changing options invalidates every entry
+    M8SampleFormatter::ProcessingOptions flattened;
+    flattened.flattenFolders = true;
+    EXPECT_EQ(run(flattened).processedFiles, 2u);
+
+    M8SampleFormatter::ProcessingOptions full;
+    full.incremental = false;
+    EXPECT_EQ(run(full).processedFiles, 2u);
+}
+
+TEST_F(ConversionIndexTest, PruneRemovesOutputsOfDeletedSources) {
+    createWavFile("kick.wav", 0.25f);
+    std::string snare = createWavFile("snare.wav", 0.5f);
+    run();
+
+    size_t outputsBefore = 0;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(testDir / "output")) {
+        if (entry.path().extension() == ".wav") outputsBefore++;
+    }
+    ASSERT_EQ(outputsBefore, 2u);
+
+    std::filesystem::remove(snare);
+    M8SampleFormatter::ProcessingOptions options;
+    options.pruneDeleted = true;
+    auto stats = run(options);
+    EXPECT_EQ(stats.skippedFiles, 1u);
+    EXPECT_EQ(stats.prunedFiles, 1u);
+
+    size_t outputsAfter = 0;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(testDir / "output")) {
+        if (entry.path().extension() == ".wav") outputsAfter++;
+    }
+    EXPECT_EQ(outputsAfter, 1u);
+}
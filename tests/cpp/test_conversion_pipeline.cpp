@@ -0,0 +1,615 @@
+#include <gtest/gtest.h>
+#include "ConversionPipeline.h"
+#include "FileOperations.h"
+#include <sndfile.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+#ifdef __APPLE__
+#include <mach/mach.h>
+#endif
+
+namespace {
+// Resident set size of this process right now, in bytes. Not ru_maxrss: that high-water mark may
+// already have been raised past anything the code under test does by an earlier test
+size_t residentBytes() {
+#ifdef __APPLE__
+    mach_task_basic_info_data_t info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) != KERN_SUCCESS) {
+        return 0;
+    }
+    return static_cast<size_t>(info.resident_size);
+#else
+    size_t pages = 0;
+    size_t resident = 0;
+    std::ifstream statm("/proc/self/statm");
+    statm >> pages >> resident;
+    return resident * static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+#endif
+}
+
+// Writes a 24-bit stereo WAV of roughly targetBytes, block by block so that generating the
+// fixture does not itself hold the file in memory
+sf_count_t createLargeWavFile(const std::string& filename, size_t targetBytes) {
+    SF_INFO info;
+    info.samplerate = 48000;
+    info.channels = 2;
+    info.format = SF_FORMAT_WAV | SF_FORMAT_PCM_24;
+
+    SNDFILE* file = sf_open(filename.c_str(), SFM_WRITE, &info);
+    if (!file) {
+        return 0;
+    }
+
+    const sf_count_t totalFrames = static_cast<sf_count_t>(targetBytes / (3 * info.channels));
+    const sf_count_t blockFrames = 65536;
+    std::vector<float> block(blockFrames * info.channels);
+
+    sf_count_t written = 0;
+    while (written < totalFrames) {
+        sf_count_t count = std::min(blockFrames, totalFrames - written);
+        for (sf_count_t i = 0; i < count; i++) {
+            float sample = 0.5f * std::sin(2.0f * static_cast<float>(M_PI) * 440.0f * ((written + i) % 48000) / 48000.0f);
+            block[i * 2] = sample;
+            block[i * 2 + 1] = -sample;
+        }
+        written += sf_writef_float(file, block.data(), count);
+    }
+
+    sf_close(file);
+    return written;
+}
+}
+
+class ConversionPipelineTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        testDir = std::filesystem::temp_directory_path() / "m8_pipeline_test";
+        std::filesystem::create_directories(testDir);
+    }
+
+    void TearDown() override {
+        if (std::filesystem::exists(testDir)) {
+            std::filesystem::remove_all(testDir);
+        }
+    }
+
+    // Each file gets a distinct ramp so out-of-order chunks would be detected
+    std::string createRampFile(const std::string& name, int channels, sf_count_t frames, int format) {
+        std::string path = (testDir / name).string();
+        SF_INFO info;
+        info.samplerate = 44100;
+        info.channels = channels;
+        info.format = format;
+
+        SNDFILE* file = sf_open(path.c_str(), SFM_WRITE, &info);
+        std::vector<float> samples(frames * channels);
+        for (sf_count_t i = 0; i < frames; i++) {
+            for (int ch = 0; ch < channels; ch++) {
+                samples[i * channels + ch] = rampValue(i, ch);
+            }
+        }
+        sf_writef_float(file, samples.data(), frames);
+        sf_close(file);
+        return path;
+    }
+
+    static float rampValue(sf_count_t frame, int channel) {
+        return static_cast<float>((frame % 2000) - 1000) / 1024.0f * (channel == 0 ? 1.0f : -1.0f);
+    }
+
+    std::filesystem::path testDir;
+    AudioProcessor audioProcessor;
+};
+
+TEST_F(ConversionPipelineTest, ConvertsFilesInChunkOrder) {
+    ConversionPipeline::Config config;
+    config.readerThreads = 3;
+    config.transformThreads = 3;
+    config.writerThreads = 2;
+    config.queueDepth = 2;     // Tiny queues force backpressure between stages
+    config.blockFrames = 256;  // Many chunks per file
+
+    std::mutex resultsMutex;
+    std::map<std::string, bool> results;
+    ConversionPipeline pipeline(audioProcessor, config, [&](const ConversionJob& job, bool success, const AudioInfo&, ConversionPipeline::FastPath) {
+        std::lock_guard<std::mutex> lock(resultsMutex);
+        results[job.outputPath] = success;
+    });
+
+    std::vector<ConversionJob> jobs;
+    for (int i = 0; i < 6; i++) {
+        ConversionJob job;
+        job.inputPath = createRampFile("in" + std::to_string(i) + ".wav", 1 + i % 2, 5000 + i * 313,
+                                       SF_FORMAT_WAV | SF_FORMAT_PCM_24);
+        job.outputPath = (testDir / "out" / ("nested" + std::to_string(i)) / "out.wav").string();
+        jobs.push_back(job);
+        pipeline.submit(job);
+    }
+    pipeline.finish();
+
+    ASSERT_EQ(results.size(), jobs.size());
+    for (size_t i = 0; i < jobs.size(); i++) {
+        EXPECT_TRUE(results[jobs[i].outputPath]);
+
+        SF_INFO info;
+        SNDFILE* output = sf_open(jobs[i].outputPath.c_str(), SFM_READ, &info);
+        ASSERT_NE(output, nullptr);
+        EXPECT_EQ(info.format & SF_FORMAT_SUBMASK, SF_FORMAT_PCM_16);
+        EXPECT_EQ(info.frames, 5000 + static_cast<sf_count_t>(i) * 313);
+
+        std::vector<float> samples(info.frames * info.channels);
+        sf_readf_float(output, samples.data(), info.frames);
+        sf_close(output);
+
+        for (sf_count_t f = 0; f < info.frames; f++) {
+            for (int ch = 0; ch < info.channels; ch++) {
+                ASSERT_NEAR(samples[f * info.channels + ch], rampValue(f, ch), 1.0f / 16384.0f)
+                    << "file " << i << " frame " << f;
+            }
+        }
+    }
+
+    auto stages = pipeline.getStageStats();
+    ASSERT_EQ(stages.size(), 3u);
+    EXPECT_EQ(stages[0].items, jobs.size());
+    EXPECT_LE(stages[1].maxDepth, 2u);
+    EXPECT_LE(stages[2].maxDepth, 2u);
+
+    auto schedule = pipeline.getScheduleStats();
+    EXPECT_EQ(schedule.jobs, jobs.size());
+    EXPECT_GT(schedule.busySeconds, 0.0);
+    EXPECT_LE(schedule.longestJobSeconds, schedule.idealSeconds);
+    EXPECT_LE(schedule.idealSeconds, schedule.makespanSeconds * 1.0001);
+}
+
+TEST_F(ConversionPipelineTest, CostlierJobsAreReadFirst) {
+    ConversionPipeline::Config config;
+    config.readerThreads = 1;
+    config.transformThreads = 1;
+    config.writerThreads = 1;
+
+    // With one thread per stage files complete in the order they were read
+    std::mutex orderMutex;
+    std::vector<std::string> order;
+    ConversionPipeline pipeline(audioProcessor, config, [&](const ConversionJob& job, bool, const AudioInfo&, ConversionPipeline::FastPath) {
+        std::lock_guard<std::mutex> lock(orderMutex);
+        order.push_back(std::filesystem::path(job.inputPath).stem().string());
+    });
+
+    // The first job may start before the rest are queued; the rest must wait in cost order
+    ConversionJob first;
+    first.inputPath = createRampFile("first.wav", 2, 200000, SF_FORMAT_WAV | SF_FORMAT_PCM_24);
+    first.outputPath = (testDir / "out" / "first.wav").string();
+    std::vector<ConversionJob> jobs;
+    for (int cost : {1, 5, 3, 4, 2}) {
+        ConversionJob job;
+        job.inputPath = createRampFile("cost" + std::to_string(cost) + ".wav", 1, 1000, SF_FORMAT_WAV | SF_FORMAT_PCM_24);
+        job.outputPath = (testDir / "out" / ("cost" + std::to_string(cost) + ".wav")).string();
+        job.cost = cost;
+        jobs.push_back(job);
+    }
+    pipeline.submit(first);
+    for (const auto& job : jobs) {
+        pipeline.submit(job);
+    }
+    pipeline.finish();
+
+    order.erase(std::remove(order.begin(), order.end(), "first"), order.end());
+    EXPECT_EQ(order, (std::vector<std::string>{"cost5", "cost4", "cost3", "cost2", "cost1"}));
+}
+
+TEST_F(ConversionPipelineTest, CostEstimateWeighsCodecs) {
+    ConversionPipeline::Config config;
+    AudioProbe::Result probe;
+    probe.status = AudioProbe::VALID;
+    probe.info = {44100, 2, 16, 1000, true, true};
+
+    probe.format = SF_FORMAT_WAV | SF_FORMAT_PCM_16;
+    double copy = ConversionPipeline::estimateCost(probe, 1000000, config);
+    probe.format = SF_FORMAT_AIFF | SF_FORMAT_PCM_16;
+    double native = ConversionPipeline::estimateCost(probe, 1000000, config);
+    probe.format = SF_FORMAT_WAV | SF_FORMAT_FLOAT;
+    probe.info.bitDepth = 32;
+    double floats = ConversionPipeline::estimateCost(probe, 1000000, config);
+    probe.format = SF_FORMAT_WAV | SF_FORMAT_PCM_24;
+    probe.info.bitDepth = 24;
+    double pcm24 = ConversionPipeline::estimateCost(probe, 1000000, config);
+
+    // The same number of bytes holds more samples at narrower widths
+    EXPECT_LT(copy, floats);
+    EXPECT_LT(floats, pcm24);
+    EXPECT_LT(pcm24, native);
+    EXPECT_DOUBLE_EQ(ConversionPipeline::estimateCost(probe, 2000000, config), 2 * pcm24);
+
+    probe.format = SF_FORMAT_FLAC | SF_FORMAT_PCM_24;
+    EXPECT_GT(ConversionPipeline::estimateCost(probe, 1000000, config), pcm24);
+
+    // Resampling a 96 kHz source costs more than converting it
+    probe.info.sampleRate = 96000;
+    probe.format = SF_FORMAT_WAV | SF_FORMAT_PCM_24;
+    config.targetSampleRate = 44100;
+    EXPECT_GT(ConversionPipeline::estimateCost(probe, 1000000, config), pcm24);
+}
+
+TEST_F(ConversionPipelineTest, ReportsUnreadableFiles) {
+    std::string bogus = (testDir / "bogus.wav").string();
+    std::ofstream(bogus) << "not audio";
+
+    bool reported = false;
+    bool succeeded = true;
+    ConversionPipeline pipeline(audioProcessor, ConversionPipeline::Config(), [&](const ConversionJob&, bool success, const AudioInfo&, ConversionPipeline::FastPath) {
+        reported = true;
+        succeeded = success;
+    });
+
+    ConversionJob job;
+    job.inputPath = bogus;
+    job.outputPath = (testDir / "out" / "bogus.wav").string();
+    pipeline.submit(job);
+    pipeline.finish();
+
+    EXPECT_TRUE(reported);
+    EXPECT_FALSE(succeeded);
+    EXPECT_FALSE(std::filesystem::exists(job.outputPath));
+}
+
+TEST_F(ConversionPipelineTest, FinishWithNoJobs) {
+    ConversionPipeline pipeline(audioProcessor, ConversionPipeline::Config(), nullptr);
+    pipeline.finish();
+    EXPECT_EQ(pipeline.getStageStats()[0].items, 0u);
+}
+
+TEST_F(ConversionPipelineTest, SixteenBitSourcesSkipFloatConversion) {
+    ConversionPipeline::Config config;
+    config.blockFrames = 256;
+
+    std::mutex resultsMutex;
+    std::map<std::string, ConversionPipeline::FastPath> paths;
+    auto record = [&](const ConversionJob& job, bool success, const AudioInfo&, ConversionPipeline::FastPath fastPath) {
+        std::lock_guard<std::mutex> lock(resultsMutex);
+        EXPECT_TRUE(success) << job.inputPath;
+        paths[job.inputPath] = fastPath;
+    };
+
+    ConversionJob wav{createRampFile("in16.wav", 2, 3000, SF_FORMAT_WAV | SF_FORMAT_PCM_16),
+                      (testDir / "out" / "wav" / "in16.wav").string()};
+    ConversionJob aiff{createRampFile("in16.aiff", 2, 3000, SF_FORMAT_AIFF | SF_FORMAT_PCM_16),
+                       (testDir / "out" / "aiff" / "in16.wav").string()};
+    {
+        ConversionPipeline pipeline(audioProcessor, config, record);
+        pipeline.submit(wav);
+        pipeline.submit(aiff);
+        pipeline.finish();
+    }
+    EXPECT_EQ(paths[wav.inputPath], ConversionPipeline::FastPath::COPY);
+    EXPECT_EQ(paths[aiff.inputPath], ConversionPipeline::FastPath::NATIVE_PCM);
+
+    // A copy is byte-identical to the source
+    std::ifstream source(wav.inputPath, std::ios::binary), copy(wav.outputPath, std::ios::binary);
+    std::string sourceBytes((std::istreambuf_iterator<char>(source)), std::istreambuf_iterator<char>());
+    std::string copyBytes((std::istreambuf_iterator<char>(copy)), std::istreambuf_iterator<char>());
+    EXPECT_EQ(sourceBytes, copyBytes);
+
+    // The rewritten container carries exactly the source samples
+    auto readShorts = [](const std::string& path, SF_INFO& info) {
+        SNDFILE* file = sf_open(path.c_str(), SFM_READ, &info);
+        std::vector<short> samples(file ? info.frames * info.channels : 0);
+        if (file) {
+            sf_readf_short(file, samples.data(), info.frames);
+            sf_close(file);
+        }
+        return samples;
+    };
+    SF_INFO sourceInfo, outputInfo;
+    std::vector<short> sourceSamples = readShorts(aiff.inputPath, sourceInfo);
+    std::vector<short> outputSamples = readShorts(aiff.outputPath, outputInfo);
+    EXPECT_EQ(outputInfo.format, SF_FORMAT_WAV | SF_FORMAT_PCM_16);
+    EXPECT_EQ(outputSamples, sourceSamples);
+
+    // Disabled, the same source goes through float conversion
+    config.nativeFastPath = false;
+    {
+        ConversionPipeline pipeline(audioProcessor, config, record);
+        pipeline.submit(wav);
+        pipeline.finish();
+    }
+    EXPECT_EQ(paths[wav.inputPath], ConversionPipeline::FastPath::NONE);
+}
+
+TEST_F(ConversionPipelineTest, ResamplesSourcesAboveTargetRate) {
+    ConversionPipeline::Config config;
+    config.blockFrames = 1000;  // Resampler state must carry across chunks
+    config.targetSampleRate = 44100;
+
+    std::mutex resultsMutex;
+    std::map<std::string, bool> results;
+    ConversionPipeline pipeline(audioProcessor, config, [&](const ConversionJob& job, bool success, const AudioInfo&, ConversionPipeline::FastPath fastPath) {
+        std::lock_guard<std::mutex> lock(resultsMutex);
+        results[job.inputPath] = success && fastPath == ConversionPipeline::FastPath::NONE;
+    });
+
+    // 16-bit sources at a higher rate must not take the copy path
+    ConversionJob high{createRampFile("in96k.wav", 2, 9600, SF_FORMAT_WAV | SF_FORMAT_PCM_16),
+                       (testDir / "out" / "in96k.wav").string()};
+    ConversionJob low{createRampFile("in22k.wav", 1, 2205, SF_FORMAT_WAV | SF_FORMAT_PCM_24),
+                      (testDir / "out" / "in22k.wav").string()};
+    // createRampFile writes 44.1 kHz; rewrite the rates in place
+    for (auto& [path, rate] : std::vector<std::pair<std::string, int>>{{high.inputPath, 96000}, {low.inputPath, 22050}}) {
+        SF_INFO info;
+        SNDFILE* source = sf_open(path.c_str(), SFM_READ, &info);
+        std::vector<float> samples(info.frames * info.channels);
+        sf_readf_float(source, samples.data(), info.frames);
+        sf_close(source);
+        info.samplerate = rate;
+        SNDFILE* rewritten = sf_open(path.c_str(), SFM_WRITE, &info);
+        sf_writef_float(rewritten, samples.data(), static_cast<sf_count_t>(samples.size() / info.channels));
+        sf_close(rewritten);
+    }
+
+    pipeline.submit(high);
+    pipeline.submit(low);
+    pipeline.finish();
+
+    EXPECT_TRUE(results[high.inputPath]);
+    EXPECT_TRUE(results[low.inputPath]);
+
+    SF_INFO info;
+    SNDFILE* output = sf_open(high.outputPath.c_str(), SFM_READ, &info);
+    ASSERT_NE(output, nullptr);
+    sf_close(output);
+    EXPECT_EQ(info.samplerate, 44100);
+    EXPECT_EQ(info.channels, 2);
+    EXPECT_EQ(info.frames, 4410);
+
+    // Lower rates are left alone
+    output = sf_open(low.outputPath.c_str(), SFM_READ, &info);
+    ASSERT_NE(output, nullptr);
+    sf_close(output);
+    EXPECT_EQ(info.samplerate, 22050);
+    EXPECT_EQ(info.frames, 2205);
+}
+
+TEST_F(ConversionPipelineTest, TrimsLeadingAndTrailingSilence) {
+    ConversionPipeline::Config config;
+    config.blockFrames = 1000;  // Silence spans several chunks at both ends
+    config.trimSilence = true;
+
+    bool succeeded = false;
+    ConversionPipeline::FastPath path = ConversionPipeline::FastPath::COPY;
+    ConversionPipeline pipeline(audioProcessor, config, [&](const ConversionJob&, bool success, const AudioInfo&, ConversionPipeline::FastPath fastPath) {
+        succeeded = success;
+        path = fastPath;
+    });
+
+    // 16-bit stereo: 2500 silent frames, 3000 frames of audio, 4200 silent frames
+    std::string inputPath = (testDir / "padded.wav").string();
+    SF_INFO info;
+    info.samplerate = 44100;
+    info.channels = 2;
+    info.format = SF_FORMAT_WAV | SF_FORMAT_PCM_16;
+    std::vector<float> samples((2500 + 3000 + 4200) * 2, 0.0f);
+    for (size_t i = 0; i < 3000; i++) {
+        samples[(2500 + i) * 2] = rampValue(static_cast<sf_count_t>(i), 0) * 0.5f + 0.25f;
+    }
+    SNDFILE* source = sf_open(inputPath.c_str(), SFM_WRITE, &info);
+    sf_writef_float(source, samples.data(), static_cast<sf_count_t>(samples.size() / 2));
+    sf_close(source);
+
+    ConversionJob job;
+    job.inputPath = inputPath;
+    job.outputPath = (testDir / "out" / "padded.wav").string();
+    pipeline.submit(job);
+    pipeline.finish();
+
+    EXPECT_TRUE(succeeded);
+    EXPECT_EQ(path, ConversionPipeline::FastPath::NATIVE_PCM);  // Rewritten, not copied untrimmed
+    EXPECT_EQ(pipeline.getTrimmedFiles(), 1u);
+    EXPECT_EQ(pipeline.getTrimmedBytes(), (2500u + 4200u) * 2 * sizeof(short));
+
+    SNDFILE* output = sf_open(job.outputPath.c_str(), SFM_READ, &info);
+    ASSERT_NE(output, nullptr);
+    std::vector<short> trimmed(info.frames * info.channels);
+    sf_readf_short(output, trimmed.data(), info.frames);
+    sf_close(output);
+    ASSERT_EQ(info.frames, 3000);
+
+    // Kept audio passes through bit-exact
+    SNDFILE* original = sf_open(inputPath.c_str(), SFM_READ, &info);
+    std::vector<short> expected(info.frames * info.channels);
+    sf_readf_short(original, expected.data(), info.frames);
+    sf_close(original);
+    EXPECT_TRUE(std::equal(trimmed.begin(), trimmed.end(), expected.begin() + 2500 * 2));
+}
+
+TEST_F(ConversionPipelineTest, RewritingALinkedDuplicateLeavesThePrimaryAlone) {
+    std::string primary = createRampFile("a.wav", 2, 6000, SF_FORMAT_WAV | SF_FORMAT_PCM_24);
+    std::string copy = (testDir / "b.wav").string();
+    std::filesystem::copy_file(primary, copy);
+
+    auto convert = [&](const std::vector<std::string>& inputs) {
+        ConversionPipeline::Config config;
+        config.readerThreads = 1;
+        config.dedup = ConversionPipeline::DedupMode::LINK;
+        ConversionPipeline pipeline(audioProcessor, config, [](const ConversionJob& job, bool success, const AudioInfo&, ConversionPipeline::FastPath) {
+            EXPECT_TRUE(success) << job.inputPath;
+        });
+        for (const auto& input : inputs) {
+            ConversionJob job;
+            job.inputPath = input;
+            job.outputPath = (testDir / "out" / std::filesystem::path(input).filename()).string();
+            pipeline.submit(job);
+        }
+        pipeline.finish();
+    };
+    auto bytesOf = [](const std::filesystem::path& path) {
+        std::ifstream file(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    };
+
+    convert({primary, copy});
+    auto primaryOutput = testDir / "out" / "a.wav";
+    auto copyOutput = testDir / "out" / "b.wav";
+    ASSERT_TRUE(std::filesystem::equivalent(primaryOutput, copyOutput));
+    const std::string before = bytesOf(primaryOutput);
+
+    // The copy's source changes and only it is converted again, as an incremental run would
+    std::filesystem::remove(copy);
+    createRampFile("b.wav", 2, 3000, SF_FORMAT_WAV | SF_FORMAT_PCM_24);
+    convert({copy});
+    EXPECT_FALSE(std::filesystem::equivalent(primaryOutput, copyOutput));
+    EXPECT_EQ(bytesOf(primaryOutput), before);
+    EXPECT_NE(bytesOf(copyOutput), before);
+
+    // A copy over a linked name replaces the name, not the shared file
+    std::filesystem::remove(copyOutput);
+    std::filesystem::create_hard_link(primaryOutput, copyOutput);
+    ASSERT_TRUE(FileOperations::cloneFile(copy, copyOutput.string()));
+    EXPECT_EQ(bytesOf(primaryOutput), before);
+}
+
+TEST_F(ConversionPipelineTest, DeduplicatesIdenticalAudio) {
+    // Three copies of one sample in different packs, plus an unrelated one
+    std::string original = createRampFile("a.wav", 2, 6000, SF_FORMAT_WAV | SF_FORMAT_PCM_24);
+    std::string unique = createRampFile("u.wav", 2, 6001, SF_FORMAT_WAV | SF_FORMAT_PCM_24);
+    std::vector<std::string> inputs = {original, (testDir / "b.wav").string(), (testDir / "c.wav").string(), unique};
+    std::filesystem::copy_file(original, inputs[1]);
+    std::filesystem::copy_file(original, inputs[2]);
+
+    auto run = [&](ConversionPipeline::DedupMode mode, const std::string& outDir) {
+        ConversionPipeline::Config config;
+        config.readerThreads = 4;
+        config.blockFrames = 512;
+        config.dedup = mode;
+
+        std::mutex resultsMutex;
+        std::map<std::string, ConversionPipeline::FastPath> paths;
+        ConversionPipeline pipeline(audioProcessor, config, [&](const ConversionJob& job, bool success, const AudioInfo&, ConversionPipeline::FastPath fastPath) {
+            std::lock_guard<std::mutex> lock(resultsMutex);
+            EXPECT_TRUE(success) << job.inputPath;
+            paths[job.inputPath] = fastPath;
+        });
+        for (const auto& input : inputs) {
+            ConversionJob job;
+            job.inputPath = input;
+            job.outputPath = (testDir / outDir / std::filesystem::path(input).filename()).string();
+            pipeline.submit(job);
+        }
+        pipeline.finish();
+
+        EXPECT_EQ(paths.size(), inputs.size());
+        EXPECT_EQ(pipeline.getDuplicateFiles(), 2u);
+        auto groups = pipeline.getDuplicateGroups();
+        EXPECT_EQ(groups.size(), 1u);
+        if (!groups.empty()) {
+            EXPECT_EQ(groups[0].duplicates.size(), 2u);
+        }
+
+        size_t duplicates = 0;
+        for (const auto& [input, path] : paths) {
+            duplicates += path == ConversionPipeline::FastPath::DUPLICATE;
+        }
+        EXPECT_EQ(duplicates, mode == ConversionPipeline::DedupMode::REPORT ? 0u : 2u);
+        return pipeline.getDedupBytesSaved();
+    };
+
+    auto outputs = [&](const std::string& outDir) {
+        std::vector<std::filesystem::path> paths;
+        for (const auto& input : inputs) {
+            paths.push_back(testDir / outDir / std::filesystem::path(input).filename());
+        }
+        return paths;
+    };
+
+    // Linked: every output exists and the copies share one inode
+    uint64_t saved = run(ConversionPipeline::DedupMode::LINK, "link");
+    auto linked = outputs("link");
+    for (const auto& path : linked) {
+        EXPECT_TRUE(std::filesystem::exists(path)) << path;
+    }
+    EXPECT_TRUE(std::filesystem::equivalent(linked[0], linked[1]) || std::filesystem::equivalent(linked[1], linked[2]));
+    EXPECT_EQ(std::filesystem::hard_link_count(linked[0]) + std::filesystem::hard_link_count(linked[1]) +
+                  std::filesystem::hard_link_count(linked[2]), 9u);
+    EXPECT_EQ(std::filesystem::hard_link_count(linked[3]), 1u);
+    EXPECT_EQ(saved, 2 * std::filesystem::file_size(linked[0]));
+
+    // Skipped: exactly one of the three copies is written
+    EXPECT_GT(run(ConversionPipeline::DedupMode::SKIP, "skip"), 0u);
+    auto skipped = outputs("skip");
+    EXPECT_EQ(std::filesystem::exists(skipped[0]) + std::filesystem::exists(skipped[1]) +
+                  std::filesystem::exists(skipped[2]), 1);
+    EXPECT_TRUE(std::filesystem::exists(skipped[3]));
+
+    // Reported: everything is converted, nothing saved
+    EXPECT_EQ(run(ConversionPipeline::DedupMode::REPORT, "report"), 0u);
+    for (const auto& path : outputs("report")) {
+        EXPECT_TRUE(std::filesystem::exists(path)) << path;
+    }
+}
+
+TEST_F(ConversionPipelineTest, LongSourcesStayUnderMemoryCeiling) {
+    // Source size defaults to 48 MiB, several hundred chunks; set M8_STREAM_TEST_BYTES to
+    // exercise multi-GB files
+    size_t sourceBytes = size_t(48) << 20;
+    if (const char* env = std::getenv("M8_STREAM_TEST_BYTES")) {
+        sourceBytes = std::strtoull(env, nullptr, 10);
+    }
+    // Fixed budget for the conversion itself, independent of the source size and well under the
+    // 64 MiB a whole-file float decode of the default source would take
+    const size_t rssBudget = size_t(16) << 20;
+
+    std::string inputFile = (testDir / "large.wav").string();
+    std::string outputFile = (testDir / "large_out.wav").string();
+    sf_count_t frames = createLargeWavFile(inputFile, sourceBytes);
+    ASSERT_GT(frames, 0);
+
+    ConversionPipeline::Config config;
+    config.memoryMap = false;  // A mapping's pages count as resident, though the kernel can drop them
+    bool converted = false;
+    AudioInfo info;
+    ConversionPipeline pipeline(audioProcessor, config, [&](const ConversionJob&, bool success, const AudioInfo& jobInfo, ConversionPipeline::FastPath) {
+        converted = success;
+        info = jobInfo;
+    });
+
+    // Sampled while the file converts, since the high-water mark is process-wide
+    const size_t baseline = residentBytes();
+    std::atomic<bool> done{false};
+    std::atomic<size_t> peak{baseline};
+    std::thread sampler([&] {
+        while (!done.load()) {
+            peak.store(std::max(peak.load(), residentBytes()));
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+    ConversionJob job;
+    job.inputPath = inputFile;
+    job.outputPath = outputFile;
+    pipeline.submit(job);
+    pipeline.finish();
+    done.store(true);
+    sampler.join();
+
+    EXPECT_TRUE(converted);
+    EXPECT_EQ(info.frameCount, static_cast<size_t>(frames));
+    EXPECT_LT(peak.load() - baseline, rssBudget);
+
+    SF_INFO outputInfo;
+    SNDFILE* output = sf_open(outputFile.c_str(), SFM_READ, &outputInfo);
+    ASSERT_NE(output, nullptr);
+    EXPECT_EQ(outputInfo.frames, frames);
+    EXPECT_EQ(outputInfo.format & SF_FORMAT_SUBMASK, SF_FORMAT_PCM_16);
+    sf_close(output);
+}
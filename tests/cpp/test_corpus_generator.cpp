@@ -0,0 +1,180 @@
+#include <gtest/gtest.h>
+#include "CorpusGenerator.h"
+#include "M8SampleFormatter.h"
+#include <sndfile.h>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <string>
+
+namespace {
+class CorpusGeneratorTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        root = std::filesystem::temp_directory_path() / "m8_corpus_test";
+        std::filesystem::remove_all(root);
+        config.files = 40;
+        config.oneShotMaxSeconds = 0.1;
+        config.loopMinSeconds = 0.5;
+        config.loopMaxSeconds = 1.0;
+    }
+    void TearDown() override { std::filesystem::remove_all(root); }
+
+    // Relative path -> contents
+    static std::map<std::string, std::string> readTree(const std::filesystem::path& dir) {
+        std::map<std::string, std::string> tree;
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(dir)) {
+            if (entry.is_regular_file()) {
+                std::ifstream file(entry.path(), std::ios::binary);
+                tree[std::filesystem::relative(entry.path(), dir).string()] =
+                    std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+            }
+        }
+        return tree;
+    }
+
+    std::filesystem::path root;
+    CorpusGenerator::Config config;
+};
+}
+
+TEST_F(CorpusGeneratorTest, SameConfigGivesTheSameCorpus) {
+    CorpusGenerator::Result first;
+    CorpusGenerator::Result second;
+    ASSERT_TRUE(CorpusGenerator(config).generate((root / "a").string(), first));
+    ASSERT_TRUE(CorpusGenerator(config).generate((root / "b").string(), second));
+
+    EXPECT_EQ(first.files, 40u);
+    EXPECT_EQ(first.bytes, second.bytes);
+    auto a = readTree(root / "a");
+    EXPECT_EQ(a.size(), 40u);
+    EXPECT_TRUE(a == readTree(root / "b"));
+
+    config.seed = 2;
+    ASSERT_TRUE(CorpusGenerator(config).generate((root / "c").string(), second));
+    EXPECT_FALSE(a == readTree(root / "c"));
+}
+
+TEST_F(CorpusGeneratorTest, GrowingTheCorpusKeepsExistingFiles) {
+    CorpusGenerator::Result result;
+    ASSERT_TRUE(CorpusGenerator(config).generate((root / "small").string(), result));
+    config.files = 60;
+    ASSERT_TRUE(CorpusGenerator(config).generate((root / "large").string(), result));
+
+    auto small = readTree(root / "small");
+    auto large = readTree(root / "large");
+    EXPECT_EQ(large.size(), 60u);
+    for (const auto& [path, contents] : small) {
+        ASSERT_TRUE(large.count(path)) << path;
+        EXPECT_TRUE(large[path] == contents) << path;
+    }
+}
+
+TEST_F(CorpusGeneratorTest, FollowsTheConfiguredDistribution) {
+    config.formats = {{CorpusGenerator::Format::AIFF_24, 1.0}};
+    config.sampleRates = {{48000, 1.0}};
+    config.channels = {{2, 1.0}};
+    config.minDepth = 2;
+    config.maxDepth = 2;
+    config.duplicateFraction = 0.0;
+    config.longNameFraction = 0.0;
+    config.unicodeNameFraction = 0.0;
+
+    CorpusGenerator::Result result;
+    ASSERT_TRUE(CorpusGenerator(config).generate(root.string(), result));
+    EXPECT_EQ(result.perFormat[static_cast<size_t>(CorpusGenerator::Format::AIFF_24)], 40u);
+
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(root)) {
+        if (!entry.is_regular_file()) continue;
+        auto relative = std::filesystem::relative(entry.path(), root);
+        EXPECT_EQ(std::distance(relative.begin(), relative.end()), 4);  // Pack, two folders, file
+        EXPECT_EQ(entry.path().extension(), ".aif");
+
+        SF_INFO info = {};
+        SNDFILE* file = sf_open(entry.path().string().c_str(), SFM_READ, &info);
+        ASSERT_NE(file, nullptr) << entry.path();
+        EXPECT_EQ(info.format, SF_FORMAT_AIFF | SF_FORMAT_PCM_24);
+        EXPECT_EQ(info.samplerate, 48000);
+        EXPECT_EQ(info.channels, 2);
+        EXPECT_GE(info.frames, 2400);  // oneShotMinSeconds
+        sf_close(file);
+    }
+}
+
+TEST_F(CorpusGeneratorTest, UnavailableFormatsAreWrittenAsWav) {
+    config.formats = {{CorpusGenerator::Format::FLAC_24, 1.0}, {CorpusGenerator::Format::OGG_VORBIS, 1.0}};
+    config.duplicateFraction = 0.0;
+
+    CorpusGenerator::Result result;
+    ASSERT_TRUE(CorpusGenerator(config).generate(root.string(), result));
+    EXPECT_EQ(result.files, 40u);
+
+    size_t expectedSubstitutes = 0;
+    for (auto format : {CorpusGenerator::Format::FLAC_24, CorpusGenerator::Format::OGG_VORBIS}) {
+        if (!CorpusGenerator::isAvailable(format)) {
+            expectedSubstitutes += result.perFormat[static_cast<size_t>(format)];
+        }
+    }
+    EXPECT_EQ(result.substituted, expectedSubstitutes);
+
+    size_t wavFiles = 0;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(root)) {
+        wavFiles += entry.is_regular_file() && entry.path().extension() == ".wav";
+    }
+    EXPECT_EQ(wavFiles, expectedSubstitutes);
+}
+
+TEST_F(CorpusGeneratorTest, PathologicalNamesAreLongOrNonAscii) {
+    config.longNameFraction = 0.5;
+    config.unicodeNameFraction = 0.5;
+
+    CorpusGenerator::Result result;
+    ASSERT_TRUE(CorpusGenerator(config).generate(root.string(), result));
+
+    size_t longNames = 0;
+    size_t unicodeNames = 0;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(root)) {
+        if (!entry.is_regular_file()) continue;
+        std::string name = entry.path().filename().string();
+        EXPECT_LE(name.size(), 255u);
+        bool nonAscii = false;
+        for (char c : name) {
+            nonAscii |= static_cast<unsigned char>(c) >= 0x80;
+        }
+        longNames += name.size() > 230;
+        unicodeNames += nonAscii;
+        EXPECT_TRUE(name.size() > 230 || nonAscii) << name;
+    }
+    EXPECT_GT(longNames, 0u);
+    EXPECT_GT(unicodeNames, 0u);
+}
+
+TEST_F(CorpusGeneratorTest, InvalidConfigurationIsRejected) {
+    config.formats.clear();
+    CorpusGenerator::Result result;
+    EXPECT_FALSE(CorpusGenerator(config).generate(root.string(), result));
+
+    config = CorpusGenerator::Config();
+    config.minDepth = 3;
+    config.maxDepth = 1;
+    EXPECT_FALSE(CorpusGenerator(config).generate(root.string(), result));
+}
+
+// The formatter takes a generated library, pathological names included, without errors
+TEST_F(CorpusGeneratorTest, FormatterConvertsAGeneratedLibrary) {
+    config.longNameFraction = 0.1;
+    config.unicodeNameFraction = 0.2;
+    CorpusGenerator::Result result;
+    ASSERT_TRUE(CorpusGenerator(config).generate((root / "source").string(), result));
+
+    M8SampleFormatter::ProcessingOptions options;
+    options.incremental = false;
+    M8SampleFormatter formatter;
+    ASSERT_TRUE(formatter.processDirectory((root / "source").string(), (root / "output").string(), options));
+
+    const auto& stats = formatter.getStats();
+    EXPECT_EQ(stats.totalFiles, result.files);
+    EXPECT_EQ(stats.errorFiles, 0u);
+    EXPECT_EQ(stats.processedFiles, result.files);
+}
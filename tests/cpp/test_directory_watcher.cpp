@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include "DirectoryWatcher.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+
+namespace {
+using std::chrono::milliseconds;
+
+class DirectoryWatcherTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        if (!DirectoryWatcher::isSupported()) {
+            GTEST_SKIP() << "No inotify on this platform";
+        }
+        root = std::filesystem::temp_directory_path() / "m8_watcher_test";
+        std::filesystem::remove_all(root);
+        std::filesystem::create_directories(root / "Pack" / "Drums");
+        ASSERT_TRUE(watcher.start(root.string()));
+    }
+    void TearDown() override { std::filesystem::remove_all(root); }
+
+    static void writeFile(const std::filesystem::path& path) {
+        std::ofstream file(path, std::ios::binary);
+        file << "RIFF";
+    }
+
+    static bool contains(const DirectoryWatcher::Changes& changes, const std::filesystem::path& path) {
+        return std::find(changes.files.begin(), changes.files.end(), path.string()) != changes.files.end();
+    }
+
+    std::filesystem::path root;
+    DirectoryWatcher watcher;
+};
+}
+
+TEST_F(DirectoryWatcherTest, ReportsFilesClosedAfterWriting) {
+    EXPECT_EQ(watcher.getWatchCount(), 3u);
+    writeFile(root / "Pack" / "Drums" / "Kick.wav");
+
+    auto changes = watcher.waitForChanges(milliseconds(20), milliseconds(2000));
+    ASSERT_EQ(changes.files.size(), 1u);
+    EXPECT_TRUE(contains(changes, root / "Pack" / "Drums" / "Kick.wav"));
+    EXPECT_FALSE(changes.overflowed);
+
+    // Nothing else happened
+    EXPECT_TRUE(watcher.waitForChanges(milliseconds(20), milliseconds(50)).files.empty());
+}
+
+TEST_F(DirectoryWatcherTest, BurstArrivesAsOneBatch) {
+    std::thread writer([this] {
+        for (int i = 0; i < 20; i++) {
+            writeFile(root / "Pack" / ("Hit " + std::to_string(i) + ".wav"));
+            writeFile(root / "Pack" / ("Hit " + std::to_string(i) + ".wav"));  // Closed twice, reported once
+            std::this_thread::sleep_for(milliseconds(2));
+        }
+    });
+    auto changes = watcher.waitForChanges(milliseconds(200), milliseconds(2000));
+    writer.join();
+    EXPECT_EQ(changes.files.size(), 20u);
+}
+
+TEST_F(DirectoryWatcherTest, FoldersMovedInAreWatchedAndTheirFilesReported) {
+    // Unpacked elsewhere, then moved into the watched tree in one rename
+    auto staging = std::filesystem::temp_directory_path() / "m8_watcher_staging";
+    std::filesystem::remove_all(staging);
+    std::filesystem::create_directories(staging / "New Pack" / "Loops");
+    writeFile(staging / "New Pack" / "Loops" / "Loop.wav");
+    std::filesystem::rename(staging / "New Pack", root / "New Pack");
+    std::filesystem::remove_all(staging);
+
+    auto changes = watcher.waitForChanges(milliseconds(20), milliseconds(2000));
+    EXPECT_TRUE(contains(changes, root / "New Pack" / "Loops" / "Loop.wav"));
+    EXPECT_EQ(watcher.getWatchCount(), 5u);
+
+    writeFile(root / "New Pack" / "Loops" / "Loop 2.wav");
+    changes = watcher.waitForChanges(milliseconds(20), milliseconds(2000));
+    EXPECT_TRUE(contains(changes, root / "New Pack" / "Loops" / "Loop 2.wav"));
+}
+
+TEST_F(DirectoryWatcherTest, StopWakesTheWaiter) {
+    std::thread stopper([this] {
+        std::this_thread::sleep_for(milliseconds(50));
+        watcher.stop();
+    });
+    auto start = std::chrono::steady_clock::now();
+    auto changes = watcher.waitForChanges(milliseconds(20), milliseconds(10000));
+    stopper.join();
+
+    EXPECT_TRUE(changes.files.empty());
+    EXPECT_TRUE(watcher.isStopped());
+    EXPECT_FALSE(watcher.lostRoot());
+    EXPECT_LT(std::chrono::steady_clock::now() - start, milliseconds(5000));
+}
+
+TEST_F(DirectoryWatcherTest, StopsWhenTheRootIsDeleted) {
+    std::thread remover([this] {
+        std::this_thread::sleep_for(milliseconds(50));
+        std::filesystem::remove_all(root);
+    });
+    auto start = std::chrono::steady_clock::now();
+    auto changes = watcher.waitForChanges(milliseconds(20), milliseconds(10000));
+    remover.join();
+
+    EXPECT_TRUE(changes.files.empty());
+    EXPECT_TRUE(watcher.isStopped());
+    EXPECT_TRUE(watcher.lostRoot());
+    EXPECT_EQ(watcher.getWatchCount(), 0u);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, milliseconds(5000));
+}
@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include "FileScanner.h"
+#include <algorithm>
 #include <filesystem>
 #include <vector>
 #include <fstream>
@@ -260,3 +261,46 @@ TEST_F(FileScannerTest, Statistics) {
     // Skipped files should be non-audio files
     EXPECT_GE(scanner->getSkippedFiles(), 0);
 }
+
+TEST_F(FileScannerTest, ParallelScanOfDeepTreeIsCompleteAndSorted) {
+    std::filesystem::path treeRoot = testDir / "tree";
+    size_t expected = 0;
+    for (int pack = 0; pack < 8; pack++) {
+        for (int folder = 0; folder < 6; folder++) {
+            auto dir = treeRoot / ("Pack" + std::to_string(pack)) / ("Folder" + std::to_string(folder)) / "Deep";
+            std::filesystem::create_directories(dir);
+            for (int i = 0; i < 5; i++) {
+                std::ofstream(dir / ("hit" + std::to_string(i) + ".WAV")) << "data";
+                expected++;
+            }
+            std::ofstream(dir / "notes.txt") << "text";
+            std::ofstream(dir / "no_extension") << "text";
+        }
+    }
+
+    for (size_t threads : {1u, 8u}) {
+        scanner->setScanThreads(threads);
+        auto audioFiles = scanner->scanDirectory(treeRoot.string());
+
+        ASSERT_EQ(audioFiles.size(), expected);
+        EXPECT_EQ(scanner->getSkippedFiles(), 8u * 6u * 2u);
+        EXPECT_TRUE(std::is_sorted(audioFiles.begin(), audioFiles.end(),
+                                   [](const AudioFile& a, const AudioFile& b) { return a.filepath < b.filepath; }));
+        EXPECT_EQ(audioFiles.front().fileSize, 4u);
+        EXPECT_GT(audioFiles.front().modifiedTime, 0);
+    }
+}
+
+TEST_F(FileScannerTest, DoesNotFollowDirectorySymlinks) {
+    std::filesystem::create_directory_symlink(testDir / "subfolder", testDir / "linked");
+    std::filesystem::create_symlink(testDir / "test1.wav", testDir / "linked_file.wav");
+
+    auto audioFiles = scanner->scanDirectory(testDir.string());
+
+    bool foundLinkedFile = false;
+    for (const auto& file : audioFiles) {
+        EXPECT_EQ(file.filepath.find("/linked/"), std::string::npos);
+        if (file.filename == "linked_file.wav") foundLinkedFile = true;
+    }
+    EXPECT_TRUE(foundLinkedFile);
+}
@@ -0,0 +1,160 @@
+#include <gtest/gtest.h>
+#include "JobPlan.h"
+#include <sndfile.h>
+#include <filesystem>
+#include <fstream>
+
+class JobPlanTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        testDir = std::filesystem::temp_directory_path() / "m8_job_plan_test";
+        std::filesystem::remove_all(testDir);
+        std::filesystem::create_directories(testDir);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(testDir);
+    }
+
+    JobPlan samplePlan() {
+        JobPlan plan;
+        plan.sourceDir = "/library";
+        plan.outputDir = "/card/Samples";
+        plan.optionsKey = "bitdepth=16;flatten=1";
+        plan.rejectedFiles = 3;
+
+        JobPlan::Job job;
+        job.source = "Pack\tOne/Kick\n1.wav";
+        job.output = "Pack-One/Kick-1.wav";
+        job.size = 123456;
+        job.modifiedTime = -42;
+        job.probe.status = AudioProbe::VALID;
+        job.probe.format = SF_FORMAT_AIFF | SF_FORMAT_PCM_24;
+        job.probe.info = {48000, 2, 24, 1000000, true, true};
+        job.probe.dataOffset = 54;
+        job.probe.dataBytes = 6000000;
+        job.probe.bigEndian = true;
+        job.conversion = ConversionPipeline::FastPath::NONE;
+        job.estimatedBytes = 4000044;
+        job.cost = 123456.5;
+        plan.jobs.push_back(job);
+
+        job.source = "Pack One/Snare.wav";
+        job.output = "Pack-One/Snare.wav";
+        job.probe = AudioProbe::Result();
+        job.conversion = ConversionPipeline::FastPath::COPY;
+        job.estimatedBytes = 900;
+        job.cost = 1e9;
+        job.upToDate = true;
+        plan.jobs.push_back(job);
+        return plan;
+    }
+
+    std::filesystem::path testDir;
+};
+
+TEST_F(JobPlanTest, SaveLoadRoundTrip) {
+    JobPlan plan = samplePlan();
+    std::string path = (testDir / "plan.m8plan").string();
+    ASSERT_TRUE(plan.save(path));
+
+    JobPlan loaded;
+    ASSERT_TRUE(loaded.load(path));
+    EXPECT_EQ(loaded.sourceDir, plan.sourceDir);
+    EXPECT_EQ(loaded.outputDir, plan.outputDir);
+    EXPECT_EQ(loaded.optionsKey, plan.optionsKey);
+    EXPECT_EQ(loaded.rejectedFiles, 3u);
+    ASSERT_EQ(loaded.jobs.size(), 2u);
+
+    const JobPlan::Job& job = loaded.jobs[0];
+    EXPECT_EQ(job.source, "Pack\tOne/Kick\n1.wav");
+    EXPECT_EQ(job.output, "Pack-One/Kick-1.wav");
+    EXPECT_EQ(job.size, 123456u);
+    EXPECT_EQ(job.modifiedTime, -42);
+    EXPECT_EQ(job.probe.status, AudioProbe::VALID);
+    EXPECT_EQ(job.probe.format, SF_FORMAT_AIFF | SF_FORMAT_PCM_24);
+    EXPECT_EQ(job.probe.info.sampleRate, 48000);
+    EXPECT_EQ(job.probe.info.channels, 2);
+    EXPECT_EQ(job.probe.info.bitDepth, 24);
+    EXPECT_EQ(job.probe.info.frameCount, 1000000u);
+    EXPECT_TRUE(job.probe.info.isStereo);
+    EXPECT_TRUE(job.probe.bigEndian);
+    EXPECT_EQ(job.probe.dataOffset, 54u);
+    EXPECT_EQ(job.probe.dataBytes, 6000000u);
+    EXPECT_EQ(job.conversion, ConversionPipeline::FastPath::NONE);
+    EXPECT_EQ(job.estimatedBytes, 4000044u);
+    EXPECT_EQ(job.cost, 123456.5);
+    EXPECT_FALSE(job.upToDate);
+
+    EXPECT_EQ(loaded.jobs[1].probe.status, AudioProbe::UNKNOWN);
+    EXPECT_EQ(loaded.jobs[1].conversion, ConversionPipeline::FastPath::COPY);
+    EXPECT_TRUE(loaded.jobs[1].upToDate);
+    EXPECT_EQ(loaded.pendingJobs(), 1u);
+    EXPECT_EQ(loaded.pendingBytes(), 4000044u);
+}
+
+TEST_F(JobPlanTest, RejectsDamagedPlans) {
+    std::string path = (testDir / "plan.m8plan").string();
+    ASSERT_TRUE(samplePlan().save(path));
+    std::string bytes;
+    {
+        std::ifstream file(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    auto loadWith = [&](const std::string& content) {
+        std::ofstream(path, std::ios::binary | std::ios::trunc) << content;
+        JobPlan plan;
+        bool loaded = plan.load(path);
+        EXPECT_TRUE(loaded || plan.jobs.empty());
+        return loaded;
+    };
+
+    EXPECT_TRUE(loadWith(bytes));
+    std::string flipped = bytes;
+    flipped[40] ^= 1;
+    EXPECT_FALSE(loadWith(flipped));
+    EXPECT_FALSE(loadWith(bytes.substr(0, bytes.size() - 20)));
+    EXPECT_FALSE(loadWith("M8INDEX\t1\n"));
+
+    JobPlan missing;
+    EXPECT_FALSE(missing.load((testDir / "missing.m8plan").string()));
+}
+
+TEST_F(JobPlanTest, RejectsPathsOutsideTheRoots) {
+    std::string path = (testDir / "plan.m8plan").string();
+    auto loadsWith = [&](const std::string& source, const std::string& output) {
+        JobPlan plan = samplePlan();
+        plan.jobs[1].source = source;
+        plan.jobs[1].output = output;
+        EXPECT_TRUE(plan.save(path));
+        JobPlan loaded;
+        bool ok = loaded.load(path);
+        EXPECT_TRUE(ok || loaded.jobs.empty());
+        return ok;
+    };
+
+    EXPECT_TRUE(loadsWith("Pack..One/..Snare.wav", "Pack-One/Snare...wav"));
+    EXPECT_FALSE(loadsWith("/etc/passwd", "Pack-One/Snare.wav"));
+    EXPECT_FALSE(loadsWith("Pack One/Snare.wav", "/home/user/.bashrc"));
+    EXPECT_FALSE(loadsWith("../Snare.wav", "Pack-One/Snare.wav"));
+    EXPECT_FALSE(loadsWith("Pack One/Snare.wav", "Pack-One/../../Snare.wav"));
+    EXPECT_FALSE(loadsWith("", "Pack-One/Snare.wav"));
+}
+
+TEST_F(JobPlanTest, PathsFollowTheRoots) {
+    JobPlan plan = samplePlan();
+    EXPECT_EQ(JobPlan::relativeTo("/library/Pack/Kick.wav", "/library"), "Pack/Kick.wav");
+    EXPECT_EQ(JobPlan::relativeTo("/library/Pack/Kick.wav", "/library/"), "Pack/Kick.wav");
+    EXPECT_EQ(JobPlan::relativeTo("/libraryX/Kick.wav", "/library"), "/libraryX/Kick.wav");
+    EXPECT_EQ(plan.sourcePath(plan.jobs[1]), "/library/Pack One/Snare.wav");
+
+    // Executed on a machine that mounts things elsewhere
+    plan.sourceDir = "/Volumes/Library";
+    plan.outputDir = "/Volumes/M8/Samples";
+    EXPECT_EQ(plan.sourcePath(plan.jobs[1]), "/Volumes/Library/Pack One/Snare.wav");
+    EXPECT_EQ(plan.outputPath(plan.jobs[1]), "/Volumes/M8/Samples/Pack-One/Snare.wav");
+
+    plan.sortLongestFirst();
+    EXPECT_EQ(plan.jobs[0].source, "Pack One/Snare.wav");
+}
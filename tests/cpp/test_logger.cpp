@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+#include "Logger.h"
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+class LoggerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        logPath = std::filesystem::temp_directory_path() / "m8_logger_test.log";
+        std::filesystem::remove(logPath);
+
+        Logger& logger = Logger::getInstance();
+        logger.setConsoleOutput(false);
+        logger.setLogFile(logPath.string());
+    }
+
+    void TearDown() override {
+        Logger& logger = Logger::getInstance();
+        logger.disableAsync();
+        logger.setLogFile("");
+        logger.setConsoleOutput(true);
+        std::filesystem::remove(logPath);
+    }
+
+    std::vector<std::string> readLines() {
+        std::vector<std::string> lines;
+        std::ifstream file(logPath);
+        std::string line;
+        while (std::getline(file, line)) {
+            lines.push_back(line);
+        }
+        return lines;
+    }
+
+    std::filesystem::path logPath;
+};
+
+TEST_F(LoggerTest, SyncWritesFormattedLine) {
+    Logger::getInstance().warning("hello");
+    auto lines = readLines();
+    ASSERT_EQ(lines.size(), 1u);
+    EXPECT_NE(lines[0].find(" [WARN] hello"), std::string::npos);
+    // "YYYY-MM-DD HH:MM:SS.mmm"
+    EXPECT_EQ(lines[0].find(' '), 10u);
+    EXPECT_EQ(lines[0][19], '.');
+}
+
+TEST_F(LoggerTest, AsyncKeepsPerThreadOrderAcrossProducers) {
+    Logger& logger = Logger::getInstance();
+    logger.enableAsync(64, Logger::BLOCK);  // Small ring so producers hit the full path
+
+    const int threads = 4;
+    const int perThread = 2000;
+    std::vector<std::thread> producers;
+    for (int t = 0; t < threads; t++) {
+        producers.emplace_back([&logger, t] {
+            for (int i = 0; i < perThread; i++) {
+                logger.info("t" + std::to_string(t) + " " + std::to_string(i));
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    logger.flush();
+
+    auto lines = readLines();
+    ASSERT_EQ(lines.size(), static_cast<size_t>(threads * perThread));
+
+    std::vector<int> next(threads, 0);
+    for (const auto& line : lines) {
+        size_t pos = line.find("[INFO] t");
+        ASSERT_NE(pos, std::string::npos);
+        int t = std::stoi(line.substr(pos + 8));
+        int i = std::stoi(line.substr(line.find(' ', pos + 8) + 1));
+        EXPECT_EQ(i, next[t]);
+        next[t] = i + 1;
+    }
+    EXPECT_EQ(logger.getDroppedCount(), 0u);
+}
+
+TEST_F(LoggerTest, DisableAsyncDrainsPendingMessages) {
+    Logger& logger = Logger::getInstance();
+    logger.enableAsync();
+    for (int i = 0; i < 500; i++) {
+        logger.error("message " + std::to_string(i));
+    }
+    logger.disableAsync();
+
+    EXPECT_EQ(readLines().size(), 500u);
+    EXPECT_FALSE(logger.isAsync());
+}
+
+TEST_F(LoggerTest, CountPolicyReportsDroppedMessages) {
+    Logger& logger = Logger::getInstance();
+    size_t droppedBefore = logger.getDroppedCount();
+    logger.enableAsync(2, Logger::COUNT);
+
+    for (int i = 0; i < 10000; i++) {
+        logger.info("burst " + std::to_string(i));
+    }
+    logger.flush();
+    logger.disableAsync();
+
+    size_t dropped = logger.getDroppedCount() - droppedBefore;
+    auto lines = readLines();
+    size_t kept = 0;
+    bool reported = false;
+    for (const auto& line : lines) {
+        if (line.find("[INFO] burst") != std::string::npos) kept++;
+        if (line.find("Logger dropped") != std::string::npos) reported = true;
+    }
+    EXPECT_EQ(kept + dropped, 10000u);
+    if (dropped > 0) {
+        EXPECT_TRUE(reported);
+    }
+}
@@ -2,6 +2,7 @@
 #include <iostream>
 #include <filesystem>
 #include <fstream>
+#include <cmath>
 
 // Test fixture for setting up test environment
 class M8SampleFormatterTest : public ::testing::Test {
@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+#include "OutputNameRegistry.h"
+#include "PathManager.h"
+#include <algorithm>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(OutputNameRegistryTest, FirstClaimKeepsTheName) {
+    OutputNameRegistry registry;
+    EXPECT_EQ(registry.claim("/out/Pack/Kick.wav", "/src/a/Kick.wav"), "/out/Pack/Kick.wav");
+
+    // Same source again: same name, not a collision
+    EXPECT_EQ(registry.claim("/out/Pack/Kick.wav", "/src/a/Kick.wav"), "/out/Pack/Kick.wav");
+    EXPECT_EQ(registry.getCollisions(), 0u);
+
+    // Another source is suffixed, and the suffix follows the source, not the order
+    std::string second = registry.claim("/out/Pack/Kick.wav", "/src/b/Kick.wav");
+    EXPECT_NE(second, "/out/Pack/Kick.wav");
+    EXPECT_EQ(second.rfind("/out/Pack/Kick-", 0), 0u);
+    EXPECT_EQ(second.size(), std::string("/out/Pack/Kick-0000.wav").size());
+    EXPECT_EQ(registry.claim("/out/Pack/Kick.wav", "/src/b/Kick.wav"), second);
+
+    OutputNameRegistry other;
+    other.claim("/out/Pack/Kick.wav", "/src/c/Kick.wav");
+    EXPECT_EQ(other.claim("/out/Pack/Kick.wav", "/src/b/Kick.wav"), second);
+}
+
+TEST(OutputNameRegistryTest, NamesDifferingOnlyInCaseCollide) {
+    OutputNameRegistry registry;
+    registry.claim("/out/Kick.wav", "/src/Kick.wav");
+    EXPECT_NE(registry.claim("/out/KICK.wav", "/src/KICK.wav"), "/out/KICK.wav");
+    EXPECT_EQ(registry.getCollisions(), 1u);
+}
+
+TEST(OutputNameRegistryTest, SettleHandsContestedNamesToTheFirstSourceInOrder) {
+    // Claimed in reverse order, as a streaming scan might
+    OutputNameRegistry streamed;
+    streamed.claim("/out/Kick.wav", "c/Kick.wav");
+    std::string bSuffixed = streamed.claim("/out/Kick.wav", "b/Kick.wav");
+    std::string aSuffixed = streamed.claim("/out/KICK.wav", "a/KICK.wav");
+    streamed.claim("/out/Snare.wav", "a/Snare.wav");
+    streamed.claim("/out/Snare.wav", "b/Snare.wav");
+    streamed.claim("/out/Hat.wav", "z/Hat.wav", true);  // From an earlier run
+    streamed.claim("/out/Hat.wav", "a/Hat.wav");
+
+    std::vector<OutputNameRegistry::Handover> handovers = streamed.settle();
+    ASSERT_EQ(handovers.size(), 1u);
+    const OutputNameRegistry::Handover& handover = handovers[0];
+    EXPECT_EQ(handover.path, "/out/Kick.wav");
+    EXPECT_EQ(handover.holder, "c/Kick.wav");
+    EXPECT_EQ(handover.winner, "a/KICK.wav");
+    EXPECT_EQ(handover.winnerPath, aSuffixed);
+    EXPECT_EQ(handover.winnerWants, "/out/KICK.wav");
+    EXPECT_TRUE(streamed.settle().empty());
+
+    // Every source ends up where sorted claims put it
+    OutputNameRegistry sorted;
+    EXPECT_EQ(sorted.claim("/out/KICK.wav", "a/KICK.wav"), "/out/KICK.wav");
+    EXPECT_EQ(sorted.claim("/out/Kick.wav", "b/Kick.wav"), bSuffixed);
+    EXPECT_EQ(sorted.claim("/out/Kick.wav", "c/Kick.wav"), handover.holderPath);
+    EXPECT_EQ(streamed.claim("/out/KICK.wav", "a/KICK.wav"), "/out/KICK.wav");
+    EXPECT_EQ(streamed.claim("/out/Kick.wav", "c/Kick.wav"), handover.holderPath);
+    EXPECT_EQ(streamed.size(), sorted.size() + 4);  // The Snare and Hat pairs; a left no suffixed name behind
+    EXPECT_EQ(streamed.getCollisions(), 4u);
+}
+
+TEST(OutputNameRegistryTest, SuffixKeepsFilenameWithinLimit) {
+    std::string longName = "/out/" + std::string(PathManager::MAX_PATH_LENGTH - 4, 'a') + ".wav";
+    std::string suffixed = OutputNameRegistry::withSuffix(longName, "beef", PathManager::MAX_PATH_LENGTH);
+    std::string filename = suffixed.substr(5);
+    EXPECT_EQ(filename.size(), PathManager::MAX_PATH_LENGTH);
+    EXPECT_EQ(filename.substr(filename.size() - 9), "-beef.wav");
+
+    EXPECT_EQ(OutputNameRegistry::withSuffix("/out.d/noext", "beef", 128), "/out.d/noext-beef");
+}
+
+TEST(OutputNameRegistryTest, ConcurrentCollidingClaimsStayUnique) {
+    // 4000 sources over 40 output names, claimed from 16 threads, each source claimed twice
+    constexpr size_t kSources = 4000;
+    constexpr size_t kNames = 40;
+    constexpr size_t kThreads = 16;
+
+    OutputNameRegistry registry;
+    std::vector<std::string> first(kSources);
+    std::vector<std::string> second(kSources);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < kThreads; t++) {
+        threads.emplace_back([&, t] {
+            for (size_t pass = 0; pass < 2; pass++) {
+                for (size_t i = t; i < kSources; i += kThreads) {
+                    std::string output = "/out/Name" + std::to_string(i % kNames) + ".wav";
+                    std::string claimed = registry.claim(output, "/src/" + std::to_string(i) + ".wav");
+                    (pass == 0 ? first : second)[i] = claimed;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(first, second);
+    std::set<std::string> unique(first.begin(), first.end());
+    EXPECT_EQ(unique.size(), kSources);
+    EXPECT_EQ(registry.size(), kSources);
+    EXPECT_EQ(registry.getCollisions(), kSources - kNames);
+    for (size_t name = 0; name < kNames; name++) {
+        EXPECT_EQ(unique.count("/out/Name" + std::to_string(name) + ".wav"), 1u);
+    }
+}
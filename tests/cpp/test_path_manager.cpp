@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 #include "PathManager.h"
 #include <filesystem>
+#include <thread>
+#include <vector>
 
 class PathManagerTest : public ::testing::Test {
 protected:
@@ -352,3 +354,84 @@ TEST_F(PathManagerTest, SubstringMatchingRemovesDuplicates) {
     EXPECT_TRUE(filename.find("Ghosthack") == std::string::npos);
     EXPECT_TRUE(filename.find("Kick") != std::string::npos || filename.find("01") != std::string::npos);
 }
+
+TEST_F(PathManagerTest, AppliesWordRulesExactly) {
+    // Pinned outputs for the edges of each rule
+    std::filesystem::path sourcePath = testDir / "Vintage Drums (2023) [WAV]";
+    std::filesystem::create_directories(sourcePath / "Loops");
+    std::string expectedFolder = (outputDir / "Vintage-Drms" / "Lps").string() + "/";
+
+    auto generate = [&](const std::string& filename) {
+        return pathManager->generateOutputPath((sourcePath / "Loops" / filename).string(), sourcePath.string(),
+                                               outputDir.string());
+    };
+
+    // A '.' ends an abbreviated word but does not start one; "One-Shots" spans a hyphen
+    EXPECT_EQ(generate("Drum.Loop One-Shots.wav"), expectedFolder + "Drm.Loop-OS.wav");
+    EXPECT_EQ(generate("Bass Loop.Texture.wav"), expectedFolder + "Bs-Lp.Texture.wav");
+    // Abbreviations are case-sensitive
+    EXPECT_EQ(generate("bass Melodies.wav"), expectedFolder + "bass-Mels.wav");
+    // Acronyms are 2-4 capitals/digits and only dropped when more words follow
+    EXPECT_EQ(generate("ESE_Kick_One-Shot.wav"), expectedFolder + "Kick-OS.wav");
+    EXPECT_EQ(generate("ABCDE_Kick.wav"), expectedFolder + "ABCDE-Kick.wav");
+    EXPECT_EQ(generate("HL.wav"), expectedFolder + "HL.wav");
+}
+
+TEST_F(PathManagerTest, CachesFolderWorkPerDirectory) {
+    std::filesystem::path sourcePath = testDir / "Pack";
+    std::filesystem::create_directories(sourcePath / "Kicks");
+
+    std::string first = pathManager->generateOutputPath((sourcePath / "Kicks" / "Hard Kick.wav").string(),
+                                                        sourcePath.string(), outputDir.string());
+    std::string second = pathManager->generateOutputPath((sourcePath / "Kicks" / "Soft Kick.wav").string(),
+                                                         sourcePath.string(), outputDir.string());
+    EXPECT_EQ(pathManager->getFolderCacheMisses(), 1u);
+    EXPECT_EQ(pathManager->getFolderCacheHits(), 1u);
+    EXPECT_EQ(std::filesystem::path(first).parent_path(), std::filesystem::path(second).parent_path());
+
+    // Flattened folders and other output roots are cached separately
+    pathManager->generateFlattenedOutputPath((sourcePath / "Kicks" / "Hard Kick.wav").string(), sourcePath.string(),
+                                             outputDir.string());
+    pathManager->generateOutputPath((sourcePath / "Kicks" / "Hard Kick.wav").string(), sourcePath.string(),
+                                    (testDir / "other").string());
+    EXPECT_EQ(pathManager->getFolderCacheMisses(), 3u);
+
+    pathManager->clearFolderCache();
+    EXPECT_EQ(pathManager->generateOutputPath((sourcePath / "Kicks" / "Hard Kick.wav").string(), sourcePath.string(),
+                                              outputDir.string()), first);
+    EXPECT_EQ(pathManager->getFolderCacheMisses(), 4u);
+}
+
+TEST_F(PathManagerTest, CachedPathsMatchAcrossThreads) {
+    std::filesystem::path sourcePath = testDir / "Pack";
+    std::vector<std::string> inputs;
+    for (int d = 0; d < 10; d++) {
+        for (int f = 0; f < 50; f++) {
+            inputs.push_back((sourcePath / ("Folder " + std::to_string(d)) / ("Loop " + std::to_string(f) + ".wav")).string());
+        }
+    }
+
+    PathManager reference;
+    std::vector<std::string> expected;
+    for (const auto& input : inputs) {
+        expected.push_back(reference.generateOutputPath(input, sourcePath.string(), outputDir.string()));
+    }
+
+    std::vector<std::string> results(inputs.size());
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < 8; t++) {
+        threads.emplace_back([&, t] {
+            for (size_t i = t; i < inputs.size(); i += 8) {
+                results[i] = pathManager->generateOutputPath(inputs[i], sourcePath.string(), outputDir.string());
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(results, expected);
+    EXPECT_EQ(pathManager->getFolderCacheHits() + pathManager->getFolderCacheMisses(), inputs.size());
+    EXPECT_GE(pathManager->getFolderCacheMisses(), 10u);
+    EXPECT_LT(pathManager->getFolderCacheMisses(), 10u * 8);
+}
@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include "Resampler.h"
+#include <cmath>
+#include <vector>
+
+namespace {
+std::vector<float> sine(double frequency, int rate, size_t frames, float amplitude = 0.5f) {
+    std::vector<float> samples(frames);
+    for (size_t i = 0; i < frames; i++) {
+        samples[i] = amplitude * static_cast<float>(std::sin(2.0 * M_PI * frequency * i / rate));
+    }
+    return samples;
+}
+
+std::vector<float> resample(const std::vector<float>& input, int inputRate, int outputRate) {
+    Resampler resampler(inputRate, outputRate, 1);
+    std::vector<float> output;
+    resampler.process(input.data(), input.size(), output);
+    resampler.flush(output);
+    return output;
+}
+
+// Amplitude of a known-frequency sine, fitted away from the edges
+double amplitudeAt(const std::vector<float>& samples, double frequency, int rate, size_t margin) {
+    double in = 0.0, quad = 0.0;
+    size_t count = 0;
+    for (size_t i = margin; i + margin < samples.size(); i++) {
+        double phase = 2.0 * M_PI * frequency * i / rate;
+        in += samples[i] * std::sin(phase);
+        quad += samples[i] * std::cos(phase);
+        count++;
+    }
+    return 2.0 * std::sqrt(in * in + quad * quad) / count;
+}
+
+double rms(const std::vector<float>& samples, size_t margin) {
+    double sum = 0.0;
+    size_t count = 0;
+    for (size_t i = margin; i + margin < samples.size(); i++) {
+        sum += static_cast<double>(samples[i]) * samples[i];
+        count++;
+    }
+    return std::sqrt(sum / count);
+}
+}
+
+TEST(ResamplerTest, OutputLengthFollowsRatio) {
+    EXPECT_EQ(Resampler::outputFrames(96000, 96000, 44100), 44100u);
+    EXPECT_EQ(Resampler::outputFrames(1, 48000, 44100), 1u);
+    EXPECT_EQ(Resampler::outputFrames(1000, 48000, 44100), 919u);  // ceil(918.75)
+
+    for (int rate : {48000, 88200, 96000, 192000}) {
+        SCOPED_TRACE(rate);
+        auto output = resample(sine(1000.0, rate, 12345), rate, 44100);
+        EXPECT_EQ(output.size(), Resampler::outputFrames(12345, rate, 44100));
+    }
+}
+
+TEST(ResamplerTest, PassbandIsFlat) {
+    for (int rate : {48000, 96000, 192000}) {
+        for (double frequency : {100.0, 1000.0, 10000.0, 19000.0}) {
+            SCOPED_TRACE(std::to_string(rate) + " Hz source, " + std::to_string(frequency) + " Hz tone");
+            auto output = resample(sine(frequency, rate, rate / 2), rate, 44100);
+            double gainDb = 20.0 * std::log10(amplitudeAt(output, frequency, 44100, 500) / 0.5);
+            EXPECT_NEAR(gainDb, 0.0, 0.05);
+        }
+    }
+}
+
+TEST(ResamplerTest, RejectsContentAboveOutputNyquist) {
+    // Would alias to 14.1, 3.5 and 19.6 kHz without filtering
+    for (double frequency : {30000.0, 40600.0, 68500.0}) {
+        SCOPED_TRACE(frequency);
+        auto output = resample(sine(frequency, 192000, 96000), 192000, 44100);
+        double levelDb = 20.0 * std::log10(rms(output, 500) / (0.5 / std::sqrt(2.0)));
+        EXPECT_LT(levelDb, -80.0);
+    }
+}
+
+TEST(ResamplerTest, StreamingMatchesOneShot) {
+    const int channels = 2;
+    std::vector<float> input(20000 * channels);
+    for (size_t i = 0; i < input.size(); i++) {
+        input[i] = std::sin(0.001 * i * i) * 0.8f;
+    }
+
+    Resampler oneShot(96000, 44100, channels);
+    std::vector<float> expected;
+    oneShot.process(input.data(), input.size() / channels, expected);
+    oneShot.flush(expected);
+
+    // Irregular blocks, including empty ones
+    Resampler streaming(96000, 44100, channels);
+    std::vector<float> output;
+    size_t frame = 0;
+    for (size_t block = 0; frame < input.size() / channels; block = (block * 7 + 13) % 1500) {
+        size_t frames = std::min(block, input.size() / channels - frame);
+        streaming.process(input.data() + frame * channels, frames, output);
+        frame += frames;
+    }
+    streaming.flush(output);
+
+    ASSERT_EQ(output.size(), expected.size());
+    EXPECT_EQ(output, expected);
+}
@@ -0,0 +1,344 @@
+#include <gtest/gtest.h>
+#include "M8SampleFormatter.h"
+#include <sndfile.h>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <set>
+#include <thread>
+#include <vector>
+
+class SampleFormatterTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        testDir = std::filesystem::temp_directory_path() / "m8_formatter_test";
+        std::filesystem::remove_all(testDir);
+
+        for (int pack = 0; pack < 4; pack++) {
+            for (int i = 0; i < 10; i++) {
+                auto dir = testDir / "source" / ("Pack" + std::to_string(pack)) / ("Kit" + std::to_string(i % 3));
+                std::filesystem::create_directories(dir);
+                createWavFile(dir / ("Hit " + std::to_string(i) + ".wav"));
+            }
+        }
+    }
+
+    void TearDown() override {
+        if (std::filesystem::exists(testDir)) {
+            std::filesystem::remove_all(testDir);
+        }
+    }
+
+    void createWavFile(const std::filesystem::path& path, float level = 0.1f) {
+        SF_INFO info;
+        info.samplerate = 44100;
+        info.channels = 2;
+        info.format = SF_FORMAT_WAV | SF_FORMAT_PCM_24;
+
+        SNDFILE* file = sf_open(path.string().c_str(), SFM_WRITE, &info);
+        std::vector<float> samples(2000, level);
+        sf_writef_float(file, samples.data(), 1000);
+        sf_close(file);
+    }
+
+    std::set<std::string> outputsIn(const std::filesystem::path& dir) {
+        std::set<std::string> outputs;
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(dir)) {
+            if (entry.path().extension() == ".wav") {
+                outputs.insert(std::filesystem::relative(entry.path(), dir).string());
+            }
+        }
+        return outputs;
+    }
+
+    // For a watching formatter on another thread to have written at least expected outputs
+    bool waitForOutputs(const std::filesystem::path& dir, size_t expected) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (std::chrono::steady_clock::now() < deadline) {
+            if (std::filesystem::exists(dir) && outputsIn(dir).size() >= expected) {
+                return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return false;
+    }
+
+    std::filesystem::path testDir;
+};
+
+TEST_F(SampleFormatterTest, StreamingScanMatchesBatchScan) {
+    M8SampleFormatter::ProcessingOptions streaming;
+    streaming.incremental = false;
+    M8SampleFormatter::ProcessingOptions batch = streaming;
+    batch.streamScan = false;
+
+    M8SampleFormatter streamingFormatter;
+    ASSERT_TRUE(streamingFormatter.processDirectory((testDir / "source").string(), (testDir / "streamed").string(), streaming));
+    M8SampleFormatter batchFormatter;
+    ASSERT_TRUE(batchFormatter.processDirectory((testDir / "source").string(), (testDir / "batch").string(), batch));
+
+    const auto& stats = streamingFormatter.getStats();
+    EXPECT_EQ(stats.totalFiles, 40u);
+    EXPECT_EQ(stats.processedFiles, 40u);
+    EXPECT_EQ(stats.errorFiles, 0u);
+    EXPECT_GT(stats.timeToFirstOutput, 0.0);
+    EXPECT_LE(stats.timeToFirstOutput, stats.processingTime);
+    EXPECT_LE(stats.scanTime, stats.processingTime);
+
+    EXPECT_EQ(batchFormatter.getStats().processedFiles, 40u);
+
+    // The four packs shorten to the same names; a streaming run settles them the way the batch run
+    // claimed them, in sorted order
+    EXPECT_EQ(outputsIn(testDir / "streamed").size(), 40u);
+    EXPECT_EQ(outputsIn(testDir / "streamed"), outputsIn(testDir / "batch"));
+}
+
+TEST_F(SampleFormatterTest, EmptySourceFails) {
+    std::filesystem::create_directories(testDir / "empty");
+    M8SampleFormatter formatter;
+    EXPECT_FALSE(formatter.processDirectory((testDir / "empty").string(), (testDir / "out").string(), {}));
+}
+
+TEST_F(SampleFormatterTest, CollidingNamesGetDistinctOutputs) {
+    // The first three all shorten to Kick-A.wav, one file on the M8's case-insensitive card
+    auto source = testDir / "colliding";
+    std::filesystem::create_directories(source / "Drums");
+    createWavFile(source / "Drums" / "Kick A.wav");
+    createWavFile(source / "Drums" / "Kick_A.wav");
+    createWavFile(source / "Drums" / "kick a.wav");
+    createWavFile(source / "Drums" / "Snare.wav");
+
+    M8SampleFormatter::ProcessingOptions options;
+    M8SampleFormatter formatter;
+    ASSERT_TRUE(formatter.processDirectory(source.string(), (testDir / "out").string(), options));
+    EXPECT_EQ(formatter.getStats().processedFiles, 4u);
+    EXPECT_EQ(formatter.getStats().renamedFiles, 2u);
+
+    std::set<std::string> folded;
+    for (std::string output : outputsIn(testDir / "out")) {
+        std::transform(output.begin(), output.end(), output.begin(), ::tolower);
+        folded.insert(output);
+    }
+    EXPECT_EQ(folded.size(), 4u);
+
+    // A re-run keeps every source on the name it was given
+    M8SampleFormatter rerun;
+    ASSERT_TRUE(rerun.processDirectory(source.string(), (testDir / "out").string(), options));
+    EXPECT_EQ(rerun.getStats().skippedFiles, 4u);
+    EXPECT_EQ(rerun.getStats().renamedFiles, 0u);
+    EXPECT_EQ(outputsIn(testDir / "out").size(), 4u);
+}
+
+TEST_F(SampleFormatterTest, SkippedDuplicatesStaySkippedOnIncrementalRuns) {
+    auto source = testDir / "dupes";
+    std::filesystem::create_directories(source / "A");
+    std::filesystem::create_directories(source / "B");
+    createWavFile(source / "A" / "Kick.wav");
+    createWavFile(source / "B" / "Snare.wav");  // Same audio under another name
+
+    M8SampleFormatter::ProcessingOptions options;
+    options.dedup = ConversionPipeline::DedupMode::SKIP;
+    options.streamScan = false;  // Planned in path order and read by one thread: Kick.wav is the primary
+    options.readerThreads = 1;
+    M8SampleFormatter formatter;
+    ASSERT_TRUE(formatter.processDirectory(source.string(), (testDir / "out").string(), options));
+    EXPECT_EQ(formatter.getStats().processedFiles, 1u);
+    EXPECT_EQ(formatter.getStats().duplicateFiles, 1u);
+    EXPECT_EQ(outputsIn(testDir / "out"), std::set<std::string>{"dupes/A/Kick.wav"});
+
+    // The primary is unchanged and not converted again, but the copy is still recognized
+    M8SampleFormatter rerun;
+    ASSERT_TRUE(rerun.processDirectory(source.string(), (testDir / "out").string(), options));
+    EXPECT_EQ(rerun.getStats().skippedFiles, 1u);
+    EXPECT_EQ(rerun.getStats().processedFiles, 0u);
+    EXPECT_EQ(rerun.getStats().duplicateFiles, 1u);
+    EXPECT_EQ(outputsIn(testDir / "out"), std::set<std::string>{"dupes/A/Kick.wav"});
+}
+
+TEST_F(SampleFormatterTest, DryRunWritesNothing) {
+    M8SampleFormatter::ProcessingOptions options;
+    options.dryRun = true;
+    M8SampleFormatter formatter;
+    ASSERT_TRUE(formatter.processDirectory((testDir / "source").string(), (testDir / "out").string(), options));
+    EXPECT_EQ(formatter.getStats().totalFiles, 40u);
+    EXPECT_EQ(formatter.getStats().processedFiles, 0u);
+    EXPECT_FALSE(std::filesystem::exists(testDir / "out"));
+}
+
+TEST_F(SampleFormatterTest, SavedPlanExecutesLikeProcessDirectory) {
+    // A bigger file that should be planned first
+    auto big = testDir / "source" / "Pack0" / "Big.wav";
+    {
+        SF_INFO info{};
+        info.samplerate = 44100;
+        info.channels = 2;
+        info.format = SF_FORMAT_WAV | SF_FORMAT_PCM_24;
+        SNDFILE* file = sf_open(big.string().c_str(), SFM_WRITE, &info);
+        std::vector<float> samples(20000, 0.2f);
+        sf_writef_float(file, samples.data(), 10000);
+        sf_close(file);
+    }
+
+    M8SampleFormatter::ProcessingOptions options;
+    M8SampleFormatter planner;
+    JobPlan plan;
+    ASSERT_TRUE(planner.planDirectory((testDir / "source").string(), (testDir / "planned").string(), options, plan));
+    ASSERT_EQ(plan.jobs.size(), 41u);
+    EXPECT_EQ(plan.jobs[0].source, "Pack0/Big.wav");
+    EXPECT_EQ(plan.jobs[0].estimatedBytes, 44u + 10000u * 2 * 2);
+    EXPECT_EQ(plan.jobs[1].estimatedBytes, 44u + 1000u * 2 * 2);
+    EXPECT_EQ(plan.pendingJobs(), 41u);
+    EXPECT_FALSE(std::filesystem::exists(testDir / "planned"));
+
+    // Move the library (output names include its folder name, so keep that) and
+    // execute the saved plan against the new location
+    std::string planPath = (testDir / "library.m8plan").string();
+    ASSERT_TRUE(plan.save(planPath));
+    auto moved = testDir / "mounted" / "source";
+    std::filesystem::create_directories(moved.parent_path());
+    std::filesystem::rename(testDir / "source", moved);
+    JobPlan loaded;
+    ASSERT_TRUE(loaded.load(planPath));
+    loaded.sourceDir = moved.string();
+
+    M8SampleFormatter executor;
+    ASSERT_TRUE(executor.executePlan(loaded, options));
+    EXPECT_EQ(executor.getStats().processedFiles, 41u);
+    EXPECT_EQ(executor.getStats().errorFiles, 0u);
+    EXPECT_EQ(outputsIn(testDir / "planned").size(), 41u);
+
+    // The index it left behind lets a normal run from the new location skip everything
+    M8SampleFormatter rerun;
+    ASSERT_TRUE(rerun.processDirectory(moved.string(), (testDir / "planned").string(), options));
+    EXPECT_EQ(rerun.getStats().skippedFiles, 41u);
+
+    // Plans are tied to the options they were made with
+    options.targetBitDepth = 8;
+    EXPECT_FALSE(executor.executePlan(loaded, options));
+}
+
+TEST_F(SampleFormatterTest, ProfileTimesEveryStageOfEveryFile) {
+    M8SampleFormatter::ProcessingOptions options;
+    options.profilePath = (testDir / "profile.json").string();
+    M8SampleFormatter formatter;
+    ASSERT_TRUE(formatter.processDirectory((testDir / "source").string(), (testDir / "out").string(), options));
+    ASSERT_EQ(formatter.getStats().processedFiles, 40u);
+    EXPECT_FALSE(StageProfiler::getInstance().isEnabled());
+
+    std::ifstream file(options.profilePath);
+    std::string profile((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    EXPECT_NE(profile.find("\"processed\": 40,"), std::string::npos);
+    // One sample per file for the per-file stages, at least one per directory for the scan
+    for (const char* stage : {"\"probe\", \"kind\": \"io\"", "\"path\", \"kind\": \"cpu\"",
+                              "\"decode\", \"kind\": \"mixed\"", "\"transform\", \"kind\": \"cpu\"",
+                              "\"encode\", \"kind\": \"mixed\"", "\"close\", \"kind\": \"io\"",
+                              "\"mkdir\", \"kind\": \"io\""}) {
+        EXPECT_NE(profile.find(std::string("{\"name\": ") + stage + ", \"count\": 40,"), std::string::npos) << stage;
+    }
+    EXPECT_NE(profile.find("{\"name\": \"scan\""), std::string::npos);
+    EXPECT_NE(profile.find("\"busy_seconds\": {\"io\": "), std::string::npos);
+
+    // Off unless asked for
+    std::filesystem::remove(options.profilePath);
+    options.profilePath.clear();
+    options.incremental = false;
+    M8SampleFormatter plain;
+    ASSERT_TRUE(plain.processDirectory((testDir / "source").string(), (testDir / "out").string(), options));
+    EXPECT_FALSE(std::filesystem::exists(testDir / "profile.json"));
+    EXPECT_TRUE(StageProfiler::getInstance().summarize().empty());
+}
+
+TEST_F(SampleFormatterTest, TraceShowsEveryWorker) {
+    M8SampleFormatter::ProcessingOptions options;
+    options.tracePath = (testDir / "trace.json").string();
+    options.readerThreads = 2;
+    options.transformThreads = 1;
+    M8SampleFormatter formatter;
+    ASSERT_TRUE(formatter.processDirectory((testDir / "source").string(), (testDir / "out").string(), options));
+    ASSERT_EQ(formatter.getStats().processedFiles, 40u);
+    EXPECT_FALSE(TraceRecorder::getInstance().isEnabled());
+
+    std::ifstream file(options.tracePath);
+    std::string trace((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    auto count = [&trace](const std::string& needle) {
+        size_t found = 0;
+        for (size_t pos = trace.find(needle); pos != std::string::npos; pos = trace.find(needle, pos + 1)) {
+            found++;
+        }
+        return found;
+    };
+
+    // Every file is read once, on a named worker track
+    EXPECT_EQ(count("\"name\": \"read\", \"cat\": \"pipeline\""), 40u);
+    EXPECT_EQ(count("\"name\": \"plan\", \"cat\": \"plan\""), 40u);
+    EXPECT_GE(count("\"name\": \"transform\", \"cat\": \"pipeline\""), 40u);
+    EXPECT_GE(count("\"name\": \"write\", \"cat\": \"pipeline\""), 40u);
+    for (const char* track : {"main", "scan 0", "read 0", "read 1", "transform 0", "write 0"}) {
+        EXPECT_NE(trace.find(std::string("\"args\": {\"name\": \"") + track + "\"}"), std::string::npos) << track;
+    }
+}
+
+TEST_F(SampleFormatterTest, WatchConvertsDroppedFiles) {
+    if (!DirectoryWatcher::isSupported()) {
+        GTEST_SKIP() << "No inotify on this platform";
+    }
+    auto output = testDir / "out";
+    M8SampleFormatter::ProcessingOptions options;
+    options.watchDebounceMs = 50;
+    M8SampleFormatter formatter;
+    DirectoryWatcher watcher;
+    bool watched = false;
+    std::thread daemon([&] { watched = formatter.watchDirectory((testDir / "source").string(), output.string(), options, watcher); });
+
+    // The library is converted first, then a sample dropped into a new folder follows on its own
+    ASSERT_TRUE(waitForOutputs(output, 40));
+    std::filesystem::create_directories(testDir / "source" / "Pack4" / "Kit0");
+    createWavFile(testDir / "source" / "Pack4" / "Kit0" / "Dropped.wav");
+    bool converted = waitForOutputs(output, 41);
+
+    watcher.stop();
+    daemon.join();
+    ASSERT_TRUE(converted);
+    EXPECT_TRUE(watched);
+
+    ConversionIndex index;
+    ASSERT_TRUE(index.load((output / ConversionIndex::DEFAULT_FILENAME).string()));
+    EXPECT_EQ(index.size(), 41u);
+}
+
+TEST_F(SampleFormatterTest, WatchSkipsCopiesOfSamplesConvertedBeforeIt) {
+    if (!DirectoryWatcher::isSupported()) {
+        GTEST_SKIP() << "No inotify on this platform";
+    }
+    auto output = testDir / "out";
+    M8SampleFormatter::ProcessingOptions options;
+    options.watchDebounceMs = 50;
+    options.dedup = ConversionPipeline::DedupMode::SKIP;
+    M8SampleFormatter formatter;
+    DirectoryWatcher watcher;
+    std::thread daemon([&] { formatter.watchDirectory((testDir / "source").string(), output.string(), options, watcher); });
+
+    // The 40 library samples are one sound, converted once by the catch-up run. Another copy of it
+    // is dropped in, then a new sound, whose output means the copy has been handled too
+    ASSERT_TRUE(waitForOutputs(output, 1));
+    std::filesystem::create_directories(testDir / "source" / "Pack4");
+    createWavFile(testDir / "source" / "Pack4" / "Copy.wav");
+    createWavFile(testDir / "source" / "Pack4" / "New.wav", 0.2f);
+    bool converted = waitForOutputs(output, 2);
+
+    watcher.stop();
+    daemon.join();
+    ASSERT_TRUE(converted);
+    EXPECT_EQ(outputsIn(output).size(), 2u);
+
+    ConversionIndex index;
+    ASSERT_TRUE(index.load((output / ConversionIndex::DEFAULT_FILENAME).string()));
+    std::set<std::string> sources;
+    for (const auto& entry : index.entries()) {
+        sources.insert(std::filesystem::path(entry.sourcePath).filename().string());
+    }
+    EXPECT_EQ(sources.count("New.wav"), 1u);
+    EXPECT_EQ(sources.count("Copy.wav"), 0u);
+}
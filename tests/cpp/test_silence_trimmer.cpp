@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+#include "SilenceTrimmer.h"
+#include "AudioProcessor.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+// Stereo: lead frames of low-level noise, body frames of signal, tail frames of noise
+std::vector<float> paddedSignal(size_t lead, size_t body, size_t tail) {
+    std::vector<float> samples((lead + body + tail) * 2);
+    for (size_t i = 0; i < lead + body + tail; i++) {
+        bool inBody = i >= lead && i < lead + body;
+        float noise = 0.0005f * std::sin(static_cast<float>(i) * 1.7f);  // About -66 dBFS
+        samples[i * 2] = inBody ? 0.5f * std::sin(static_cast<float>(i) * 0.05f) + 0.1f : noise;
+        samples[i * 2 + 1] = inBody ? 0.0f : -noise;
+    }
+    return samples;
+}
+}
+
+TEST(SilenceTrimmerTest, ScansFindAudibleEdges) {
+    const float threshold = SilenceTrimmer<float>::dbToLinear(-60.0f);
+    std::vector<float> samples = paddedSignal(1000, 777, 1500);
+    // Only the right channel crosses at the very edges
+    samples[1000 * 2] = 0.0f;
+    samples[1000 * 2 + 1] = 0.2f;
+
+    EXPECT_EQ(SilenceTrimmer<float>::firstAudibleFrame(samples.data(), 3277, 2, threshold), 1000u);
+    EXPECT_EQ(SilenceTrimmer<float>::audibleEnd(samples.data(), 3277, 2, threshold), 1777u);
+
+    std::vector<float> silence(4000, 0.0f);
+    EXPECT_EQ(SilenceTrimmer<float>::firstAudibleFrame(silence.data(), 2000, 2, threshold), 2000u);
+    EXPECT_EQ(SilenceTrimmer<float>::audibleEnd(silence.data(), 2000, 2, threshold), 0u);
+}
+
+TEST(SilenceTrimmerTest, StreamingMatchesWholeBuffer) {
+    std::vector<float> samples = paddedSignal(3000, 5000, 4000);
+    const size_t frames = samples.size() / 2;
+
+    for (size_t fade : {0u, 64u}) {
+        SilenceTrimmer<float> whole(2, -60.0f, fade);
+        std::vector<float> expected;
+        whole.process(samples.data(), frames, expected);
+        whole.flush(expected);
+        ASSERT_EQ(expected.size(), 5000u * 2);
+        EXPECT_EQ(whole.getInputFrames(), frames);
+        EXPECT_EQ(whole.getOutputFrames(), 5000u);
+
+        // Odd block sizes, including blocks that are entirely silent
+        for (size_t block : {1u, 333u, 1024u}) {
+            SilenceTrimmer<float> streaming(2, -60.0f, fade);
+            std::vector<float> output;
+            for (size_t start = 0; start < frames; start += block) {
+                streaming.process(samples.data() + start * 2, std::min(block, frames - start), output);
+            }
+            streaming.flush(output);
+            EXPECT_EQ(output, expected) << "block " << block << ", fade " << fade;
+        }
+    }
+}
+
+TEST(SilenceTrimmerTest, LongQuietStretchesAreNotHeld) {
+    // Two hits 5000 frames apart, then 3000 frames of tail, through a trimmer holding at most 2000
+    std::vector<float> first = paddedSignal(500, 1000, 5000);
+    std::vector<float> second = paddedSignal(0, 1000, 3000);
+    std::vector<float> samples = first;
+    samples.insert(samples.end(), second.begin(), second.end());
+    const size_t frames = samples.size() / 2;
+
+    SilenceTrimmer<float> trimmer(2, -60.0f, 0, 2000);
+    std::vector<float> output;
+    size_t mostHeld = 0;
+    for (size_t start = 0; start < frames; start += 256) {
+        trimmer.process(samples.data() + start * 2, std::min<size_t>(256, frames - start), output);
+        mostHeld = std::max(mostHeld, trimmer.getHeldFrames());
+    }
+    trimmer.flush(output);
+    EXPECT_LE(mostHeld, 2000u);
+    EXPECT_EQ(trimmer.getHeldFrames(), 0u);
+
+    // The gap between the hits comes through untouched; of the tail, what follows the last
+    // full stretch is still trimmed
+    ASSERT_GE(output.size(), 7000u * 2);
+    EXPECT_TRUE(std::equal(output.begin(), output.begin() + 7000 * 2, samples.begin() + 500 * 2));
+    EXPECT_LT(output.size(), (frames - 500) * 2);
+}
+
+TEST(SilenceTrimmerTest, FadesEdgesOfKeptAudio) {
+    std::vector<float> samples(200 * 2, 0.5f);
+    SilenceTrimmer<float> trimmer(2, -60.0f, 10);
+    std::vector<float> output;
+    trimmer.process(samples.data(), 200, output);
+    trimmer.flush(output);
+    ASSERT_EQ(output.size(), 400u);
+
+    EXPECT_FLOAT_EQ(output[0], 0.0f);
+    EXPECT_FLOAT_EQ(output[5 * 2 + 1], 0.25f);
+    EXPECT_FLOAT_EQ(output[100 * 2], 0.5f);
+    EXPECT_FLOAT_EQ(output[199 * 2], 0.05f);
+}
+
+TEST(SilenceTrimmerTest, AudioProcessorTrimsBuffers) {
+    AudioProcessor processor;
+    std::vector<float> samples = paddedSignal(500, 1000, 700);
+    EXPECT_EQ(processor.trimSilence(samples, 2, -60.0f), 1200u);
+    EXPECT_EQ(samples.size(), 2000u);
+
+    // Nothing left when the whole buffer is below the threshold
+    std::vector<float> quiet = paddedSignal(500, 0, 500);
+    EXPECT_EQ(processor.trimSilence(quiet, 2, -60.0f), 1000u);
+    EXPECT_TRUE(quiet.empty());
+
+    // A threshold above the signal's floor keeps everything
+    std::vector<float> loud(1000, 0.3f);
+    EXPECT_EQ(processor.trimSilence(loud, 1, -60.0f), 0u);
+    EXPECT_EQ(loud.size(), 1000u);
+}
+
+TEST(SilenceTrimmerTest, Int16MatchesFloat) {
+    std::vector<float> samples = paddedSignal(2000, 3000, 2500);
+    std::vector<short> pcm(samples.size());
+    for (size_t i = 0; i < samples.size(); i++) {
+        pcm[i] = static_cast<short>(std::lrintf(samples[i] * 32768.0f));
+    }
+    const size_t frames = samples.size() / 2;
+
+    SilenceTrimmer<short> trimmer(2, -60.0f);
+    std::vector<short> output;
+    for (size_t start = 0; start < frames; start += 1000) {
+        trimmer.process(pcm.data() + start * 2, std::min<size_t>(1000, frames - start), output);
+    }
+    trimmer.flush(output);
+
+    // Same edges as the float scan, and the kept samples untouched
+    ASSERT_EQ(output.size(), 3000u * 2);
+    EXPECT_TRUE(std::equal(output.begin(), output.end(), pcm.begin() + 2000 * 2));
+}
@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+#include "SimdKernels.h"
+#include <cmath>
+#include <random>
+#include <vector>
+
+class SimdKernelsTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        std::mt19937 rng(1234);
+        // Slightly beyond full scale so clipping paths are exercised
+        std::uniform_real_distribution<float> dist(-1.2f, 1.2f);
+        input.resize(kCount);
+        for (float& sample : input) {
+            sample = dist(rng);
+        }
+        // Exact rounding ties and extremes
+        input[0] = 0.5f / 32767.0f;
+        input[1] = -1.5f / 32767.0f;
+        input[2] = 1.0f;
+        input[3] = -1.0f;
+        input[4] = 100.0f;
+        input[5] = -100.0f;
+    }
+
+    // Odd length so every kernel runs its scalar tail
+    static constexpr size_t kCount = 4099 * 2 + 1;
+    std::vector<float> input;
+    const SimdKernels* scalar = SimdKernels::forIsa(SimdKernels::SCALAR);
+};
+
+TEST_F(SimdKernelsTest, ScalarAlwaysAvailable) {
+    auto isas = SimdKernels::availableIsas();
+    ASSERT_FALSE(isas.empty());
+    EXPECT_EQ(isas.front(), SimdKernels::SCALAR);
+    EXPECT_NE(SimdKernels::forIsa(isas.back()), nullptr);
+    EXPECT_NE(SimdKernels::get().name, nullptr);
+}
+
+TEST_F(SimdKernelsTest, EveryIsaMatchesScalar) {
+    size_t frames = kCount / 2;
+
+    std::vector<float> expectedMono(frames), expectedGain(kCount), expectedClamp(kCount);
+    std::vector<int16_t> expected16(kCount);
+    std::vector<int32_t> expected24(kCount);
+    scalar->downmixStereo(input.data(), expectedMono.data(), frames);
+    scalar->applyGain(input.data(), expectedGain.data(), kCount, 0.7f);
+    scalar->clamp(input.data(), expectedClamp.data(), kCount, -1.0f, 1.0f);
+    scalar->floatToInt16(input.data(), expected16.data(), kCount);
+    scalar->floatToInt24(input.data(), expected24.data(), kCount);
+
+    EXPECT_EQ(expected16[0], 0);  // Ties round to even like lrintf
+    EXPECT_EQ(expected16[1], -2);
+    EXPECT_EQ(expected16[2], 32767);
+    EXPECT_EQ(expected16[3], -32767);
+    EXPECT_EQ(expected16[4], 32767);
+    EXPECT_EQ(expected16[5], -32768);
+    EXPECT_EQ(expected24[4], 8388607);
+    EXPECT_EQ(expected24[5], -8388608);
+
+    for (SimdKernels::Isa isa : SimdKernels::availableIsas()) {
+        const SimdKernels* kernels = SimdKernels::forIsa(isa);
+        SCOPED_TRACE(kernels->name);
+
+        std::vector<float> mono(frames), gain(kCount), clamped(kCount);
+        std::vector<int16_t> pcm16(kCount);
+        std::vector<int32_t> pcm24(kCount);
+        kernels->downmixStereo(input.data(), mono.data(), frames);
+        kernels->applyGain(input.data(), gain.data(), kCount, 0.7f);
+        kernels->clamp(input.data(), clamped.data(), kCount, -1.0f, 1.0f);
+        kernels->floatToInt16(input.data(), pcm16.data(), kCount);
+        kernels->floatToInt24(input.data(), pcm24.data(), kCount);
+
+        EXPECT_EQ(mono, expectedMono);
+        EXPECT_EQ(gain, expectedGain);
+        EXPECT_EQ(clamped, expectedClamp);
+        EXPECT_EQ(pcm16, expected16);
+        EXPECT_EQ(pcm24, expected24);
+        EXPECT_EQ(kernels->peak(input.data(), kCount), 100.0f);
+        EXPECT_EQ(kernels->peakInt16(expected16.data(), kCount), 32768);
+        EXPECT_EQ(kernels->peakInt16(expected16.data() + 6, kCount - 6), scalar->peakInt16(expected16.data() + 6, kCount - 6));
+
+        // Summation order differs per ISA
+        double sum = scalar->sumSquares(input.data(), kCount);
+        EXPECT_NEAR(kernels->sumSquares(input.data(), kCount), sum, sum * 1e-5);
+        float dot = scalar->dotProduct(input.data(), input.data() + 1, kCount - 1);
+        EXPECT_NEAR(kernels->dotProduct(input.data(), input.data() + 1, kCount - 1), dot, sum * 1e-5);
+    }
+}
+
+TEST_F(SimdKernelsTest, HandlesEmptyAndShortInputs) {
+    for (SimdKernels::Isa isa : SimdKernels::availableIsas()) {
+        const SimdKernels* kernels = SimdKernels::forIsa(isa);
+        SCOPED_TRACE(kernels->name);
+
+        EXPECT_EQ(kernels->peak(input.data(), 0), 0.0f);
+        EXPECT_EQ(kernels->peakInt16(nullptr, 0), 0);
+        EXPECT_EQ(kernels->sumSquares(input.data(), 0), 0.0);
+
+        for (size_t count = 1; count < 20; count++) {
+            std::vector<int16_t> pcm(count), expected(count);
+            kernels->floatToInt16(input.data(), pcm.data(), count);
+            scalar->floatToInt16(input.data(), expected.data(), count);
+            EXPECT_EQ(pcm, expected);
+        }
+    }
+}
+
+TEST_F(SimdKernelsTest, TpdfDitherIsIdenticalAcrossIsas) {
+    uint32_t seed[SimdKernels::DITHER_LANES] = {1, 2, 3, 4, 5, 6, 7, 8};
+
+    // Two calls with an odd split so the lane bookkeeping across tails is exercised
+    const size_t split = 1001;
+    auto run = [&](const SimdKernels* kernels, std::vector<uint32_t>& rng) {
+        std::vector<int16_t> pcm(kCount);
+        rng.assign(seed, seed + SimdKernels::DITHER_LANES);
+        kernels->floatToInt16Tpdf(input.data(), pcm.data(), split, rng.data());
+        kernels->floatToInt16Tpdf(input.data() + split, pcm.data() + split, kCount - split, rng.data());
+        return pcm;
+    };
+
+    std::vector<uint32_t> expectedRng;
+    std::vector<int16_t> expected = run(scalar, expectedRng);
+    EXPECT_EQ(expected[4], 32767);
+    EXPECT_EQ(expected[5], -32768);
+
+    for (SimdKernels::Isa isa : SimdKernels::availableIsas()) {
+        const SimdKernels* kernels = SimdKernels::forIsa(isa);
+        SCOPED_TRACE(kernels->name);
+
+        std::vector<uint32_t> rng;
+        std::vector<int16_t> pcm = run(kernels, rng);
+        EXPECT_EQ(rng, expectedRng);
+        for (size_t i = 0; i < kCount; i++) {
+            // A fused multiply-add in the scalar path may round a tie the other way
+            ASSERT_LE(std::abs(pcm[i] - expected[i]), 1) << "sample " << i;
+        }
+    }
+}
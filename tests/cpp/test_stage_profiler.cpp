@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+#include "StageProfiler.h"
+#include <thread>
+#include <vector>
+
+namespace {
+// The profiler is process-wide; every test starts from an empty, enabled one and leaves it off
+class StageProfilerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        profiler.reset();
+        profiler.setEnabled(true);
+    }
+    void TearDown() override {
+        profiler.setEnabled(false);
+        profiler.reset();
+    }
+
+    const StageProfiler::Summary* find(const std::vector<StageProfiler::Summary>& summaries, StageProfiler::Stage stage) {
+        for (const auto& summary : summaries) {
+            if (summary.stage == stage) {
+                return &summary;
+            }
+        }
+        return nullptr;
+    }
+
+    StageProfiler& profiler = StageProfiler::getInstance();
+};
+}
+
+TEST_F(StageProfilerTest, BucketsBoundTheirValues) {
+    size_t previous = 0;
+    for (uint64_t value : {0ull, 1ull, 15ull, 16ull, 17ull, 31ull, 32ull, 33ull, 1000ull, 123456789ull, 1ull << 40}) {
+        size_t bucket = StageProfiler::bucketOf(value);
+        EXPECT_GE(bucket, previous);
+        EXPECT_LT(bucket, StageProfiler::BUCKET_COUNT);
+        EXPECT_GE(StageProfiler::bucketUpperBound(bucket), value);
+        // Within one sub-bucket (1/16 of the power of two) of the value
+        EXPECT_LE(StageProfiler::bucketUpperBound(bucket) - value, value / 16);
+        previous = bucket;
+    }
+    EXPECT_EQ(StageProfiler::bucketOf(~0ull), StageProfiler::BUCKET_COUNT - 1);
+}
+
+TEST_F(StageProfilerTest, PercentilesOfUniformSamples) {
+    // 1..1000 microseconds
+    for (uint64_t micros = 1; micros <= 1000; micros++) {
+        profiler.record(StageProfiler::DECODE, micros * 1000);
+    }
+
+    auto summaries = profiler.summarize();
+    ASSERT_EQ(summaries.size(), 1u);
+    const StageProfiler::Summary& decode = summaries[0];
+    EXPECT_EQ(decode.stage, StageProfiler::DECODE);
+    EXPECT_EQ(decode.count, 1000u);
+    EXPECT_EQ(decode.totalNanos, 500500u * 1000u);
+    EXPECT_EQ(decode.maxNanos, 1000000u);
+    EXPECT_NEAR(decode.p50Nanos / 1e3, 500.0, 500 * 0.07);
+    EXPECT_NEAR(decode.p95Nanos / 1e3, 950.0, 950 * 0.07);
+    EXPECT_NEAR(decode.p99Nanos / 1e3, 990.0, 990 * 0.07);
+    EXPECT_LE(decode.p99Nanos, decode.maxNanos);
+}
+
+TEST_F(StageProfilerTest, MergesEveryThreadsSamples) {
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; t++) {
+        threads.emplace_back([this, t] {
+            for (int i = 0; i < 1000; i++) {
+                profiler.record(StageProfiler::ENCODE, static_cast<uint64_t>(100 + t));
+            }
+            profiler.record(StageProfiler::CLOSE, 5000);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    auto summaries = profiler.summarize();
+    const auto* encode = find(summaries, StageProfiler::ENCODE);
+    const auto* close = find(summaries, StageProfiler::CLOSE);
+    ASSERT_NE(encode, nullptr);
+    ASSERT_NE(close, nullptr);
+    EXPECT_EQ(encode->count, 8000u);
+    EXPECT_EQ(encode->maxNanos, 107u);
+    EXPECT_EQ(close->count, 8u);
+
+    // Blocks of exited threads are reused rather than piling up, and keep their samples
+    std::thread later([this] { profiler.record(StageProfiler::CLOSE, 5000); });
+    later.join();
+    EXPECT_EQ(find(profiler.summarize(), StageProfiler::CLOSE)->count, 9u);
+}
+
+TEST_F(StageProfilerTest, DisabledRecordsNothing) {
+    profiler.setEnabled(false);
+    profiler.record(StageProfiler::SCAN, 100);
+    uint64_t total = 0;
+    {
+        StageProfiler::Timer timer(total);
+        StageProfiler::Timer sample(StageProfiler::PATH);
+    }
+    EXPECT_EQ(total, 0u);
+    EXPECT_TRUE(profiler.summarize().empty());
+
+    profiler.setEnabled(true);
+    {
+        StageProfiler::Timer timer(total);
+        StageProfiler::Timer sample(StageProfiler::PATH);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    EXPECT_GE(total, 2000000u);
+    auto summaries = profiler.summarize();
+    ASSERT_EQ(summaries.size(), 1u);
+    EXPECT_EQ(summaries[0].stage, StageProfiler::PATH);
+    EXPECT_GE(summaries[0].maxNanos, 2000000u);
+
+    profiler.reset();
+    EXPECT_TRUE(profiler.summarize().empty());
+}
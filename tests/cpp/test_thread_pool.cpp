@@ -0,0 +1,200 @@
+#include <gtest/gtest.h>
+#include "ThreadPool.h"
+#include "WorkStealingDeque.h"
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+class ThreadPoolTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        pool = std::make_unique<ThreadPool>(4);
+    }
+
+    std::unique_ptr<ThreadPool> pool;
+};
+
+TEST_F(ThreadPoolTest, EnqueueReturnsResult) {
+    auto future = pool->enqueue([](int a, int b) { return a + b; }, 2, 3);
+    EXPECT_EQ(future.get(), 5);
+}
+
+TEST_F(ThreadPoolTest, RunsEveryTaskExactlyOnce) {
+    const int taskCount = 20000;
+    std::vector<std::atomic<int>> runs(taskCount);
+    std::vector<std::future<void>> futures;
+
+    for (int i = 0; i < taskCount; ++i) {
+        futures.push_back(pool->enqueue([&runs, i]() { runs[i]++; }));
+    }
+    for (auto& future : futures) {
+        future.get();
+    }
+
+    for (int i = 0; i < taskCount; ++i) {
+        EXPECT_EQ(runs[i].load(), 1) << "task " << i;
+    }
+}
+
+TEST_F(ThreadPoolTest, WaitForAllBlocksUntilIdle) {
+    std::atomic<int> completed{0};
+    for (int i = 0; i < 100; ++i) {
+        pool->enqueue([&completed]() {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            completed++;
+        });
+    }
+
+    pool->waitForAll();
+
+    EXPECT_EQ(completed.load(), 100);
+    EXPECT_EQ(pool->getQueueSize(), 0);
+    EXPECT_EQ(pool->getActiveThreads(), 0);
+}
+
+TEST_F(ThreadPoolTest, NestedEnqueueFromWorker) {
+    std::atomic<int> completed{0};
+
+    for (int i = 0; i < 50; ++i) {
+        pool->enqueue([this, &completed]() {
+            for (int j = 0; j < 10; ++j) {
+                pool->enqueue([&completed]() { completed++; });
+            }
+            completed++;
+        });
+    }
+
+    pool->waitForAll();
+    EXPECT_EQ(completed.load(), 50 * 11);
+}
+
+TEST_F(ThreadPoolTest, IdleWorkersStealQueuedWork) {
+    // External submissions are spread across worker inboxes; idle workers
+    // must pick them up rather than leaving one worker to run everything
+    std::set<std::thread::id> threadIds;
+    std::mutex idsMutex;
+
+    for (int i = 0; i < 400; ++i) {
+        pool->enqueue([&threadIds, &idsMutex]() {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            std::lock_guard<std::mutex> lock(idsMutex);
+            threadIds.insert(std::this_thread::get_id());
+        });
+    }
+
+    pool->waitForAll();
+    EXPECT_GT(threadIds.size(), 1u);
+}
+
+TEST_F(ThreadPoolTest, ShutdownDrainsQueuedTasks) {
+    std::atomic<int> completed{0};
+    for (int i = 0; i < 1000; ++i) {
+        pool->enqueue([&completed]() { completed++; });
+    }
+
+    pool->shutdown();
+
+    EXPECT_EQ(completed.load(), 1000);
+    EXPECT_THROW(pool->enqueue([]() {}), std::runtime_error);
+}
+
+TEST(ThreadPoolPriorityTest, PrioritizedTasksRunHighestFirst) {
+    ThreadPool pool(1);
+
+    // Hold the only worker so every prioritized task is queued before any runs
+    std::promise<void> started;
+    std::promise<void> release;
+    std::shared_future<void> gate = release.get_future().share();
+    pool.enqueue([&started, gate] {
+        started.set_value();
+        gate.wait();
+    });
+    started.get_future().wait();
+
+    std::mutex orderMutex;
+    std::vector<int> order;
+    for (int task : {3, 9, 1, 7, 5, 7}) {
+        pool.enqueuePrioritized(task, [&, task] {
+            std::lock_guard<std::mutex> lock(orderMutex);
+            order.push_back(task);
+        });
+    }
+    // Equal priorities keep submission order
+    pool.enqueuePrioritized(7, [&] {
+        std::lock_guard<std::mutex> lock(orderMutex);
+        order.push_back(70);
+    });
+
+    release.set_value();
+    pool.waitForAll();
+    EXPECT_EQ(order, (std::vector<int>{9, 7, 7, 70, 5, 3, 1}));
+}
+
+TEST(WorkStealingDequeTest, OwnerPopsLifoThievesStealFifo) {
+    WorkStealingDeque deque(2);  // Forces the buffer to grow
+    std::vector<PoolTask*> tasks;
+    for (int i = 0; i < 10; ++i) {
+        tasks.push_back(new PoolTask{});
+        deque.push(tasks.back());
+    }
+
+    EXPECT_EQ(deque.size(), 10u);
+    EXPECT_EQ(deque.steal(), tasks.front());
+    EXPECT_EQ(deque.pop(), tasks.back());
+    EXPECT_EQ(deque.size(), 8u);
+
+    delete tasks.front();
+    delete tasks.back();
+}
+
+TEST(WorkStealingDequeTest, ConcurrentStealersSeeEachTaskOnce) {
+    WorkStealingDeque deque;
+    const int taskCount = 100000;
+    std::atomic<int> taken{0};
+    std::vector<std::atomic<int>> seen(taskCount);
+    std::atomic<bool> done{false};
+
+    auto consume = [&](PoolTask* task) {
+        seen[reinterpret_cast<intptr_t>(task->next)]++;
+        delete task;
+        taken++;
+    };
+
+    std::vector<std::thread> thieves;
+    for (int t = 0; t < 3; ++t) {
+        thieves.emplace_back([&]() {
+            while (!done || !deque.empty()) {
+                if (PoolTask* task = deque.steal()) {
+                    consume(task);
+                }
+            }
+        });
+    }
+
+    for (int i = 0; i < taskCount; ++i) {
+        // Stash the index in the link field; the deque never touches it
+        deque.push(new PoolTask{{}, reinterpret_cast<PoolTask*>(static_cast<intptr_t>(i))});
+        if (i % 3 == 0) {
+            if (PoolTask* task = deque.pop()) {
+                consume(task);
+            }
+        }
+    }
+    done = true;
+
+    for (auto& thief : thieves) {
+        thief.join();
+    }
+    while (PoolTask* task = deque.pop()) {
+        consume(task);
+    }
+
+    EXPECT_EQ(taken.load(), taskCount);
+    for (int i = 0; i < taskCount; ++i) {
+        ASSERT_EQ(seen[i].load(), 1) << "task " << i;
+    }
+}
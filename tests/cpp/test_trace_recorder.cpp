@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include "TraceRecorder.h"
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+// The recorder is process-wide; every test starts a fresh, enabled trace and leaves tracing off
+class TraceRecorderTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        tracePath = (std::filesystem::temp_directory_path() / "m8_trace_test.json").string();
+        tracer.reset();
+        tracer.setEnabled(true);
+    }
+    void TearDown() override {
+        tracer.setEnabled(false);
+        tracer.reset();
+        std::filesystem::remove(tracePath);
+    }
+
+    std::string writeTrace() {
+        EXPECT_TRUE(tracer.write(tracePath));
+        std::ifstream file(tracePath);
+        return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    }
+
+    static size_t count(const std::string& text, const std::string& needle) {
+        size_t found = 0;
+        for (size_t pos = text.find(needle); pos != std::string::npos; pos = text.find(needle, pos + 1)) {
+            found++;
+        }
+        return found;
+    }
+
+    TraceRecorder& tracer = TraceRecorder::getInstance();
+    std::string tracePath;
+};
+}
+
+TEST_F(TraceRecorderTest, WritesEveryThreadsSpans) {
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([this, t] {
+            tracer.setThreadName("worker " + std::to_string(t));
+            std::string file = "Kit/\"Kick\" " + std::to_string(t) + ".wav";
+            for (int i = 0; i < 100; i++) {
+                TraceRecorder::Span span("decode", "pipeline", file, 4096);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(tracer.getEventCount(), 400u);
+
+    std::string trace = writeTrace();
+    EXPECT_EQ(trace.rfind("{\"traceEvents\": [", 0), 0u);
+    EXPECT_EQ(count(trace, "\"ph\": \"X\", \"name\": \"decode\", \"cat\": \"pipeline\""), 400u);
+    EXPECT_EQ(count(trace, "\"name\": \"thread_name\""), 4u);
+    for (int t = 0; t < 4; t++) {
+        EXPECT_NE(trace.find("\"args\": {\"name\": \"worker " + std::to_string(t) + "\"}"), std::string::npos);
+    }
+    EXPECT_EQ(count(trace, "\"args\": {\"file\": \"Kit/\\\"Kick\\\" 0.wav\", \"bytes\": 4096}"), 100u);
+    EXPECT_NE(trace.find("\"droppedEvents\": 0}}"), std::string::npos);
+}
+
+TEST_F(TraceRecorderTest, ResetStartsANewTrace) {
+    tracer.record("old", "test", TraceRecorder::now(), 10);
+    std::thread([this] { tracer.record("old", "test", TraceRecorder::now(), 10); }).join();
+    EXPECT_EQ(tracer.getEventCount(), 2u);
+
+    tracer.reset();
+    EXPECT_EQ(tracer.getEventCount(), 0u);
+
+    // Both the surviving thread and a new one (reusing the exited thread's buffer) record afresh
+    tracer.record("new", "test", TraceRecorder::now(), 1500);
+    std::thread([this] { tracer.record("new", "test", TraceRecorder::now(), 10); }).join();
+    std::string trace = writeTrace();
+    EXPECT_EQ(count(trace, "\"name\": \"old\""), 0u);
+    EXPECT_EQ(count(trace, "\"name\": \"new\""), 2u);
+    EXPECT_NE(trace.find("\"dur\": 1.500"), std::string::npos);
+}
+
+TEST_F(TraceRecorderTest, DisabledSpansRecordNothing) {
+    tracer.setEnabled(false);
+    {
+        TraceRecorder::Span span("ignored", "test");
+    }
+    tracer.record("ignored", "test", 0, 1);
+    EXPECT_EQ(tracer.getEventCount(), 0u);
+
+    std::string trace = writeTrace();
+    EXPECT_EQ(count(trace, "\"ph\""), 0u);
+}
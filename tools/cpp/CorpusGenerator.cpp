@@ -0,0 +1,287 @@
+#include "CorpusGenerator.h"
+#include "Logger.h"
+#include <sndfile.h>
+#include <algorithm>
+#include <filesystem>
+#include <system_error>
+
+namespace {
+// splitmix64: tiny, and the same sequence everywhere (std distributions differ between libraries)
+struct Random {
+    uint64_t state;
+
+    Random(uint32_t seed, size_t index)
+        : state((static_cast<uint64_t>(seed) << 32) ^ (static_cast<uint64_t>(index) * 0x9E3779B97F4A7C15ull)) {}
+
+    uint64_t next() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+    double unit() { return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0); }
+    size_t below(size_t limit) { return static_cast<size_t>(next() % limit); }
+    double between(double low, double high) { return low + (high - low) * unit(); }
+
+    template <typename T>
+    T pick(const std::vector<std::pair<T, double>>& weighted) {
+        double total = 0.0;
+        for (const auto& entry : weighted) total += entry.second;
+        double target = unit() * total;
+        for (const auto& entry : weighted) {
+            if (target < entry.second) return entry.first;
+            target -= entry.second;
+        }
+        return weighted.back().first;
+    }
+};
+
+template <typename T>
+bool validWeights(const std::vector<std::pair<T, double>>& weighted) {
+    double total = 0.0;
+    for (const auto& entry : weighted) {
+        if (entry.second < 0.0) return false;
+        total += entry.second;
+    }
+    return total > 0.0;
+}
+
+const char* const kFolders[] = {"Drums",  "Kicks", "Snares", "Hats",   "Percussion", "Loops",
+                                "FX",     "Bass",  "Melodic", "Vocals", "One Shots",  "Textures"};
+const char* const kWords[] = {"Kick", "Snare", "Hat", "Clap", "Perc", "Tom", "Ride", "Crash",
+                              "Bass", "Lead", "Pad",  "Chord", "Vox", "Riser", "Impact", "Noise"};
+// Precomposed and multi-byte UTF-8: accents, Cyrillic, Greek, CJK, Hangul and an emoji
+const char* const kUnicodeWords[] = {"Café Kick",  "Über Snare", "Ударные", "Μπάσο",
+                                     "キック",     "스네어",     "鼓 Loop",  "Fünf 🥁"};
+
+size_t formatIndex(CorpusGenerator::Format format) {
+    return static_cast<size_t>(format);
+}
+
+int sndfileFormat(CorpusGenerator::Format format) {
+    switch (format) {
+        case CorpusGenerator::Format::WAV_16:
+            return SF_FORMAT_WAV | SF_FORMAT_PCM_16;
+        case CorpusGenerator::Format::WAV_24:
+            return SF_FORMAT_WAV | SF_FORMAT_PCM_24;
+        case CorpusGenerator::Format::WAV_FLOAT:
+            return SF_FORMAT_WAV | SF_FORMAT_FLOAT;
+        case CorpusGenerator::Format::AIFF_16:
+            return SF_FORMAT_AIFF | SF_FORMAT_PCM_16;
+        case CorpusGenerator::Format::AIFF_24:
+            return SF_FORMAT_AIFF | SF_FORMAT_PCM_24;
+        case CorpusGenerator::Format::FLAC_16:
+            return SF_FORMAT_FLAC | SF_FORMAT_PCM_16;
+        case CorpusGenerator::Format::FLAC_24:
+            return SF_FORMAT_FLAC | SF_FORMAT_PCM_24;
+        case CorpusGenerator::Format::OGG_VORBIS:
+            return SF_FORMAT_OGG | SF_FORMAT_VORBIS;
+    }
+    return 0;
+}
+
+const char* extension(CorpusGenerator::Format format) {
+    switch (format) {
+        case CorpusGenerator::Format::AIFF_16:
+        case CorpusGenerator::Format::AIFF_24:
+            return ".aif";
+        case CorpusGenerator::Format::FLAC_16:
+        case CorpusGenerator::Format::FLAC_24:
+            return ".flac";
+        case CorpusGenerator::Format::OGG_VORBIS:
+            return ".ogg";
+        default:
+            return ".wav";
+    }
+}
+
+// The WAV with the same resolution, for formats this libsndfile cannot encode
+CorpusGenerator::Format fallback(CorpusGenerator::Format format) {
+    return format == CorpusGenerator::Format::FLAC_24 ? CorpusGenerator::Format::WAV_24
+                                                      : CorpusGenerator::Format::WAV_16;
+}
+
+std::string fileStem(Random& random, size_t index, double longNameFraction, double unicodeNameFraction) {
+    double style = random.unit();
+    std::string number = " " + std::to_string(index);
+    if (style < longNameFraction) {
+        // Close to NAME_MAX (255 bytes) once the number and extension are on
+        std::string name;
+        while (name.size() < 230) {
+            name += std::string(kWords[random.below(16)]) + " ";
+        }
+        name.resize(230);
+        return name + number;
+    }
+    if (style < longNameFraction + unicodeNameFraction) {
+        return kUnicodeWords[random.below(8)] + number;
+    }
+    return kWords[random.below(16)] + number;
+}
+
+// Decaying tone plus noise between optional silent edges. Only +, - and * on floats,
+// so the samples do not depend on the platform's libm
+void synthesize(Random& random, size_t frames, int channels, int sampleRate, bool padded, std::vector<float>& samples) {
+    samples.assign(frames * channels, 0.0f);
+    size_t silent = padded ? frames / 8 : 0;
+    float step = static_cast<float>(55.0 * (1 + random.below(24)) / sampleRate);
+    float noise = static_cast<float>(random.between(0.0, 0.3));
+    uint32_t noiseState = static_cast<uint32_t>(random.next());
+
+    float phase = 0.0f;
+    for (size_t frame = silent; frame < frames - silent; ++frame) {
+        float envelope = 1.0f - static_cast<float>(frame - silent) / static_cast<float>(frames - 2 * silent);
+        float x = 2.0f * phase - 1.0f;  // Parabolic approximation of a sine over one period
+        float tone = 4.0f * x * (1.0f - (x < 0.0f ? -x : x));
+        phase += step;
+        if (phase >= 1.0f) phase -= 1.0f;
+        for (int channel = 0; channel < channels; ++channel) {
+            noiseState = noiseState * 1664525u + 1013904223u;
+            float white = static_cast<float>(noiseState >> 8) / 16777216.0f - 0.5f;
+            samples[frame * channels + channel] = envelope * (0.7f * tone + noise * white);
+        }
+    }
+}
+}
+
+CorpusGenerator::CorpusGenerator(Config config) : m_config(std::move(config)) {}
+
+bool CorpusGenerator::isAvailable(Format format) {
+    SF_INFO info = {};
+    info.samplerate = 44100;
+    info.channels = 2;
+    info.format = sndfileFormat(format);
+    return sf_format_check(&info) != 0;
+}
+
+const char* CorpusGenerator::formatName(Format format) {
+    switch (format) {
+        case Format::WAV_16:
+            return "wav16";
+        case Format::WAV_24:
+            return "wav24";
+        case Format::WAV_FLOAT:
+            return "wav32f";
+        case Format::AIFF_16:
+            return "aiff16";
+        case Format::AIFF_24:
+            return "aiff24";
+        case Format::FLAC_16:
+            return "flac16";
+        case Format::FLAC_24:
+            return "flac24";
+        case Format::OGG_VORBIS:
+            return "ogg";
+    }
+    return "unknown";
+}
+
+bool CorpusGenerator::parseFormat(const std::string& name, Format& format) {
+    for (size_t index = 0; index < FORMAT_COUNT; index++) {
+        Format candidate = static_cast<Format>(index);
+        if (name == formatName(candidate)) {
+            format = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool CorpusGenerator::generate(const std::string& root, Result& result) const {
+    Logger& logger = Logger::getInstance();
+    const Config& config = m_config;
+    if (!validWeights(config.formats) || !validWeights(config.sampleRates) || !validWeights(config.channels) ||
+        config.packs == 0 || config.minDepth > config.maxDepth || config.oneShotMinSeconds <= 0.0 ||
+        config.oneShotMinSeconds > config.oneShotMaxSeconds || config.loopMinSeconds <= 0.0 ||
+        config.loopMinSeconds > config.loopMaxSeconds) {
+        logger.error("Invalid corpus configuration");
+        return false;
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(root, ec);
+    if (ec) {
+        logger.error("Cannot create corpus directory: " + root + " (" + ec.message() + ")");
+        return false;
+    }
+
+    bool available[FORMAT_COUNT];
+    for (size_t index = 0; index < FORMAT_COUNT; index++) {
+        available[index] = isAvailable(static_cast<Format>(index));
+    }
+
+    result = Result();
+    result.perFormat.assign(FORMAT_COUNT, 0);
+    std::vector<std::filesystem::path> written(config.files);  // Empty where a file failed
+    std::vector<float> samples;
+
+    for (size_t index = 0; index < config.files; index++) {
+        // Every draw happens whatever the outcome, so each file depends on (seed, index) alone
+        Random random(config.seed, index);
+        std::filesystem::path dir = std::filesystem::path(root) /
+                                    ("Pack " + std::to_string(random.below(config.packs) + 1));
+        size_t depth = config.minDepth + random.below(config.maxDepth - config.minDepth + 1);
+        for (size_t level = 0; level < depth; level++) {
+            dir /= kFolders[random.below(12)];
+        }
+        std::string stem = fileStem(random, index, config.longNameFraction, config.unicodeNameFraction);
+        bool duplicate = index > 0 && random.unit() < config.duplicateFraction;
+        size_t original = index > 0 ? random.below(index) : 0;
+        Format format = random.pick(config.formats);
+        int sampleRate = random.pick(config.sampleRates);
+        int channels = random.pick(config.channels);
+        bool loop = random.unit() < config.loopFraction;
+        double seconds = loop ? random.between(config.loopMinSeconds, config.loopMaxSeconds)
+                              : random.between(config.oneShotMinSeconds, config.oneShotMaxSeconds);
+        bool padded = random.unit() < config.silenceFraction;
+
+        std::filesystem::create_directories(dir, ec);
+        std::filesystem::path path;
+        if (duplicate && !written[original].empty()) {
+            path = dir / (stem + written[original].extension().string());
+            if (!std::filesystem::copy_file(written[original], path, std::filesystem::copy_options::overwrite_existing,
+                                            ec)) {
+                logger.error("Failed to copy " + written[original].string() + " to " + path.string());
+                result.failed++;
+                continue;
+            }
+            result.duplicates++;
+        } else {
+            Format writtenAs = available[formatIndex(format)] ? format : fallback(format);
+            if (writtenAs != format) {
+                result.substituted++;
+            }
+            path = dir / (stem + extension(writtenAs));
+
+            size_t frames = std::max<size_t>(1, static_cast<size_t>(seconds * sampleRate));
+            synthesize(random, frames, channels, sampleRate, padded, samples);
+
+            SF_INFO info = {};
+            info.samplerate = sampleRate;
+            info.channels = channels;
+            info.format = sndfileFormat(writtenAs);
+            SNDFILE* file = sf_open(path.string().c_str(), SFM_WRITE, &info);
+            if (!file) {
+                logger.error("Failed to create " + path.string() + ": " + sf_strerror(nullptr));
+                result.failed++;
+                continue;
+            }
+            sf_count_t frameCount = static_cast<sf_count_t>(frames);
+            bool complete = sf_writef_float(file, samples.data(), frameCount) == frameCount;
+            sf_close(file);
+            if (!complete) {
+                logger.error("Failed to write " + path.string());
+                std::filesystem::remove(path, ec);
+                result.failed++;
+                continue;
+            }
+            result.perFormat[formatIndex(format)]++;
+        }
+
+        written[index] = path;
+        result.files++;
+        result.bytes += std::filesystem::file_size(path, ec);
+    }
+
+    return result.failed == 0;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Builds a synthetic sample library for performance and scaling tests: packs of
+// nested folders holding one-shots and loops in a mix of formats, rates and
+// channel counts, with some leading/trailing silence, duplicated sources and
+// pathological (very long, non-ASCII) names.
+//
+// Output is a pure function of the Config: every file draws from its own
+// generator seeded with (seed, index), so the same config gives the same files
+// on any machine (byte-identical except where a codec's encoder differs between
+// versions), and growing `files` keeps the existing ones unchanged.
+// Formats the installed libsndfile cannot write (FLAC and Ogg need optional
+// codecs) are written as WAV instead and counted as substituted.
+class CorpusGenerator {
+public:
+    enum class Format { WAV_16, WAV_24, WAV_FLOAT, AIFF_16, AIFF_24, FLAC_16, FLAC_24, OGG_VORBIS };
+
+    struct Config {
+        uint32_t seed = 1;
+        size_t files = 100;
+        size_t packs = 8;
+
+        // Relative weights; an empty list or zero weights are rejected
+        std::vector<std::pair<Format, double>> formats = {
+            {Format::WAV_16, 3.0}, {Format::WAV_24, 3.0}, {Format::WAV_FLOAT, 1.0}, {Format::AIFF_16, 1.0},
+            {Format::AIFF_24, 1.0}, {Format::FLAC_16, 1.0}, {Format::FLAC_24, 1.0}, {Format::OGG_VORBIS, 1.0}};
+        std::vector<std::pair<int, double>> sampleRates = {{44100, 4.0}, {48000, 3.0}, {96000, 1.0}};
+        std::vector<std::pair<int, double>> channels = {{1, 1.0}, {2, 1.0}};
+
+        // One-shots are most of a library; loops are the long tail
+        double oneShotMinSeconds = 0.05;
+        double oneShotMaxSeconds = 1.0;
+        double loopFraction = 0.1;
+        double loopMinSeconds = 2.0;
+        double loopMaxSeconds = 8.0;
+
+        // Folders between a pack and its files
+        size_t minDepth = 1;
+        size_t maxDepth = 3;
+
+        double silenceFraction = 0.25;     // Padded with silence at both ends
+        double duplicateFraction = 0.05;   // Byte-identical copy of an earlier file, elsewhere
+        double longNameFraction = 0.02;    // Names near the 255-byte limit
+        double unicodeNameFraction = 0.05; // Accented, Cyrillic, CJK and emoji names
+    };
+
+    struct Result {
+        size_t files = 0;
+        uint64_t bytes = 0;
+        size_t duplicates = 0;
+        size_t substituted = 0;  // Written as WAV because the format was unavailable
+        size_t failed = 0;
+        std::vector<size_t> perFormat;  // Synthesized files per requested Format (not copies), indexed by the enum
+    };
+
+    explicit CorpusGenerator(Config config);
+
+    // Writes the corpus under root (created if missing); false if a file could not be written
+    bool generate(const std::string& root, Result& result) const;
+
+    // Whether this libsndfile can write the format
+    static bool isAvailable(Format format);
+
+    static const char* formatName(Format format);
+    static bool parseFormat(const std::string& name, Format& format);
+    static constexpr size_t FORMAT_COUNT = 8;
+
+private:
+    Config m_config;
+};
@@ -0,0 +1,144 @@
+#include "CorpusGenerator.h"
+#include "Logger.h"
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+namespace {
+// "wav16=3,flac24=1" style weights; keys go through parseKey
+template <typename T, typename ParseKey>
+bool parseWeights(const std::string& text, ParseKey parseKey, std::vector<std::pair<T, double>>& weights) {
+    weights.clear();
+    std::stringstream list(text);
+    std::string entry;
+    while (std::getline(list, entry, ',')) {
+        size_t equals = entry.find('=');
+        T key;
+        if (!parseKey(entry.substr(0, equals), key)) {
+            return false;
+        }
+        try {
+            weights.emplace_back(key, equals == std::string::npos ? 1.0 : std::stod(entry.substr(equals + 1)));
+        } catch (const std::exception&) {
+            return false;
+        }
+    }
+    return !weights.empty();
+}
+
+bool parseInt(const std::string& text, int& value) {
+    try {
+        value = std::stoi(text);
+        return value > 0;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+// "MIN-MAX", or a single value for both
+template <typename T>
+bool parseRange(const std::string& text, T& low, T& high) {
+    try {
+        size_t dash = text.find('-');
+        low = static_cast<T>(std::stod(text.substr(0, dash)));
+        high = dash == std::string::npos ? low : static_cast<T>(std::stod(text.substr(dash + 1)));
+        return low <= high;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <output_directory> [--files N] [--seed N] [--packs N]"
+                  << " [--formats wav16=3,wav24=3,wav32f=1,aiff16=1,aiff24=1,flac16=1,flac24=1,ogg=1]"
+                  << " [--rates 44100=4,48000=3,96000=1] [--channels 1=1,2=1]"
+                  << " [--one-shot SECONDS-SECONDS] [--loops FRACTION] [--loop-length SECONDS-SECONDS]"
+                  << " [--depth MIN-MAX] [--silence FRACTION] [--duplicates FRACTION]"
+                  << " [--long-names FRACTION] [--unicode-names FRACTION] [--clean]" << std::endl;
+        return 1;
+    }
+
+    std::string outputDir = argv[1];
+    CorpusGenerator::Config config;
+    bool clean = false;
+    bool valid = true;
+    for (int i = 2; i < argc && valid; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--files" && hasValue) {
+            config.files = std::stoul(argv[++i]);
+        } else if (arg == "--seed" && hasValue) {
+            config.seed = static_cast<uint32_t>(std::stoul(argv[++i]));
+        } else if (arg == "--packs" && hasValue) {
+            config.packs = std::stoul(argv[++i]);
+        } else if (arg == "--formats" && hasValue) {
+            valid = parseWeights(argv[++i], CorpusGenerator::parseFormat, config.formats);
+        } else if (arg == "--rates" && hasValue) {
+            valid = parseWeights(argv[++i], parseInt, config.sampleRates);
+        } else if (arg == "--channels" && hasValue) {
+            valid = parseWeights(argv[++i], parseInt, config.channels);
+        } else if (arg == "--one-shot" && hasValue) {
+            valid = parseRange(argv[++i], config.oneShotMinSeconds, config.oneShotMaxSeconds);
+        } else if (arg == "--loops" && hasValue) {
+            config.loopFraction = std::stod(argv[++i]);
+        } else if (arg == "--loop-length" && hasValue) {
+            valid = parseRange(argv[++i], config.loopMinSeconds, config.loopMaxSeconds);
+        } else if (arg == "--depth" && hasValue) {
+            valid = parseRange(argv[++i], config.minDepth, config.maxDepth);
+        } else if (arg == "--silence" && hasValue) {
+            config.silenceFraction = std::stod(argv[++i]);
+        } else if (arg == "--duplicates" && hasValue) {
+            config.duplicateFraction = std::stod(argv[++i]);
+        } else if (arg == "--long-names" && hasValue) {
+            config.longNameFraction = std::stod(argv[++i]);
+        } else if (arg == "--unicode-names" && hasValue) {
+            config.unicodeNameFraction = std::stod(argv[++i]);
+        } else if (arg == "--clean") {
+            clean = true;
+        } else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            return 1;
+        }
+        if (!valid) {
+            std::cerr << "Invalid value for " << arg << ": " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    if (clean) {
+        std::error_code ec;
+        std::filesystem::remove_all(outputDir, ec);
+    }
+
+    for (size_t index = 0; index < CorpusGenerator::FORMAT_COUNT; index++) {
+        auto format = static_cast<CorpusGenerator::Format>(index);
+        if (!CorpusGenerator::isAvailable(format)) {
+            Logger::getInstance().warning(std::string("This libsndfile cannot write ") +
+                                          CorpusGenerator::formatName(format) + "; those files are written as WAV");
+        }
+    }
+
+    CorpusGenerator generator(config);
+    CorpusGenerator::Result result;
+    bool success = generator.generate(outputDir, result);
+
+    std::cout << "Generated " << result.files << " files (" << result.bytes / (1024 * 1024) << " MB) in " << outputDir
+              << std::endl;
+    for (size_t index = 0; index < CorpusGenerator::FORMAT_COUNT; index++) {
+        if (result.perFormat[index] > 0) {
+            std::cout << "  " << CorpusGenerator::formatName(static_cast<CorpusGenerator::Format>(index)) << ": "
+                      << result.perFormat[index] << std::endl;
+        }
+    }
+    std::cout << "  duplicates: " << result.duplicates << std::endl;
+    if (result.substituted > 0) {
+        std::cout << "  written as WAV (format unavailable): " << result.substituted << std::endl;
+    }
+    if (result.failed > 0) {
+        std::cout << "  failed: " << result.failed << std::endl;
+    }
+    return success ? 0 : 1;
+}